@@ -9,6 +9,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <optional>
 #include <openrct2-ui/interface/LandTool.h>
 #include <openrct2-ui/interface/Viewport.h>
 #include <openrct2-ui/interface/Widget.h>
@@ -27,6 +28,7 @@
 #include <openrct2/ride/Track.h>
 #include <openrct2/world/Entrance.h>
 #include <openrct2/world/Footpath.h>
+#include <openrct2/world/MapChangeJournal.h>
 #include <openrct2/world/Scenery.h>
 #include <openrct2/world/Sprite.h>
 #include <openrct2/world/Surface.h>
@@ -168,14 +170,51 @@ static uint32_t _currentLine;
 /** rct2: 0x00F1AD68 */
 static std::vector<uint8_t> _mapImageData;
 
+// The map image without the guest or train overlay, used to restore the pixels the overlay leaves behind.
+static std::vector<uint8_t> _mapTileImageData;
+
+// The row of overlay pixels a guest or train drew into the map image, starting at Offset and Width pixels long.
+struct MapOverlayEntity
+{
+    int32_t Offset = -1;
+    uint8_t Width = 0;
+    uint8_t Colour = 0;
+    bool Moved = false;
+    uint32_t Update = 0;
+
+    bool IsDrawn() const
+    {
+        return Offset != -1;
+    }
+
+    bool DrawsSameAs(const MapOverlayEntity& other) const
+    {
+        return Offset == other.Offset && Width == other.Width && Colour == other.Colour;
+    }
+};
+
+// What each entity drew in the last update, by sprite index, and the entities that drew anything in drawing order.
+static std::vector<MapOverlayEntity> _mapOverlayEntities;
+static std::vector<uint16_t> _mapOverlayEntityIds;
+static std::vector<uint16_t> _mapOverlayEntityIdsNext;
+static uint32_t _mapOverlayUpdate;
+
+// The overlay pixels that changed in an update: where moved entities were drawn before and where they are drawn now.
+static std::vector<MapOverlayEntity> _mapOverlayChanged;
+static std::vector<bool> _mapOverlayChangedPixels;
+
+static MapChangeSubscription _mapChanges;
+static std::optional<ScreenRect> _mapHudRectangle;
+
 static uint16_t _landRightsToolSize;
 
 static void window_map_init_map();
 static void window_map_centre_on_view_point();
 static void window_map_show_default_scenario_editor_buttons(rct_window* w);
 static void window_map_draw_tab_images(rct_window* w, rct_drawpixelinfo* dpi);
-static void window_map_paint_peep_overlay(rct_drawpixelinfo* dpi);
-static void window_map_paint_train_overlay(rct_drawpixelinfo* dpi);
+static void map_window_set_peep_overlay_pixels(uint32_t update);
+static void map_window_set_train_overlay_pixels(uint32_t update);
+static std::optional<ScreenRect> map_window_get_hud_rectangle();
 static void window_map_paint_hud_rectangle(rct_drawpixelinfo* dpi);
 static void window_map_inputsize_land(rct_window* w);
 static void window_map_inputsize_map(rct_window* w);
@@ -187,7 +226,9 @@ static void window_map_place_park_entrance_tool_down(const ScreenCoordsXY& scree
 static void window_map_set_peep_spawn_tool_down(const ScreenCoordsXY& screenCoords);
 static void map_window_increase_map_size();
 static void map_window_decrease_map_size();
-static void map_window_set_pixels(rct_window* w);
+static bool map_window_set_pixels(rct_window* w);
+static bool map_window_set_changed_tile_pixels(rct_window* w);
+static void map_window_set_overlay_pixels(rct_window* w, bool tilesChanged);
 
 static CoordsXY map_window_screen_to_map(ScreenCoordsXY screenCoords);
 
@@ -205,12 +246,14 @@ rct_window* window_map_open()
     {
         w->selected_tab = 0;
         w->list_information_type = 0;
+        _mapChanges.Reset();
         return w;
     }
 
     try
     {
         _mapImageData.resize(MAP_WINDOW_MAP_SIZE * MAP_WINDOW_MAP_SIZE);
+        _mapTileImageData.resize(MAP_WINDOW_MAP_SIZE * MAP_WINDOW_MAP_SIZE);
     }
     catch (const std::bad_alloc&)
     {
@@ -266,6 +309,18 @@ static void window_map_close(rct_window* w)
 {
     _mapImageData.clear();
     _mapImageData.shrink_to_fit();
+    _mapTileImageData.clear();
+    _mapTileImageData.shrink_to_fit();
+    _mapOverlayEntities.clear();
+    _mapOverlayEntities.shrink_to_fit();
+    _mapOverlayEntityIds.clear();
+    _mapOverlayEntityIds.shrink_to_fit();
+    _mapOverlayEntityIdsNext.clear();
+    _mapOverlayEntityIdsNext.shrink_to_fit();
+    _mapOverlayChanged.clear();
+    _mapOverlayChanged.shrink_to_fit();
+    _mapOverlayChangedPixels.clear();
+    _mapOverlayChangedPixels.shrink_to_fit();
     if ((input_test_flag(INPUT_FLAG_TOOL_ACTIVE)) && gCurrentToolWidget.window_classification == w->classification
         && gCurrentToolWidget.window_number == w->number)
     {
@@ -368,6 +423,7 @@ static void window_map_mouseup(rct_window* w, rct_widgetindex widgetIndex)
 
                 w->selected_tab = widgetIndex;
                 w->list_information_type = 0;
+                _mapChanges.Reset();
             }
     }
 }
@@ -427,10 +483,25 @@ static void window_map_update(rct_window* w)
         window_map_centre_on_view_point();
     }
 
-    for (int32_t i = 0; i < 16; i++)
-        map_window_set_pixels(w);
-
-    w->Invalidate();
+    // Only the tiles that changed since the last update are redrawn, and only the guests or trains that moved. The
+    // overlay invalidates the pixels it changed itself, unless the tiles changed and the whole window is invalidated.
+    bool imageChanged = map_window_set_changed_tile_pixels(w);
+    imageChanged |= map_window_set_pixels(w);
+    map_window_set_overlay_pixels(w, imageChanged);
+
+    auto hudRectangle = map_window_get_hud_rectangle();
+    bool hudRectangleMoved = hudRectangle.has_value() != _mapHudRectangle.has_value()
+        || (hudRectangle.has_value()
+            && (hudRectangle->Point1 != _mapHudRectangle->Point1 || hudRectangle->Point2 != _mapHudRectangle->Point2));
+    if (imageChanged || hudRectangleMoved)
+    {
+        _mapHudRectangle = hudRectangle;
+        w->Invalidate();
+    }
+    else
+    {
+        widget_invalidate(w, WIDX_PEOPLE_TAB + w->selected_tab);
+    }
 
     // Update tab animations
     w->list_information_type++;
@@ -869,14 +940,6 @@ static void window_map_scrollpaint(rct_window* w, rct_drawpixelinfo* dpi, int32_
     drawing_engine_invalidate_image(SPR_TEMP);
     gfx_draw_sprite(dpi, SPR_TEMP, { 0, 0 }, 0);
 
-    if (w->selected_tab == PAGE_PEEPS)
-    {
-        window_map_paint_peep_overlay(dpi);
-    }
-    else
-    {
-        window_map_paint_train_overlay(dpi);
-    }
     window_map_paint_hud_rectangle(dpi);
 }
 
@@ -887,6 +950,10 @@ static void window_map_scrollpaint(rct_window* w, rct_drawpixelinfo* dpi, int32_
 static void window_map_init_map()
 {
     std::fill(_mapImageData.begin(), _mapImageData.end(), PALETTE_INDEX_10);
+    std::fill(_mapTileImageData.begin(), _mapTileImageData.end(), PALETTE_INDEX_10);
+    _mapOverlayEntities.clear();
+    _mapOverlayEntityIds.clear();
+    _mapChanges.Reset();
     _currentLine = 0;
 }
 
@@ -1001,7 +1068,7 @@ static void window_map_draw_tab_images(rct_window* w, rct_drawpixelinfo* dpi)
 
 /**
  *
- * part of window_map_paint_peep_overlay and window_map_paint_train_overlay
+ * part of map_window_set_peep_overlay_pixels and map_window_set_train_overlay_pixels
  */
 static MapCoordsXY window_map_transform_to_map_coords(CoordsXY c)
 {
@@ -1030,11 +1097,49 @@ static MapCoordsXY window_map_transform_to_map_coords(CoordsXY c)
     return { -x + y + MAXIMUM_MAP_SIZE_TECHNICAL - 8, x + y - 8 };
 }
 
+/**
+ * Sets the overlay pixels the given entity draws in this update, width pixels from the given position in the scroll
+ * view, and remembers what it drew before if that changed.
+ */
+static void map_window_set_overlay_entity(
+    uint16_t spriteIndex, uint32_t update, const ScreenCoordsXY& screenCoords, int32_t width, uint8_t colour)
+{
+    // The map image is drawn 8 pixels up and to the left, see window_map_scrollpaint
+    auto position = screenCoords + ScreenCoordsXY{ 8, 8 };
+    auto left = std::max(position.x, 0);
+    auto right = std::min(position.x + width, MAP_WINDOW_MAP_SIZE);
+
+    MapOverlayEntity next;
+    next.Update = update;
+    if (position.y >= 0 && position.y < MAP_WINDOW_MAP_SIZE && left < right)
+    {
+        next.Offset = position.y * MAP_WINDOW_MAP_SIZE + left;
+        next.Width = static_cast<uint8_t>(right - left);
+        next.Colour = colour;
+    }
+
+    if (spriteIndex >= _mapOverlayEntities.size())
+    {
+        _mapOverlayEntities.resize(spriteIndex + 1);
+    }
+    auto& entity = _mapOverlayEntities[spriteIndex];
+    next.Moved = !next.DrawsSameAs(entity);
+    if (next.Moved && entity.IsDrawn())
+    {
+        _mapOverlayChanged.push_back(entity);
+    }
+    entity = next;
+    if (entity.IsDrawn())
+    {
+        _mapOverlayEntityIdsNext.push_back(spriteIndex);
+    }
+}
+
 /**
  *
  *  rct2: 0x0068DADA
  */
-static void window_map_paint_peep_overlay(rct_drawpixelinfo* dpi)
+static void map_window_set_peep_overlay_pixels(uint32_t update)
 {
     for (auto peep : EntityList<Peep>(EntityListId::Peep))
     {
@@ -1045,7 +1150,7 @@ static void window_map_paint_peep_overlay(rct_drawpixelinfo* dpi)
         auto leftTop = ScreenCoordsXY{ c.x, c.y };
         auto rightBottom = leftTop;
 
-        int16_t colour = PALETTE_INDEX_20;
+        uint8_t colour = PALETTE_INDEX_20;
 
         if (sprite_get_flashing(peep))
         {
@@ -1070,7 +1175,7 @@ static void window_map_paint_peep_overlay(rct_drawpixelinfo* dpi)
                 }
             }
         }
-        gfx_fill_rect(dpi, { leftTop, rightBottom }, colour);
+        map_window_set_overlay_entity(peep->sprite_index, update, leftTop, rightBottom.x - leftTop.x + 1, colour);
     }
 }
 
@@ -1078,7 +1183,7 @@ static void window_map_paint_peep_overlay(rct_drawpixelinfo* dpi)
  *
  *  rct2: 0x0068DBC1
  */
-static void window_map_paint_train_overlay(rct_drawpixelinfo* dpi)
+static void map_window_set_train_overlay_pixels(uint32_t update)
 {
     for (auto train : EntityList<Vehicle>(EntityListId::TrainHead))
     {
@@ -1089,31 +1194,156 @@ static void window_map_paint_train_overlay(rct_drawpixelinfo* dpi)
 
             MapCoordsXY c = window_map_transform_to_map_coords({ vehicle->x, vehicle->y });
 
-            gfx_fill_rect(dpi, { { c.x, c.y }, { c.x, c.y } }, PALETTE_INDEX_171);
+            map_window_set_overlay_entity(vehicle->sprite_index, update, { c.x, c.y }, 1, PALETTE_INDEX_171);
         }
     }
 }
 
 /**
- * The call to gfx_fill_rect was originally wrapped in sub_68DABD which made sure that arguments were ordered correctly,
- * but it doesn't look like it's ever necessary here so the call was removed.
- *
- *  rct2: 0x0068D8CE
+ * Invalidates the part of the map widget that shows the given overlay pixels.
  */
-static void window_map_paint_hud_rectangle(rct_drawpixelinfo* dpi)
+static void map_window_invalidate_overlay_entity(rct_window* w, const MapOverlayEntity& entity)
+{
+    const auto& widget = w->widgets[WIDX_MAP];
+    const auto& scroll = w->scrolls[0];
+
+    // The map image is drawn 8 pixels up and to the left, see window_map_scrollpaint
+    auto position = ScreenCoordsXY{ entity.Offset % MAP_WINDOW_MAP_SIZE - 8, entity.Offset / MAP_WINDOW_MAP_SIZE - 8 };
+    auto leftTop = w->windowPos + ScreenCoordsXY{ widget.left + 1, widget.top + 1 } + position
+        - ScreenCoordsXY{ scroll.h_left, scroll.v_top };
+    auto rightBottom = leftTop + ScreenCoordsXY{ entity.Width, 1 };
+
+    leftTop.x = std::max(leftTop.x, w->windowPos.x + widget.left + 1);
+    leftTop.y = std::max(leftTop.y, w->windowPos.y + widget.top + 1);
+    rightBottom.x = std::min(rightBottom.x, w->windowPos.x + widget.right);
+    rightBottom.y = std::min(rightBottom.y, w->windowPos.y + widget.bottom);
+    if (leftTop.x >= rightBottom.x || leftTop.y >= rightBottom.y)
+        return;
+
+    gfx_set_dirty_blocks({ leftTop, rightBottom });
+}
+
+/**
+ * Redraws the overlay pixels of the guests or trains that moved since the last update and invalidates just those. If
+ * the tiles changed, the tile pixels were drawn over the overlay, so all of it is drawn again and the caller
+ * invalidates the window.
+ */
+static void map_window_set_overlay_pixels(rct_window* w, bool tilesChanged)
+{
+    auto update = ++_mapOverlayUpdate;
+    _mapOverlayEntityIdsNext.clear();
+    _mapOverlayChanged.clear();
+    if (w->selected_tab == PAGE_PEEPS)
+    {
+        map_window_set_peep_overlay_pixels(update);
+    }
+    else
+    {
+        map_window_set_train_overlay_pixels(update);
+    }
+
+    // Entities that were drawn in the last update but are gone or off the map now
+    for (auto spriteIndex : _mapOverlayEntityIds)
+    {
+        auto& entity = _mapOverlayEntities[spriteIndex];
+        if (entity.Update != update && entity.IsDrawn())
+        {
+            _mapOverlayChanged.push_back(entity);
+            entity = {};
+        }
+    }
+    std::swap(_mapOverlayEntityIds, _mapOverlayEntityIdsNext);
+
+    // Pixels that changed are drawn again by every entity on them, in drawing order, so overlapping entities show the
+    // colour of the last one as if the whole overlay was redrawn.
+    _mapOverlayChangedPixels.resize(_mapImageData.size());
+    for (const auto& entity : _mapOverlayChanged)
+    {
+        for (auto offset = entity.Offset; offset < entity.Offset + entity.Width; offset++)
+        {
+            _mapImageData[offset] = _mapTileImageData[offset];
+            _mapOverlayChangedPixels[offset] = true;
+        }
+        if (!tilesChanged)
+        {
+            map_window_invalidate_overlay_entity(w, entity);
+        }
+    }
+    for (auto spriteIndex : _mapOverlayEntityIds)
+    {
+        const auto& entity = _mapOverlayEntities[spriteIndex];
+        if (!entity.Moved)
+            continue;
+
+        for (auto offset = entity.Offset; offset < entity.Offset + entity.Width; offset++)
+        {
+            _mapOverlayChangedPixels[offset] = true;
+        }
+        if (!tilesChanged)
+        {
+            map_window_invalidate_overlay_entity(w, entity);
+        }
+        _mapOverlayChanged.push_back(entity);
+    }
+    if (_mapOverlayChanged.empty() && !tilesChanged)
+        return;
+
+    for (auto spriteIndex : _mapOverlayEntityIds)
+    {
+        const auto& entity = _mapOverlayEntities[spriteIndex];
+        bool draw = tilesChanged;
+        for (auto offset = entity.Offset; !draw && offset < entity.Offset + entity.Width; offset++)
+        {
+            draw = _mapOverlayChangedPixels[offset];
+        }
+        if (!draw)
+            continue;
+
+        for (auto offset = entity.Offset; offset < entity.Offset + entity.Width; offset++)
+        {
+            _mapImageData[offset] = entity.Colour;
+        }
+    }
+    for (const auto& entity : _mapOverlayChanged)
+    {
+        for (auto offset = entity.Offset; offset < entity.Offset + entity.Width; offset++)
+        {
+            _mapOverlayChangedPixels[offset] = false;
+        }
+    }
+}
+
+static std::optional<ScreenRect> map_window_get_hud_rectangle()
 {
     rct_window* main_window = window_get_main();
     if (main_window == nullptr)
-        return;
+        return std::nullopt;
 
     rct_viewport* viewport = main_window->viewport;
     if (viewport == nullptr)
-        return;
+        return std::nullopt;
 
     auto offset = MiniMapOffsets[get_current_rotation()];
     auto leftTop = ScreenCoordsXY{ (viewport->viewPos.x >> 5) + offset.x, (viewport->viewPos.y >> 4) + offset.y };
     auto rightBottom = ScreenCoordsXY{ ((viewport->viewPos.x + viewport->view_width) >> 5) + offset.x,
                                        ((viewport->viewPos.y + viewport->view_height) >> 4) + offset.y };
+    return ScreenRect{ leftTop, rightBottom };
+}
+
+/**
+ * The call to gfx_fill_rect was originally wrapped in sub_68DABD which made sure that arguments were ordered correctly,
+ * but it doesn't look like it's ever necessary here so the call was removed.
+ *
+ *  rct2: 0x0068D8CE
+ */
+static void window_map_paint_hud_rectangle(rct_drawpixelinfo* dpi)
+{
+    auto hudRectangle = map_window_get_hud_rectangle();
+    if (!hudRectangle.has_value())
+        return;
+
+    auto leftTop = hudRectangle->Point1;
+    auto rightBottom = hudRectangle->Point2;
     auto rightTop = ScreenCoordsXY{ rightBottom.x, leftTop.y };
     auto leftBottom = ScreenCoordsXY{ leftTop.x, rightBottom.y };
 
@@ -1501,68 +1731,99 @@ static uint16_t map_window_get_pixel_colour_ride(const CoordsXY& c)
     return colourB;
 }
 
-static void map_window_set_pixels(rct_window* w)
+/**
+ * Returns the left one of the two pixels that show the tile at loc in the current rotation.
+ */
+static ScreenCoordsXY map_window_get_tile_pixel_position(const TileCoordsXY& loc)
 {
-    uint16_t colour = 0;
-    int32_t x = 0, y = 0, dx = 0, dy = 0;
-
-    int32_t pos = (_currentLine * (MAP_WINDOW_MAP_SIZE - 1)) + MAXIMUM_MAP_SIZE_TECHNICAL - 1;
-    auto destinationPosition = ScreenCoordsXY{ pos % MAP_WINDOW_MAP_SIZE, pos / MAP_WINDOW_MAP_SIZE };
-    auto destination = _mapImageData.data() + (destinationPosition.y * MAP_WINDOW_MAP_SIZE) + destinationPosition.x;
+    int32_t line = 0, column = 0;
     switch (get_current_rotation())
     {
         case 0:
-            x = _currentLine * COORDS_XY_STEP;
-            y = 0;
-            dx = 0;
-            dy = COORDS_XY_STEP;
+            line = loc.x;
+            column = loc.y;
             break;
         case 1:
-            x = MAXIMUM_TILE_START_XY;
-            y = _currentLine * COORDS_XY_STEP;
-            dx = -COORDS_XY_STEP;
-            dy = 0;
+            line = loc.y;
+            column = MAXIMUM_MAP_SIZE_TECHNICAL - 1 - loc.x;
             break;
         case 2:
-            x = MAXIMUM_MAP_SIZE_BIG - ((_currentLine + 1) * COORDS_XY_STEP);
-            y = MAXIMUM_TILE_START_XY;
-            dx = 0;
-            dy = -COORDS_XY_STEP;
+            line = MAXIMUM_MAP_SIZE_TECHNICAL - 1 - loc.x;
+            column = MAXIMUM_MAP_SIZE_TECHNICAL - 1 - loc.y;
             break;
         case 3:
-            x = 0;
-            y = MAXIMUM_MAP_SIZE_BIG - ((_currentLine + 1) * COORDS_XY_STEP);
-            dx = COORDS_XY_STEP;
-            dy = 0;
+            line = MAXIMUM_MAP_SIZE_TECHNICAL - 1 - loc.y;
+            column = loc.x;
             break;
     }
+    return { MAXIMUM_MAP_SIZE_TECHNICAL - 1 - line + column, line + column };
+}
 
-    for (int32_t i = 0; i < MAXIMUM_MAP_SIZE_TECHNICAL; i++)
+/**
+ * Redraws the two pixels of the tile at loc, returns whether they changed.
+ */
+static bool map_window_set_tile_pixels(rct_window* w, const TileCoordsXY& loc)
+{
+    auto mapCoords = loc.ToCoordsXY();
+    if (mapCoords.x <= 0 || mapCoords.y <= 0 || mapCoords.x >= gMapSizeUnits || mapCoords.y >= gMapSizeUnits)
+        return false;
+
+    uint16_t colour = 0;
+    switch (w->selected_tab)
     {
-        if (x > 0 && y > 0 && x < gMapSizeUnits && y < gMapSizeUnits)
+        case PAGE_PEEPS:
+            colour = map_window_get_pixel_colour_peep(mapCoords);
+            break;
+        case PAGE_RIDES:
+            colour = map_window_get_pixel_colour_ride(mapCoords);
+            break;
+    }
+    uint8_t leftColour = (colour >> 8) & 0xFF;
+    uint8_t rightColour = colour & 0xFF;
+
+    auto position = map_window_get_tile_pixel_position(loc);
+    auto offset = (position.y * MAP_WINDOW_MAP_SIZE) + position.x;
+    if (_mapTileImageData[offset] == leftColour && _mapTileImageData[offset + 1] == rightColour)
+        return false;
+
+    _mapTileImageData[offset] = _mapImageData[offset] = leftColour;
+    _mapTileImageData[offset + 1] = _mapImageData[offset + 1] = rightColour;
+    return true;
+}
+
+/**
+ * Redraws the tiles in the chunks that changed since the last call, returns whether any pixel changed.
+ */
+static bool map_window_set_changed_tile_pixels(rct_window* w)
+{
+    bool changed = false;
+    _mapChanges.ForEachChangedChunk([w, &changed](const TileCoordsXY& chunk) {
+        for (int32_t y = chunk.y; y < chunk.y + MAP_CHUNK_SIZE; y++)
         {
-            switch (w->selected_tab)
+            for (int32_t x = chunk.x; x < chunk.x + MAP_CHUNK_SIZE; x++)
             {
-                case PAGE_PEEPS:
-                    colour = map_window_get_pixel_colour_peep({ x, y });
-                    break;
-                case PAGE_RIDES:
-                    colour = map_window_get_pixel_colour_ride({ x, y });
-                    break;
+                changed |= map_window_set_tile_pixels(w, { x, y });
             }
-            destination[0] = (colour >> 8) & 0xFF;
-            destination[1] = colour;
         }
-        x += dx;
-        y += dy;
+    });
+    return changed;
+}
 
-        destinationPosition.x++;
-        destinationPosition.y++;
-        destination = _mapImageData.data() + (destinationPosition.y * MAP_WINDOW_MAP_SIZE) + destinationPosition.x;
+/**
+ * Redraws the next row of tiles, returns whether any pixel changed. Sweeping over the map this way still picks up
+ * the few changes that are not recorded in the map change journal.
+ */
+static bool map_window_set_pixels(rct_window* w)
+{
+    bool changed = false;
+    for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
+    {
+        changed |= map_window_set_tile_pixels(w, { x, static_cast<int32_t>(_currentLine) });
     }
     _currentLine++;
     if (_currentLine >= MAXIMUM_MAP_SIZE_TECHNICAL)
         _currentLine = 0;
+    return changed;
 }
 
 static CoordsXY map_window_screen_to_map(ScreenCoordsXY screenCoords)
@@ -371,7 +371,7 @@ static void window_network_information_paint(rct_window* w, rct_drawpixelinfo* d
     constexpr int32_t textHeight = 12;
     const int32_t graphBarWidth = std::min(1, w->width / WH);
     const int32_t totalHeight = w->height;
-    const int32_t totalHeightText = (textHeight + (padding * 2)) * 3;
+    const int32_t totalHeightText = (textHeight + (padding * 2)) * 4;
     const int32_t graphHeight = (totalHeight - totalHeightText - heightTab) / 2;
 
     rct_drawpixelinfo clippedDPI;
@@ -421,6 +421,20 @@ static void window_network_information_paint(rct_window* w, rct_drawpixelinfo* d
             screenCoords.y += graphHeight + padding;
         }
 
+        // Compression stats.
+        {
+            gfx_draw_string_left(dpi, STR_NETWORK_COMPRESSION_SAVED, nullptr, PALETTE_INDEX_10, screenCoords);
+
+            gfx_draw_string_left(dpi, STR_NETWORK_RECEIVE, nullptr, PALETTE_INDEX_10, screenCoords + ScreenCoordsXY{ 150, 0 });
+            format_readable_size(textBuffer, sizeof(textBuffer), _networkStats.bytesSavedReceived);
+            gfx_draw_string(dpi, textBuffer, PALETTE_INDEX_10, screenCoords + ScreenCoordsXY(200, 0));
+
+            gfx_draw_string_left(dpi, STR_NETWORK_SEND, nullptr, PALETTE_INDEX_10, screenCoords + ScreenCoordsXY{ 300, 0 });
+            format_readable_size(textBuffer, sizeof(textBuffer), _networkStats.bytesSavedSent);
+            gfx_draw_string(dpi, textBuffer, PALETTE_INDEX_10, screenCoords + ScreenCoordsXY(350, 0));
+            screenCoords.y += textHeight + padding;
+        }
+
         // Draw legend
         {
             for (size_t i = 1; i < EnumValue(NetworkStatisticsGroup::Max); i++)
@@ -309,13 +309,9 @@ namespace Editor
         ride_init_all();
 
         //
-        for (int32_t i = 0; i < MAX_SPRITES; i++)
+        for (auto peep : EntityList<Peep>(EntityListId::Peep))
         {
-            auto peep = GetEntity<Peep>(i);
-            if (peep != nullptr)
-            {
-                peep->SetName({});
-            }
+            peep->SetName({});
         }
 
         reset_sprite_list();
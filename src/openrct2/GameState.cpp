@@ -32,11 +32,13 @@
 #include "ui/UiContext.h"
 #include "windows/Intent.h"
 #include "world/Climate.h"
+#include "world/Map.h"
 #include "world/MapAnimation.h"
 #include "world/Park.h"
 #include "world/Scenery.h"
 
 #include <algorithm>
+#include <chrono>
 
 using namespace OpenRCT2;
 using namespace OpenRCT2::Scripting;
@@ -53,6 +55,7 @@ void GameState::InitAll(int32_t mapSize)
 {
     gInMapInitCode = true;
 
+    MapSetTileElementLimit(gConfigGeneral.max_tile_elements);
     map_init(mapSize);
     _park->Initialise();
     finance_init();
@@ -225,12 +228,30 @@ void GameState::Update()
     gInUpdateCode = false;
 }
 
-void GameState::UpdateLogic()
+void GameState::UpdateLogic(LogicTimings* timings)
 {
+    // The clock is only read when timings are requested, so a normal tick does not pay for it.
+    std::chrono::high_resolution_clock::time_point startTime;
+    if (timings != nullptr)
+    {
+        startTime = std::chrono::high_resolution_clock::now();
+    }
+    auto reportTime = [timings, &startTime](LogicTimePart part) {
+        if (timings != nullptr)
+        {
+            auto endTime = std::chrono::high_resolution_clock::now();
+            (*timings)[static_cast<size_t>(part)] += std::chrono::duration<double>(endTime - startTime).count();
+            startTime = endTime;
+        }
+    };
+
     gScreenAge++;
     if (gScreenAge == 0)
         gScreenAge--;
 
+    // Summaries that were made while the map was drawn or edited are not carried into the tick.
+    MapInvalidateTileElementSummaries();
+
     GetContext()->GetReplayManager()->Update();
 
     network_update();
@@ -268,6 +289,7 @@ void GameState::UpdateLogic()
             }
         }
     }
+    reportTime(LogicTimePart::NetworkUpdate);
 
 #ifdef ENABLE_SCRIPTING
     // Stash the current day number before updating the date so that we
@@ -277,33 +299,51 @@ void GameState::UpdateLogic()
 
     date_update();
     _date = Date(static_cast<uint32_t>(gDateMonthsElapsed), gDateMonthTicks);
+    reportTime(LogicTimePart::Date);
 
     scenario_update();
+    reportTime(LogicTimePart::Scenario);
     climate_update();
+    reportTime(LogicTimePart::Climate);
     map_update_tiles();
+    reportTime(LogicTimePart::MapTiles);
     // Temporarily remove provisional paths to prevent peep from interacting with them
     map_remove_provisional_elements();
+    reportTime(LogicTimePart::MapStashProvisionalElements);
     map_update_path_wide_flags();
+    reportTime(LogicTimePart::MapPathWideFlags);
     peep_update_all();
+    reportTime(LogicTimePart::Peep);
     map_restore_provisional_elements();
+    reportTime(LogicTimePart::MapRestoreProvisionalElements);
     vehicle_update_all();
+    reportTime(LogicTimePart::Vehicle);
     sprite_misc_update_all();
+    reportTime(LogicTimePart::Misc);
     Ride::UpdateAll();
+    reportTime(LogicTimePart::Ride);
 
     if (!(gScreenFlags & SCREEN_FLAGS_EDITOR))
     {
         _park->Update(_date);
     }
+    reportTime(LogicTimePart::Park);
 
     research_update();
+    reportTime(LogicTimePart::Research);
     ride_ratings_update_all();
+    reportTime(LogicTimePart::RideRatings);
     ride_measurements_update();
+    reportTime(LogicTimePart::RideMeasurements);
     News::UpdateCurrentItem();
+    reportTime(LogicTimePart::News);
 
     map_animation_invalidate_all();
+    reportTime(LogicTimePart::MapAnimation);
     vehicle_sounds_update();
     peep_update_crowd_noise();
     climate_update_sound();
+    reportTime(LogicTimePart::Sounds);
     editor_open_windows_for_current_step();
 
     // Update windows
@@ -316,9 +356,12 @@ void GameState::UpdateLogic()
     }
 
     GameActions::ProcessQueue();
+    reportTime(LogicTimePart::GameActions);
 
     network_process_pending();
+    reportTime(LogicTimePart::NetworkProcess);
     network_flush();
+    reportTime(LogicTimePart::NetworkFlush);
 
     gCurrentTicks++;
     gScenarioTicks++;
@@ -333,6 +376,7 @@ void GameState::UpdateLogic()
         hookEngine.Call(HOOK_TYPE::INTERVAL_DAY, true);
     }
 #endif
+    reportTime(LogicTimePart::Scripts);
 }
 
 void GameState::CreateStateSnapshot()
@@ -11,12 +11,45 @@
 
 #include "Date.h"
 
+#include <array>
 #include <memory>
 
 namespace OpenRCT2
 {
     class Park;
 
+    // The parts of GameState::UpdateLogic that are timed separately.
+    enum class LogicTimePart
+    {
+        NetworkUpdate,
+        Date,
+        Scenario,
+        Climate,
+        MapTiles,
+        MapStashProvisionalElements,
+        MapPathWideFlags,
+        Peep,
+        MapRestoreProvisionalElements,
+        Vehicle,
+        Misc,
+        Ride,
+        Park,
+        Research,
+        RideRatings,
+        RideMeasurements,
+        News,
+        MapAnimation,
+        Sounds,
+        GameActions,
+        NetworkProcess,
+        NetworkFlush,
+        Scripts,
+        Count
+    };
+
+    // Wall time in seconds spent in each part, added up over all the ticks it was passed to.
+    using LogicTimings = std::array<double, static_cast<size_t>(LogicTimePart::Count)>;
+
     /**
      * Class to update the state of the map and park.
      */
@@ -41,7 +74,7 @@ namespace OpenRCT2
 
         void InitAll(int32_t mapSize);
         void Update();
-        void UpdateLogic();
+        void UpdateLogic(LogicTimings* timings = nullptr);
 
     private:
         void CreateStateSnapshot();
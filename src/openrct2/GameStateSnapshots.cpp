@@ -141,7 +141,7 @@ struct GameStateSnapshots final : public IGameStateSnapshots
     virtual void Capture(GameStateSnapshot_t& snapshot) override final
     {
         snapshot.SerialiseSprites(
-            [](const size_t index) { return reinterpret_cast<rct_sprite*>(GetEntity(index)); }, MAX_SPRITES, true);
+            [](const size_t index) { return reinterpret_cast<rct_sprite*>(GetEntity(index)); }, GetEntityPoolSize(), true);
 
         // log_info("Snapshot size: %u bytes", static_cast<uint32_t>(snapshot.storedSprites.GetLength()));
     }
@@ -167,7 +167,7 @@ struct GameStateSnapshots final : public IGameStateSnapshots
     std::vector<rct_sprite> BuildSpriteList(GameStateSnapshot_t& snapshot) const
     {
         std::vector<rct_sprite> spriteList;
-        spriteList.resize(MAX_SPRITES);
+        spriteList.resize(GetEntityPoolSize());
 
         for (auto& sprite : spriteList)
         {
@@ -175,7 +175,9 @@ struct GameStateSnapshots final : public IGameStateSnapshots
             sprite.generic.sprite_identifier = SPRITE_IDENTIFIER_NULL;
         }
 
-        snapshot.SerialiseSprites([&spriteList](const size_t index) { return &spriteList[index]; }, MAX_SPRITES, false);
+        snapshot.SerialiseSprites(
+            [&spriteList](const size_t index) { return index < spriteList.size() ? &spriteList[index] : nullptr; },
+            spriteList.size(), false);
 
         return spriteList;
     }
@@ -96,7 +96,9 @@ namespace OpenRCT2
 
     class ReplayManager final : public IReplayManager
     {
-        static constexpr uint16_t ReplayVersion = 4;
+        static constexpr uint16_t ReplayVersion = 5;
+        // Replays before this version were recorded with the legacy sprite checksum.
+        static constexpr uint16_t ReplayEntityChecksumVersion = 5;
         static constexpr uint32_t ReplayMagic = 0x5243524F; // ORCR.
         static constexpr int ReplayCompressionLevel = 9;
         static constexpr int NormalRecordingChecksumTicks = 1;
@@ -708,7 +710,8 @@ namespace OpenRCT2
 
         bool Compatible(ReplayRecordData& data)
         {
-            return data.version == ReplayVersion;
+            // The version before only differs in the checksum, which is verified with the legacy checksum.
+            return data.version == ReplayVersion || data.version == ReplayEntityChecksumVersion - 1;
         }
 
         bool Serialise(DataSerialiser& serialiser, ReplayRecordData& data)
@@ -795,7 +798,9 @@ namespace OpenRCT2
             const auto& savedChecksum = _currentReplay->checksums[checksumIndex];
             if (_currentReplay->checksums[checksumIndex].first == gCurrentTicks)
             {
-                rct_sprite_checksum checksum = sprite_checksum();
+                rct_sprite_checksum checksum = _currentReplay->version < ReplayEntityChecksumVersion
+                    ? sprite_checksum_legacy()
+                    : sprite_checksum();
                 if (savedChecksum.second.raw != checksum.raw)
                 {
                     uint32_t replayTick = gCurrentTicks - _currentReplay->tickStart;
@@ -126,7 +126,7 @@ public:
 
         tile_element_remove_banner_entry(reinterpret_cast<TileElement*>(bannerElement));
         map_invalidate_tile_zoom1({ _loc, _loc.z, _loc.z + 32 });
-        bannerElement->Remove();
+        bannerElement->Remove(_loc);
 
         return res;
     }
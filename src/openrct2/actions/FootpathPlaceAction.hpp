@@ -15,6 +15,7 @@
 #include "../interface/Window.h"
 #include "../localisation/StringIds.h"
 #include "../management/Finance.h"
+#include "../peep/FootpathGraph.h"
 #include "../world/Footpath.h"
 #include "../world/Location.hpp"
 #include "../world/Park.h"
@@ -120,6 +121,9 @@ public:
         res->Expenditure = ExpenditureType::Landscaping;
         res->Position = _loc.ToTileCentre();
 
+        // The path and the edges of its neighbours are about to change.
+        FootpathGraphInvalidateTile(_loc);
+
         if (!(GetFlags() & GAME_COMMAND_FLAG_GHOST))
         {
             footpath_interrupt_peeps(_loc);
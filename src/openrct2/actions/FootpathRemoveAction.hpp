@@ -15,6 +15,7 @@
 #include "../interface/Window.h"
 #include "../localisation/StringIds.h"
 #include "../management/Finance.h"
+#include "../peep/FootpathGraph.h"
 #include "../world/Footpath.h"
 #include "../world/Location.hpp"
 #include "../world/Park.h"
@@ -86,6 +87,9 @@ public:
         res->Expenditure = ExpenditureType::Landscaping;
         res->Position = { _loc.x + 16, _loc.y + 16, _loc.z };
 
+        // The path and the edges of its neighbours are about to change.
+        FootpathGraphInvalidateTile(_loc);
+
         if (!(GetFlags() & GAME_COMMAND_FLAG_GHOST))
         {
             footpath_interrupt_peeps(_loc);
@@ -103,7 +107,7 @@ public:
             }
             footpath_remove_edges_at(_loc, footpathElement);
             map_invalidate_tile_full(_loc);
-            tile_element_remove(footpathElement);
+            tile_element_remove(_loc, footpathElement);
             footpath_update_queue_chains();
 
             // Remove the spawn point (if there is one in the current tile)
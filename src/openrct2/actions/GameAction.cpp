@@ -16,6 +16,8 @@
 #include "../core/MemoryStream.h"
 #include "../localisation/Localisation.h"
 #include "../network/network.h"
+#include "../peep/FootpathGraph.h"
+#include "../peep/GuestPathfinding.h"
 #include "../platform/platform.h"
 #include "../scenario/Scenario.h"
 #include "../scripting/Duktape.hpp"
@@ -23,6 +25,8 @@
 #include "../scripting/ScriptEngine.h"
 #include "../ui/UiContext.h"
 #include "../ui/WindowManager.h"
+#include "../world/Map.h"
+#include "../world/MapChangeJournal.h"
 #include "../world/Park.h"
 #include "../world/Scenery.h"
 
@@ -113,6 +117,46 @@ namespace GameActions
     static uint32_t _nextUniqueId = 0;
     static bool _suspended = false;
 
+    /**
+     * Whether the action can change anything the guest pathfinding looks at: paths, banners, track, entrances or the
+     * land under them. Besides placing their own elements, track and entrances change the edges of the paths next to
+     * them. Ghost elements are ignored by the pathfinding.
+     */
+    static bool ChangesWalkableElements(const GameAction& action)
+    {
+        if (action.GetFlags() & GAME_COMMAND_FLAG_GHOST)
+            return false;
+
+        switch (action.GetType())
+        {
+            case GAME_COMMAND_PLACE_PATH:
+            case GAME_COMMAND_PLACE_PATH_FROM_TRACK:
+            case GAME_COMMAND_REMOVE_PATH:
+            case GAME_COMMAND_PLACE_TRACK:
+            case GAME_COMMAND_REMOVE_TRACK:
+            case GAME_COMMAND_SET_MAZE_TRACK:
+            case GAME_COMMAND_PLACE_TRACK_DESIGN:
+            case GAME_COMMAND_PLACE_MAZE_DESIGN:
+            case GAME_COMMAND_DEMOLISH_RIDE:
+            case GAME_COMMAND_PLACE_RIDE_ENTRANCE_OR_EXIT:
+            case GAME_COMMAND_REMOVE_RIDE_ENTRANCE_OR_EXIT:
+            case GAME_COMMAND_PLACE_PARK_ENTRANCE:
+            case GAME_COMMAND_REMOVE_PARK_ENTRANCE:
+            case GAME_COMMAND_PLACE_BANNER:
+            case GAME_COMMAND_REMOVE_BANNER:
+            case GAME_COMMAND_SET_BANNER_STYLE:
+            case GAME_COMMAND_SET_LAND_HEIGHT:
+            case GAME_COMMAND_RAISE_LAND:
+            case GAME_COMMAND_LOWER_LAND:
+            case GAME_COMMAND_EDIT_LAND_SMOOTH:
+            case GAME_COMMAND_CLEAR_SCENERY:
+            case GAME_COMMAND_MODIFY_TILE:
+                return true;
+            default:
+                return false;
+        }
+    }
+
     GameActionFactory Register(uint32_t id, GameActionFactory factory)
     {
         Guard::Assert(id < std::size(_actions));
@@ -445,8 +489,29 @@ namespace GameActions
             ActionLogContext_t logContext;
             LogActionBegin(logContext, action);
 
-            // Execute the action, changing the game state
+            // Execute the action, changing the game state. Elements are modified in place, so tile summaries can not be
+            // trusted until it has finished.
+            MapSuspendTileElementSummaries();
             result = action->Execute();
+            MapResumeTileElementSummaries();
+            if (result->Error == GA_ERROR::OK)
+            {
+                // Most actions also invalidate the tiles they change, which marks them in the journal.
+                if (!result->Position.isNull())
+                {
+                    MapChangeJournalMarkTile(result->Position);
+                }
+                // Guests may now find a different way through the park.
+                if (ChangesWalkableElements(*action))
+                {
+                    PathfindingCacheInvalidate();
+                    // Footpath actions update the graph around the tile they change themselves.
+                    if (action->GetType() != GAME_COMMAND_PLACE_PATH && action->GetType() != GAME_COMMAND_REMOVE_PATH)
+                    {
+                        FootpathGraphInvalidateAll();
+                    }
+                }
+            }
 #ifdef ENABLE_SCRIPTING
             if (result->Error == GA_ERROR::OK)
             {
@@ -275,7 +275,7 @@ private:
                 continue;
             if (_height + 4 < tileElement->base_height)
                 continue;
-            tile_element_remove(tileElement--);
+            tile_element_remove(_coords, tileElement--);
         } while (!(tileElement++)->IsLastForTile());
     }
 
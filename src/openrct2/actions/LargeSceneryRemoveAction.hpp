@@ -196,7 +196,7 @@ public:
                         continue;
 
                     map_invalidate_tile_full(currentTile);
-                    tile_element_remove(sceneryElement);
+                    tile_element_remove(currentTile, sceneryElement);
 
                     element_found = true;
                     break;
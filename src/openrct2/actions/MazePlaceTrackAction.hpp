@@ -10,6 +10,7 @@
 
 #include "../management/Finance.h"
 #include "../ride/RideData.h"
+#include "../ride/RideVisibility.h"
 #include "../ride/TrackData.h"
 #include "GameAction.h"
 
@@ -186,6 +187,7 @@ public:
         tileElement->AsTrack()->SetTrackType(TrackElemType::Maze);
         tileElement->AsTrack()->SetRideIndex(_rideIndex);
         tileElement->AsTrack()->SetMazeEntry(_mazeEntry);
+        RideVisibilityInvalidateTile(startLoc);
 
         if (flags & GAME_COMMAND_FLAG_GHOST)
         {
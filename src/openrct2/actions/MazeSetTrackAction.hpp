@@ -15,6 +15,7 @@
 #include "../localisation/StringIds.h"
 #include "../management/Finance.h"
 #include "../ride/RideData.h"
+#include "../ride/RideVisibility.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
 #include "../world/Footpath.h"
@@ -227,6 +228,7 @@ public:
             tileElement->AsTrack()->SetTrackType(TrackElemType::Maze);
             tileElement->AsTrack()->SetRideIndex(_rideIndex);
             tileElement->AsTrack()->SetMazeEntry(0xFFFF);
+            RideVisibilityInvalidateTile(startLoc);
 
             if (flags & GAME_COMMAND_FLAG_GHOST)
             {
@@ -336,7 +338,8 @@ public:
 
         if ((tileElement->AsTrack()->GetMazeEntry() & 0x8888) == 0x8888)
         {
-            tile_element_remove(tileElement);
+            tile_element_remove(_loc, tileElement);
+            RideVisibilityInvalidateTile(_loc);
             sub_6CB945(ride);
             ride->maze_tiles--;
         }
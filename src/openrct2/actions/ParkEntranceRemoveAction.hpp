@@ -102,7 +102,7 @@ private:
         }
 
         map_invalidate_tile({ loc, entranceElement->GetBaseZ(), entranceElement->GetClearanceZ() });
-        entranceElement->Remove();
+        entranceElement->Remove(loc);
         update_park_fences({ loc.x, loc.y });
     }
 };
@@ -18,6 +18,7 @@
 #include "../localisation/Localisation.h"
 #include "../management/NewsItem.h"
 #include "../ride/Ride.h"
+#include "../ride/RideVisibility.h"
 #include "../ui/UiContext.h"
 #include "../ui/WindowManager.h"
 #include "../world/Banner.h"
@@ -319,7 +320,8 @@ private:
 
                 if (removRes->Error != GA_ERROR::OK)
                 {
-                    tile_element_remove(it.element);
+                    tile_element_remove(location, it.element);
+                    RideVisibilityInvalidateTile(location);
                 }
                 else
                 {
@@ -187,7 +187,7 @@ public:
         maze_entrance_hedge_replacement({ _loc, tileElement });
         footpath_remove_edges_at(_loc, tileElement);
 
-        tile_element_remove(tileElement);
+        tile_element_remove(_loc, tileElement);
 
         if (_isExit)
         {
@@ -134,7 +134,7 @@ public:
         res->Position.z = tile_element_height(res->Position);
 
         map_invalidate_tile_full(_loc);
-        tile_element_remove(tileElement);
+        tile_element_remove(_loc, tileElement);
 
         return res;
     }
@@ -39,7 +39,7 @@ public:
 
     GameActionResult::Ptr Query() const override
     {
-        if (_spriteId >= MAX_SPRITES)
+        if (_spriteId >= GetEntityPoolSize())
         {
             log_error("Invalid spriteId. spriteId = %u", _spriteId);
             return MakeResult(GA_ERROR::INVALID_PARAMETERS, STR_NONE);
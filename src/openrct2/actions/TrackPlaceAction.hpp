@@ -11,6 +11,7 @@
 
 #include "../management/Finance.h"
 #include "../ride/RideData.h"
+#include "../ride/RideVisibility.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
 #include "../ride/TrackDesign.h"
@@ -610,6 +611,7 @@ public:
             tileElement->AsTrack()->SetSequenceIndex(trackBlock->index);
             tileElement->AsTrack()->SetRideIndex(_rideIndex);
             tileElement->AsTrack()->SetTrackType(_trackType);
+            RideVisibilityInvalidateTile(mapLoc);
             if (GetFlags() & GAME_COMMAND_FLAG_GHOST)
             {
                 tileElement->SetGhost(true);
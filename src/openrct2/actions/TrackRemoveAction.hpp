@@ -11,6 +11,7 @@
 
 #include "../management/Finance.h"
 #include "../ride/RideData.h"
+#include "../ride/RideVisibility.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
 #include "../ride/TrackDesign.h"
@@ -443,7 +444,8 @@ public:
             {
                 footpath_remove_edges_at(mapLoc, tileElement);
             }
-            tile_element_remove(tileElement);
+            tile_element_remove(mapLoc, tileElement);
+            RideVisibilityInvalidateTile(mapLoc);
             sub_6CB945(ride);
             if (!(GetFlags() & GAME_COMMAND_FLAG_GHOST))
             {
@@ -93,7 +93,7 @@ public:
 
         tile_element_remove_banner_entry(wallElement);
         map_invalidate_tile_zoom1({ _loc, wallElement->GetBaseZ(), (wallElement->GetBaseZ()) + 72 });
-        tile_element_remove(wallElement);
+        tile_element_remove(_loc, wallElement);
 
         return res;
     }
@@ -0,0 +1,237 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "CommandLine.hpp"
+
+#ifdef USE_BENCHMARK
+
+#    include "../Context.h"
+#    include "../GameState.h"
+#    include "../OpenRCT2.h"
+#    include "../actions/StaffHireNewAction.hpp"
+#    include "../peep/Staff.h"
+#    include "../platform/Platform2.h"
+#    include "../world/Footpath.h"
+#    include "../world/Map.h"
+#    include "../world/Sprite.h"
+
+#    include <benchmark/benchmark.h>
+#    include <cstdint>
+#    include <memory>
+#    include <vector>
+
+using namespace OpenRCT2;
+
+static constexpr const int32_t BENCH_LITTER_MAX_DISTANCE = 3 * COORDS_XY_STEP;
+
+/**
+ * Spreads litter over the footpaths of the loaded park until the litter limit is reached.
+ */
+static void bench_litter_fill_paths()
+{
+    for (int32_t y = 0; y < gMapSize; y++)
+    {
+        for (int32_t x = 0; x < gMapSize; x++)
+        {
+            auto tileElement = map_get_first_element_at(TileCoordsXY{ x, y }.ToCoordsXY());
+            if (tileElement == nullptr)
+                continue;
+            do
+            {
+                if (tileElement->GetType() != TILE_ELEMENT_TYPE_PATH)
+                    continue;
+
+                auto litterPos = CoordsXYZD{ TileCoordsXY{ x, y }.ToCoordsXY().ToTileCentre(), tileElement->GetBaseZ(), 0 };
+                litter_create(litterPos, (x + y) % 12);
+                if (GetEntityListCount(EntityListId::Litter) >= 500)
+                    return;
+            } while (!(tileElement++)->IsLastForTile());
+        }
+    }
+}
+
+/**
+ * Hires sweeping handymen until the staff limit is reached, they are placed on the footpaths of the park.
+ */
+static void bench_litter_hire_handymen()
+{
+    for (int32_t i = 0; i < STAFF_MAX_COUNT; i++)
+    {
+        auto hireStaffAction = StaffHireNewAction(true, StaffType::Handyman, EntertainerCostume::Count, STAFF_ORDERS_SWEEPING);
+        if (GameActions::Execute(&hireStaffAction)->Error != GA_ERROR::OK)
+            break;
+    }
+}
+
+/**
+ * Every peep position is used as a query, they are all on (or near) footpaths like a patrolling handyman.
+ */
+static std::vector<CoordsXYZ> bench_litter_query_positions()
+{
+    std::vector<CoordsXYZ> positions;
+    for (auto peep : EntityList<Peep>(EntityListId::Peep))
+    {
+        if (peep->x != LOCATION_NULL)
+        {
+            positions.emplace_back(peep->x, peep->y, peep->z);
+        }
+    }
+    return positions;
+}
+
+// The lookup as it was before the litter index: a walk of the whole litter list per query.
+static Litter* bench_litter_nearest_by_scan(const CoordsXYZ& loc)
+{
+    uint16_t nearestLitterDist = 0xFFFF;
+    Litter* nearestLitter = nullptr;
+    for (auto litter : EntityList<Litter>(EntityListId::Litter))
+    {
+        uint16_t distance = abs(litter->x - loc.x) + abs(litter->y - loc.y) + abs(litter->z - loc.z) * 4;
+        if (distance < nearestLitterDist)
+        {
+            nearestLitterDist = distance;
+            nearestLitter = litter;
+        }
+    }
+    return nearestLitterDist > BENCH_LITTER_MAX_DISTANCE ? nullptr : nearestLitter;
+}
+
+static void BM_litter_scan(benchmark::State& state, const std::vector<CoordsXYZ> positions)
+{
+    for (auto _ : state)
+    {
+        for (const auto& loc : positions)
+        {
+            benchmark::DoNotOptimize(bench_litter_nearest_by_scan(loc));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * positions.size());
+}
+
+static void BM_litter_index(benchmark::State& state, const std::vector<CoordsXYZ> positions)
+{
+    for (auto _ : state)
+    {
+        for (const auto& loc : positions)
+        {
+            benchmark::DoNotOptimize(GetNearestLitter(loc, BENCH_LITTER_MAX_DISTANCE));
+        }
+    }
+    state.SetItemsProcessed(state.iterations() * positions.size());
+}
+
+/**
+ * Whole game ticks with the handymen sweeping, the litter they pick up is put back between ticks. Besides the lookups
+ * this includes keeping the litter index up to date as litter is created and removed.
+ */
+static void BM_litter_tick(benchmark::State& state, GameState* gameState)
+{
+    LogicTimings timings{};
+    for (auto _ : state)
+    {
+        state.PauseTiming();
+        bench_litter_fill_paths();
+        state.ResumeTiming();
+
+        gameState->UpdateLogic(&timings);
+    }
+    state.counters["peep_update_all_us"] = benchmark::Counter(
+        timings[static_cast<size_t>(LogicTimePart::Peep)] * 1000000.0, benchmark::Counter::kAvgIterations);
+    state.counters["handymen"] = peep_get_staff_count();
+}
+
+static int cmdline_for_bench_litter(int argc, const char** argv)
+{
+    // Google benchmark does stuff to argv. It doesn't modify the pointees,
+    // but it wants to reorder the pointers, so present a copy of them.
+    std::vector<char*> argv_for_benchmark;
+
+    // argv[0] is expected to contain the binary name. It's only for logging purposes, don't bother.
+    argv_for_benchmark.push_back(nullptr);
+
+    // The park has to stay loaded while the benchmarks run, so only a single one is supported.
+    const char* parkPath = nullptr;
+    for (int i = 0; i < argc; i++)
+    {
+        if (parkPath == nullptr && Platform::FileExists(argv[i]))
+        {
+            parkPath = argv[i];
+        }
+        else
+        {
+            argv_for_benchmark.push_back(const_cast<char*>(argv[i]));
+        }
+    }
+    if (parkPath == nullptr)
+    {
+        log_error("No park file given.");
+        return -1;
+    }
+
+    core_init();
+    gOpenRCT2Headless = true;
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise() || !context->LoadParkFromFile(parkPath))
+    {
+        log_error("Failed to load park!");
+        return -1;
+    }
+
+    bench_litter_hire_handymen();
+    bench_litter_fill_paths();
+    auto positions = bench_litter_query_positions();
+    log_info("%u litter, %zu query positions.", GetEntityListCount(EntityListId::Litter), positions.size());
+
+    benchmark::RegisterBenchmark("scan", BM_litter_scan, positions);
+    benchmark::RegisterBenchmark("index", BM_litter_index, positions);
+    benchmark::RegisterBenchmark("tick", BM_litter_tick, context->GetGameState());
+
+    // Update argc with all the changes made
+    argc = static_cast<int>(argv_for_benchmark.size());
+    ::benchmark::Initialize(&argc, &argv_for_benchmark[0]);
+    if (::benchmark::ReportUnrecognizedArguments(argc, &argv_for_benchmark[0]))
+        return -1;
+    ::benchmark::RunSpecifiedBenchmarks();
+    return 0;
+}
+
+static exitcode_t HandleBenchLitter(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+    int32_t result = cmdline_for_bench_litter(argc, argv);
+    if (result < 0)
+    {
+        return EXITCODE_FAIL;
+    }
+    return EXITCODE_OK;
+}
+
+#else
+static exitcode_t HandleBenchLitter(CommandLineArgEnumerator* argEnumerator)
+{
+    log_error("Sorry, Google benchmark not enabled in this build");
+    return EXITCODE_FAIL;
+}
+#endif // USE_BENCHMARK
+
+const CommandLineCommand CommandLine::BenchLitterCommands[]{
+#ifdef USE_BENCHMARK
+    DefineCommand(
+        "",
+        "<file> [--benchmark_list_tests={true|false}] [--benchmark_filter=<regex>] [--benchmark_min_time=<min_time>] "
+        "[--benchmark_repetitions=<num_repetitions>] [--benchmark_report_aggregates_only={true|false}] "
+        "[--benchmark_format=<console|json|csv>] [--benchmark_out=<filename>] [--benchmark_out_format=<json|console|csv>] "
+        "[--benchmark_color={auto|true|false}] [--benchmark_counters_tabular={true|false}] [--v=<verbosity>]",
+        nullptr, HandleBenchLitter),
+    CommandTableEnd
+#else
+    DefineCommand("", "*** SORRY NOT ENABLED IN THIS BUILD ***", nullptr, HandleBenchLitter), CommandTableEnd
+#endif // USE_BENCHMARK
+};
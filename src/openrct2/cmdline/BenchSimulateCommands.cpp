@@ -0,0 +1,166 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "../Context.h"
+#include "../Game.h"
+#include "../GameState.h"
+#include "../OpenRCT2.h"
+#include "../core/Console.hpp"
+#include "../core/Json.hpp"
+#include "../network/network.h"
+#include "../platform/platform.h"
+#include "../world/Sprite.h"
+#include "CommandLine.hpp"
+
+#include <chrono>
+#include <cstdlib>
+#include <iterator>
+#include <memory>
+
+using namespace OpenRCT2;
+
+static exitcode_t HandleBenchSimulate(CommandLineArgEnumerator* argEnumerator);
+
+const CommandLineCommand CommandLine::BenchSimulateCommands[]{
+    // Main commands
+    DefineCommand("", "<file> <ticks> [<warm-up ticks>] [<json output file>]", nullptr, HandleBenchSimulate),
+    CommandTableEnd
+};
+
+// Named after the functions each part of GameState::UpdateLogic calls, in the order of LogicTimePart.
+static constexpr const char* LogicTimePartNames[] = {
+    "network_update",
+    "date_update",
+    "scenario_update",
+    "climate_update",
+    "map_update_tiles",
+    "map_remove_provisional_elements",
+    "map_update_path_wide_flags",
+    "peep_update_all",
+    "map_restore_provisional_elements",
+    "vehicle_update_all",
+    "sprite_misc_update_all",
+    "Ride::UpdateAll",
+    "Park::Update",
+    "research_update",
+    "ride_ratings_update_all",
+    "ride_measurements_update",
+    "News::UpdateCurrentItem",
+    "map_animation_invalidate_all",
+    "sounds",
+    "GameActions::ProcessQueue",
+    "network_process_pending",
+    "network_flush",
+    "scripts",
+};
+static_assert(std::size(LogicTimePartNames) == static_cast<size_t>(LogicTimePart::Count));
+
+static json_t bench_simulate_create_report(
+    const char* parkPath, uint32_t ticks, uint32_t warmupTicks, double seconds, const LogicTimings& timings)
+{
+    double timedSeconds = 0;
+    for (auto partSeconds : timings)
+    {
+        timedSeconds += partSeconds;
+    }
+
+    json_t parts = json_t::object();
+    for (size_t i = 0; i < timings.size(); i++)
+    {
+        parts[LogicTimePartNames[i]] = {
+            { "seconds", timings[i] },
+            { "microsecondsPerTick", ticks == 0 ? 0.0 : timings[i] * 1000000.0 / ticks },
+            { "percent", timedSeconds == 0 ? 0.0 : timings[i] * 100.0 / timedSeconds },
+        };
+    }
+
+    return {
+        { "park", parkPath },
+        { "warmupTicks", warmupTicks },
+        { "ticks", ticks },
+        { "seconds", seconds },
+        { "ticksPerSecond", seconds == 0 ? 0.0 : ticks / seconds },
+        { "checksum", sprite_checksum().ToString() },
+        { "parts", parts },
+    };
+}
+
+static exitcode_t HandleBenchSimulate(CommandLineArgEnumerator* argEnumerator)
+{
+    const char** argv = const_cast<const char**>(argEnumerator->GetArguments()) + argEnumerator->GetIndex();
+    int32_t argc = argEnumerator->GetCount() - argEnumerator->GetIndex();
+
+    if (argc < 2)
+    {
+        Console::Error::WriteLine("Missing arguments <file> <ticks>.");
+        return EXITCODE_FAIL;
+    }
+
+    core_init();
+
+    const char* inputPath = argv[0];
+    uint32_t ticks = atol(argv[1]);
+    uint32_t warmupTicks = argc >= 3 ? atol(argv[2]) : 0;
+    const char* outputPath = argc >= 4 ? argv[3] : nullptr;
+
+    gOpenRCT2Headless = true;
+
+    // Run as a server like the simulate command does, so the network parts are measured as well.
+#ifndef DISABLE_NETWORK
+    gNetworkStart = NETWORK_MODE_SERVER;
+#endif
+
+    std::unique_ptr<IContext> context(CreateContext());
+    if (!context->Initialise())
+    {
+        Console::Error::WriteLine("Context initialization failed.");
+        return EXITCODE_FAIL;
+    }
+    if (!context->LoadParkFromFile(inputPath))
+    {
+        return EXITCODE_FAIL;
+    }
+
+    auto gameState = context->GetGameState();
+    for (uint32_t i = 0; i < warmupTicks; i++)
+    {
+        gameState->UpdateLogic();
+    }
+
+    LogicTimings timings{};
+    auto startTime = std::chrono::high_resolution_clock::now();
+    for (uint32_t i = 0; i < ticks; i++)
+    {
+        gameState->UpdateLogic(&timings);
+    }
+    auto endTime = std::chrono::high_resolution_clock::now();
+    double seconds = std::chrono::duration<double>(endTime - startTime).count();
+
+    auto report = bench_simulate_create_report(inputPath, ticks, warmupTicks, seconds, timings);
+    if (outputPath == nullptr)
+    {
+        Console::WriteLine("%s", report.dump(4).c_str());
+    }
+    else
+    {
+        try
+        {
+            Json::WriteToFile(outputPath, report);
+        }
+        catch (const std::exception& e)
+        {
+            Console::Error::WriteLine("Unable to write %s: %s", outputPath, e.what());
+            return EXITCODE_FAIL;
+        }
+        Console::WriteLine(
+            "%u ticks in %.3f seconds (%.1f ticks/s), report written to %s", ticks, seconds,
+            seconds == 0 ? 0.0 : ticks / seconds, outputPath);
+    }
+    return EXITCODE_OK;
+}
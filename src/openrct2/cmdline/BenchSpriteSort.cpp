@@ -34,42 +34,33 @@
 #    include <iterator>
 #    include <vector>
 
-static void fixup_pointers(paint_session* s, size_t paint_session_entries, size_t paint_struct_entries, size_t quadrant_entries)
+static paint_struct* fixup_pointer(paint_struct* index, std::vector<paint_entry>& entries)
 {
-    for (size_t i = 0; i < paint_session_entries; i++)
+    auto entryIndex = reinterpret_cast<uintptr_t>(index);
+    return entryIndex == 0 ? nullptr : &entries[entryIndex - 1].basic;
+}
+
+static void fixup_pointers(std::vector<RecordedPaintSession>& s)
+{
+    for (auto& recorded : s)
     {
-        for (size_t j = 0; j < paint_struct_entries; j++)
+        for (auto& entry : recorded.Entries)
         {
-            if (s[i].PaintStructs[j].basic.next_quadrant_ps == (paint_struct*)paint_struct_entries)
-            {
-                s[i].PaintStructs[j].basic.next_quadrant_ps = nullptr;
-            }
-            else
-            {
-                auto nextQuadrantPs = reinterpret_cast<uintptr_t>(s[i].PaintStructs[j].basic.next_quadrant_ps);
-                s[i].PaintStructs[j].basic.next_quadrant_ps = &s[i].PaintStructs[nextQuadrantPs].basic;
-            }
+            entry.basic.next_quadrant_ps = fixup_pointer(entry.basic.next_quadrant_ps, recorded.Entries);
         }
-        for (size_t j = 0; j < quadrant_entries; j++)
+        for (auto& quadrant : recorded.Session.Quadrants)
         {
-            if (s[i].Quadrants[j] == (paint_struct*)quadrant_entries)
-            {
-                s[i].Quadrants[j] = nullptr;
-            }
-            else
-            {
-                s[i].Quadrants[j] = &s[i].PaintStructs[(size_t)s[i].Quadrants[j]].basic;
-            }
+            quadrant = fixup_pointer(quadrant, recorded.Entries);
         }
     }
 }
 
-static std::vector<paint_session> extract_paint_session(const std::string parkFileName)
+static std::vector<RecordedPaintSession> extract_paint_session(const std::string parkFileName)
 {
     core_init();
     gOpenRCT2Headless = true;
     auto context = OpenRCT2::CreateContext();
-    std::vector<paint_session> sessions;
+    std::vector<RecordedPaintSession> sessions;
     log_info("Starting...");
     if (context->Initialise())
     {
@@ -133,40 +124,37 @@ static std::vector<paint_session> extract_paint_session(const std::string parkFi
 }
 
 // This function is based on benchgfx_render_screenshots
-static void BM_paint_session_arrange(benchmark::State& state, const std::vector<paint_session> inputSessions)
+static void BM_paint_session_arrange(benchmark::State& state, const std::vector<RecordedPaintSession> inputSessions)
 {
-    std::vector<paint_session> sessions = inputSessions;
+    std::vector<RecordedPaintSession> sessions = inputSessions;
     // Fixing up the pointers continuously is wasteful. Fix it up once for `sessions` and store a copy.
     // Keep in mind we need bit-exact copy, as the lists use pointers.
-    // Once sorted, just restore the copy with the original fixed-up version.
-    paint_session* local_s = new paint_session[std::size(sessions)];
-    fixup_pointers(&sessions[0], std::size(sessions), std::size(local_s->PaintStructs), std::size(local_s->Quadrants));
-    std::copy_n(sessions.cbegin(), std::size(sessions), local_s);
+    // Once sorted, just restore the copy with the original fixed-up version, in place so the pointers stay valid.
+    fixup_pointers(sessions);
+    std::vector<RecordedPaintSession> local_s = sessions;
     for (auto _ : state)
     {
         state.PauseTiming();
-        std::copy_n(local_s, std::size(sessions), sessions.begin());
+        for (size_t i = 0; i < std::size(sessions); i++)
+        {
+            sessions[i].Session = local_s[i].Session;
+            std::copy(local_s[i].Entries.cbegin(), local_s[i].Entries.cend(), sessions[i].Entries.begin());
+        }
         state.ResumeTiming();
-        paint_session_arrange(&sessions[0]);
+        for (auto& recorded : sessions)
+        {
+            paint_session_arrange(&recorded.Session);
+        }
         benchmark::DoNotOptimize(sessions);
     }
     state.SetItemsProcessed(state.iterations() * std::size(sessions));
-    delete[] local_s;
 }
 
 static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
 {
     {
         // Register some basic "baseline" benchmark
-        std::vector<paint_session> sessions(1);
-        for (auto& ps : sessions[0].PaintStructs)
-        {
-            ps.basic.next_quadrant_ps = (paint_struct*)(std::size(sessions[0].PaintStructs));
-        }
-        for (auto& quad : sessions[0].Quadrants)
-        {
-            quad = (paint_struct*)(std::size(sessions[0].Quadrants));
-        }
+        std::vector<RecordedPaintSession> sessions(1);
         benchmark::RegisterBenchmark("baseline", BM_paint_session_arrange, sessions);
     }
 
@@ -183,7 +171,7 @@ static int cmdline_for_bench_sprite_sort(int argc, const char** argv)
         if (Platform::FileExists(argv[i]))
         {
             // Register benchmark for sv6 if valid
-            std::vector<paint_session> sessions = extract_paint_session(argv[i]);
+            std::vector<RecordedPaintSession> sessions = extract_paint_session(argv[i]);
             if (!sessions.empty())
                 benchmark::RegisterBenchmark(argv[i], BM_paint_session_arrange, sessions);
         }
@@ -41,6 +41,7 @@ struct GeneralConfiguration
     bool use_vsync;
     bool show_fps;
     bool multithreading;
+    int32_t worker_threads;
     bool minimize_fullscreen_focus_loss;
 
     // Map rendering
@@ -94,6 +95,7 @@ struct GeneralConfiguration
     bool steam_overlay_pause;
     bool show_real_names_of_guests;
     bool allow_early_completion;
+    int32_t max_tile_elements;
 
     // Loading and saving
     bool confirmation_prompt;
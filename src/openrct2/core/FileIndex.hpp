@@ -14,8 +14,8 @@
 #include "File.h"
 #include "FileScanner.h"
 #include "FileStream.hpp"
-#include "JobPool.hpp"
 #include "Path.hpp"
+#include "TaskScheduler.h"
 
 #include <chrono>
 #include <list>
@@ -205,7 +205,8 @@ private:
         const size_t totalCount = scanResult.Files.size();
         if (totalCount > 0)
         {
-            JobPool jobPool;
+            auto& scheduler = GetTaskScheduler();
+            TaskGroup group;
             std::mutex printLock; // For verbose prints.
 
             std::list<std::vector<TItem>> containers;
@@ -228,14 +229,16 @@ private:
 
                 auto& items = containers.emplace_back();
 
-                jobPool.AddTask(std::bind(
-                    &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), rangeStart, rangeStart + stepSize,
-                    std::ref(items), std::ref(processed), std::ref(printLock)));
+                scheduler.Run(
+                    group,
+                    std::bind(
+                        &FileIndex<TItem>::BuildRange, this, language, std::cref(scanResult), rangeStart,
+                        rangeStart + stepSize, std::ref(items), std::ref(processed), std::ref(printLock)));
 
                 reportProgress();
             }
 
-            jobPool.Join(reportProgress);
+            scheduler.Wait(group, reportProgress);
 
             for (auto&& itr : containers)
             {
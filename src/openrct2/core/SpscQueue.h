@@ -0,0 +1,74 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <atomic>
+#include <utility>
+
+/**
+ * An unbounded lock-free queue for passing values from one thread to one other thread. Push may only be called by the
+ * producing thread and TryPop only by the consuming thread.
+ */
+template<typename T> class SpscQueue
+{
+private:
+    struct Node
+    {
+        T Value{};
+        std::atomic<Node*> Next{ nullptr };
+    };
+
+    // The consumer owns the head, which is always a node whose value was taken already.
+    Node* _head;
+    // The producer owns the tail, the last node that was pushed.
+    Node* _tail;
+
+public:
+    SpscQueue()
+        : _head(new Node())
+        , _tail(_head)
+    {
+    }
+
+    ~SpscQueue()
+    {
+        while (_head != nullptr)
+        {
+            auto next = _head->Next.load(std::memory_order_relaxed);
+            delete _head;
+            _head = next;
+        }
+    }
+
+    SpscQueue(const SpscQueue&) = delete;
+    SpscQueue& operator=(const SpscQueue&) = delete;
+
+    void Push(T value)
+    {
+        auto node = new Node();
+        node->Value = std::move(value);
+        _tail->Next.store(node, std::memory_order_release);
+        _tail = node;
+    }
+
+    bool TryPop(T& value)
+    {
+        auto next = _head->Next.load(std::memory_order_acquire);
+        if (next == nullptr)
+        {
+            return false;
+        }
+        value = std::move(next->Value);
+        next->Value = T{};
+        delete _head;
+        _head = next;
+        return true;
+    }
+};
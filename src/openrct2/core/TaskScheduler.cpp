@@ -0,0 +1,309 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TaskScheduler.h"
+
+#include <cassert>
+
+// The number of times a worker looks for a task again before it goes to sleep, tasks often come in bursts.
+static constexpr const int32_t TASK_SCHEDULER_SPIN_COUNT = 64;
+
+thread_local TaskScheduler* TaskScheduler::_workerScheduler = nullptr;
+thread_local TaskScheduler::TaskDeque* TaskScheduler::_workerQueue = nullptr;
+
+bool TaskScheduler::TaskDeque::Push(Task* task)
+{
+    auto bottom = _bottom.load(std::memory_order_relaxed);
+    auto top = _top.load(std::memory_order_acquire);
+    if (bottom - top >= Capacity)
+        return false;
+
+    _tasks[bottom & (Capacity - 1)].store(task, std::memory_order_relaxed);
+    _bottom.store(bottom + 1, std::memory_order_release);
+    return true;
+}
+
+TaskScheduler::Task* TaskScheduler::TaskDeque::Pop()
+{
+    // The store to bottom has to be ordered before the load of top, so a thief can not take the same task
+    auto bottom = _bottom.load(std::memory_order_relaxed) - 1;
+    _bottom.store(bottom, std::memory_order_seq_cst);
+    auto top = _top.load(std::memory_order_seq_cst);
+    if (top > bottom)
+    {
+        // Empty
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+        return nullptr;
+    }
+
+    auto task = _tasks[bottom & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (top == bottom)
+    {
+        // The last task, race the thieves for it
+        if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+        {
+            task = nullptr;
+        }
+        _bottom.store(bottom + 1, std::memory_order_relaxed);
+    }
+    return task;
+}
+
+TaskScheduler::Task* TaskScheduler::TaskDeque::Steal()
+{
+    auto top = _top.load(std::memory_order_seq_cst);
+    auto bottom = _bottom.load(std::memory_order_seq_cst);
+    if (top >= bottom)
+        return nullptr;
+
+    auto task = _tasks[top & (Capacity - 1)].load(std::memory_order_relaxed);
+    if (!_top.compare_exchange_strong(top, top + 1, std::memory_order_seq_cst, std::memory_order_relaxed))
+    {
+        // Another thread took it first
+        return nullptr;
+    }
+    return task;
+}
+
+TaskScheduler::TaskScheduler(size_t numThreads)
+{
+    for (size_t i = 0; i < numThreads; i++)
+    {
+        _workerQueues.push_back(std::make_unique<TaskDeque>());
+    }
+    for (size_t i = 0; i < numThreads; i++)
+    {
+        _threads.emplace_back(&TaskScheduler::ProcessQueue, this, i);
+    }
+}
+
+TaskScheduler::~TaskScheduler()
+{
+    {
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _shouldStop = true;
+        _condWake.notify_all();
+    }
+
+    for (auto& th : _threads)
+    {
+        assert(th.joinable());
+        th.join();
+    }
+}
+
+void TaskScheduler::Run(TaskGroup& group, std::function<void()> fn)
+{
+    group._pending.fetch_add(1, std::memory_order_relaxed);
+    auto task = new Task{ std::move(fn), &group };
+
+    auto queue = _threads.empty() ? nullptr : GetQueueOfCurrentThread();
+    if (queue == nullptr || !queue->Push(task))
+    {
+        Execute(task);
+        return;
+    }
+
+    _queuedTasks.fetch_add(1);
+    if (_sleepingWorkers.load() > 0)
+    {
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _condWake.notify_one();
+    }
+}
+
+void TaskScheduler::Wait(TaskGroup& group, const std::function<void()>& reportFn)
+{
+    auto ownQueue = _threads.empty() ? nullptr : GetQueueOfCurrentThread();
+    auto lastPending = group._pending.load();
+    while (!group.IsDone())
+    {
+        if (reportFn != nullptr && group._pending.load() != lastPending)
+        {
+            lastPending = group._pending.load();
+            reportFn();
+        }
+
+        auto task = FindTask(ownQueue);
+        if (task != nullptr)
+        {
+            Execute(task);
+        }
+        else
+        {
+            // The remaining tasks of the group are running on other threads
+            std::this_thread::yield();
+        }
+    }
+    if (reportFn != nullptr)
+    {
+        reportFn();
+    }
+}
+
+void TaskScheduler::ProcessQueue(size_t workerIndex)
+{
+    _workerScheduler = this;
+    _workerQueue = _workerQueues[workerIndex].get();
+
+    int32_t spins = 0;
+    while (true)
+    {
+        auto task = FindTask(_workerQueue);
+        if (task != nullptr)
+        {
+            Execute(task);
+            spins = 0;
+            continue;
+        }
+
+        if (spins < TASK_SCHEDULER_SPIN_COUNT)
+        {
+            spins++;
+            std::this_thread::yield();
+            continue;
+        }
+        spins = 0;
+
+        std::unique_lock<std::mutex> lock(_sleepMutex);
+        _sleepingWorkers++;
+        _condWake.wait(lock, [this]() { return _shouldStop || _queuedTasks.load() > 0; });
+        _sleepingWorkers--;
+        if (_shouldStop && _queuedTasks.load() <= 0)
+            break;
+    }
+}
+
+TaskScheduler::TaskDeque* TaskScheduler::GetQueueOfCurrentThread()
+{
+    if (_workerScheduler == this)
+        return _workerQueue;
+
+    auto threadId = std::this_thread::get_id();
+    for (auto& queue : _externalQueues)
+    {
+        if (queue.Owner.load() == threadId)
+            return &queue.Tasks;
+    }
+    for (auto& queue : _externalQueues)
+    {
+        auto noOwner = std::thread::id();
+        if (queue.Owner.compare_exchange_strong(noOwner, threadId))
+            return &queue.Tasks;
+    }
+    return nullptr;
+}
+
+TaskScheduler::Task* TaskScheduler::FindTask(TaskDeque* ownQueue)
+{
+    Task* task = nullptr;
+    if (ownQueue != nullptr)
+    {
+        task = ownQueue->Pop();
+    }
+    for (auto it = _workerQueues.begin(); task == nullptr && it != _workerQueues.end(); it++)
+    {
+        if (it->get() != ownQueue)
+            task = (*it)->Steal();
+    }
+    for (auto it = _externalQueues.begin(); task == nullptr && it != _externalQueues.end(); it++)
+    {
+        if (&it->Tasks != ownQueue)
+            task = it->Tasks.Steal();
+    }
+
+    if (task != nullptr)
+    {
+        _queuedTasks.fetch_sub(1);
+    }
+    return task;
+}
+
+void TaskScheduler::Execute(Task* task)
+{
+    task->Fn();
+    task->Group->_pending.fetch_sub(1, std::memory_order_release);
+    delete task;
+}
+
+TaskGraph::TaskId TaskGraph::Add(std::function<void()> fn, std::initializer_list<TaskId> dependencies)
+{
+    auto id = _nodes.size();
+    auto& node = _nodes.emplace_back(std::make_unique<Node>());
+    node->Fn = std::move(fn);
+    node->NumDependencies = dependencies.size();
+    for (auto dependency : dependencies)
+    {
+        assert(dependency < id);
+        _nodes[dependency]->Dependents.push_back(id);
+    }
+    return id;
+}
+
+void TaskGraph::Run(TaskScheduler& scheduler)
+{
+    for (auto& node : _nodes)
+    {
+        node->RemainingDependencies = node->NumDependencies;
+    }
+
+    TaskGroup group;
+    for (auto& node : _nodes)
+    {
+        if (node->NumDependencies == 0)
+        {
+            Start(scheduler, group, *node);
+        }
+    }
+    scheduler.Wait(group);
+}
+
+void TaskGraph::Start(TaskScheduler& scheduler, TaskGroup& group, Node& node)
+{
+    scheduler.Run(group, [this, &scheduler, &group, &node]() {
+        node.Fn();
+
+        // The dependents are added to the group before this task leaves it, so the group can not be done in between
+        for (auto dependent : node.Dependents)
+        {
+            auto& dependentNode = *_nodes[dependent];
+            if (dependentNode.RemainingDependencies.fetch_sub(1) == 1)
+            {
+                Start(scheduler, group, dependentNode);
+            }
+        }
+    });
+}
+
+static std::unique_ptr<TaskScheduler> _sharedTaskScheduler;
+static size_t _sharedTaskSchedulerThreadCount;
+
+TaskScheduler& GetTaskScheduler()
+{
+    if (_sharedTaskScheduler == nullptr)
+    {
+        auto numThreads = _sharedTaskSchedulerThreadCount;
+        if (numThreads == 0)
+        {
+            // The thread that waits for tasks runs them as well, so it needs one worker less than there are cores
+            numThreads = std::max<size_t>(std::thread::hardware_concurrency(), 2) - 1;
+        }
+        _sharedTaskScheduler = std::make_unique<TaskScheduler>(numThreads);
+    }
+    return *_sharedTaskScheduler;
+}
+
+void SetTaskSchedulerThreadCount(size_t numThreads)
+{
+    if (numThreads != _sharedTaskSchedulerThreadCount)
+    {
+        _sharedTaskSchedulerThreadCount = numThreads;
+        _sharedTaskScheduler.reset();
+    }
+}
@@ -0,0 +1,213 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <functional>
+#include <initializer_list>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+/**
+ * A set of tasks that can be waited for together.
+ */
+class TaskGroup
+{
+    friend class TaskScheduler;
+
+private:
+    std::atomic<size_t> _pending{ 0 };
+
+public:
+    bool IsDone() const
+    {
+        return _pending.load(std::memory_order_acquire) == 0;
+    }
+};
+
+/**
+ * Runs tasks on a set of worker threads that live as long as the scheduler, so it can be reused every frame.
+ *
+ * Every worker has its own queue of tasks, and so does each other thread that adds tasks. Threads take the newest
+ * task of their own queue and steal the oldest task of another queue once theirs is empty, neither needs a lock.
+ * Workers only take a lock to sleep when there is nothing left to steal.
+ */
+class TaskScheduler
+{
+private:
+    struct Task
+    {
+        std::function<void()> Fn;
+        TaskGroup* Group;
+    };
+
+    /**
+     * A fixed size Chase-Lev deque. Only the owning thread pushes and pops at the bottom, any thread can steal from the top.
+     */
+    class TaskDeque
+    {
+    private:
+        static constexpr int64_t Capacity = 4096;
+
+        std::atomic<int64_t> _top{ 0 };
+        std::atomic<int64_t> _bottom{ 0 };
+        std::array<std::atomic<Task*>, Capacity> _tasks{};
+
+    public:
+        bool Push(Task* task);
+        Task* Pop();
+        Task* Steal();
+    };
+
+    struct ExternalQueue
+    {
+        std::atomic<std::thread::id> Owner{};
+        TaskDeque Tasks;
+    };
+
+    // The number of threads other than the workers that can have a queue, tasks from any further thread run straight away.
+    static constexpr size_t MaxExternalQueues = 8;
+
+    std::vector<std::thread> _threads;
+    std::vector<std::unique_ptr<TaskDeque>> _workerQueues;
+    std::array<ExternalQueue, MaxExternalQueues> _externalQueues;
+
+    std::atomic<int64_t> _queuedTasks{ 0 };
+    std::atomic<size_t> _sleepingWorkers{ 0 };
+    std::atomic_bool _shouldStop{ false };
+    std::mutex _sleepMutex;
+    std::condition_variable _condWake;
+
+    // Set on the worker threads of a scheduler.
+    static thread_local TaskScheduler* _workerScheduler;
+    static thread_local TaskDeque* _workerQueue;
+
+public:
+    explicit TaskScheduler(size_t numThreads);
+    ~TaskScheduler();
+
+    TaskScheduler(const TaskScheduler&) = delete;
+    TaskScheduler& operator=(const TaskScheduler&) = delete;
+
+    size_t GetThreadCount() const
+    {
+        return _threads.size();
+    }
+
+    /**
+     * Adds a task to the group. It runs straight away on the calling thread if there are no workers.
+     */
+    void Run(TaskGroup& group, std::function<void()> fn);
+
+    /**
+     * Runs tasks on the calling thread until all tasks of the group are done. reportFn is called on the calling thread
+     * each time tasks of the group were completed.
+     */
+    void Wait(TaskGroup& group, const std::function<void()>& reportFn = nullptr);
+
+    /**
+     * Calls fn for every index from begin to end, with up to grainSize indices per task.
+     */
+    template<typename TFn> void ParallelFor(size_t begin, size_t end, size_t grainSize, const TFn& fn)
+    {
+        grainSize = std::max<size_t>(grainSize, 1);
+        TaskGroup group;
+        for (size_t rangeBegin = begin; rangeBegin < end; rangeBegin += grainSize)
+        {
+            auto rangeEnd = std::min(end, rangeBegin + grainSize);
+            Run(group, [&fn, rangeBegin, rangeEnd]() {
+                for (size_t i = rangeBegin; i < rangeEnd; i++)
+                {
+                    fn(i);
+                }
+            });
+        }
+        Wait(group);
+    }
+
+    /**
+     * Calls rangeFn for each range of up to grainSize indices from begin to end, and combines their results with
+     * combineFn. The results are combined in the order of their ranges, so the result does not depend on the threads.
+     */
+    template<typename T, typename TRangeFn, typename TCombineFn>
+    T ParallelReduce(
+        size_t begin, size_t end, size_t grainSize, T identity, const TRangeFn& rangeFn, const TCombineFn& combineFn)
+    {
+        grainSize = std::max<size_t>(grainSize, 1);
+        auto numRanges = end > begin ? (end - begin + grainSize - 1) / grainSize : 0;
+        std::vector<T> results(numRanges, identity);
+        ParallelFor(0, numRanges, 1, [&](size_t range) {
+            auto rangeBegin = begin + (range * grainSize);
+            results[range] = rangeFn(rangeBegin, std::min(end, rangeBegin + grainSize));
+        });
+
+        T result = std::move(identity);
+        for (auto& rangeResult : results)
+        {
+            result = combineFn(std::move(result), std::move(rangeResult));
+        }
+        return result;
+    }
+
+private:
+    void ProcessQueue(size_t workerIndex);
+    TaskDeque* GetQueueOfCurrentThread();
+    Task* FindTask(TaskDeque* ownQueue);
+    void Execute(Task* task);
+};
+
+/**
+ * A set of tasks with dependencies between them. Each task is started as soon as the tasks it depends on are done.
+ */
+class TaskGraph
+{
+public:
+    using TaskId = size_t;
+
+private:
+    struct Node
+    {
+        std::function<void()> Fn;
+        std::vector<TaskId> Dependents;
+        size_t NumDependencies = 0;
+        std::atomic<size_t> RemainingDependencies{ 0 };
+    };
+
+    std::vector<std::unique_ptr<Node>> _nodes;
+
+public:
+    /**
+     * Adds a task that starts once all given tasks are done, they have to be added first.
+     */
+    TaskId Add(std::function<void()> fn, std::initializer_list<TaskId> dependencies = {});
+
+    /**
+     * Runs every task of the graph and waits for them. The graph can be run again afterwards.
+     */
+    void Run(TaskScheduler& scheduler);
+
+private:
+    void Start(TaskScheduler& scheduler, TaskGroup& group, Node& node);
+};
+
+// The scheduler shared by the game, created with the configured number of threads on first use.
+TaskScheduler& GetTaskScheduler();
+
+/**
+ * Sets the number of worker threads of the shared scheduler, 0 for one less than there are cores. The scheduler is
+ * recreated on its next use, so this must not be called while it runs tasks.
+ */
+void SetTaskSchedulerThreadCount(size_t numThreads);
@@ -20,6 +20,7 @@
 #include "Drawing.h"
 
 #include <algorithm>
+#include <cstring>
 #include <memory>
 #include <stdexcept>
 #include <vector>
@@ -371,10 +372,12 @@ static std::optional<PaletteMap> FASTCALL gfx_draw_sprite_get_palette(ImageId im
     }
     else
     {
-        auto paletteMap = PaletteMap(gPeepPalette);
+        // Viewport columns are drawn on several threads, each of them remaps a copy of its own
+        thread_local uint8_t palette[256];
+        std::memcpy(palette, imageId.HasTertiary() ? gOtherPalette : gPeepPalette, sizeof(palette));
+        auto paletteMap = PaletteMap(palette);
         if (imageId.HasTertiary())
         {
-            paletteMap = PaletteMap(gOtherPalette);
             auto tertiaryPaletteMap = GetPaletteMapForColour(imageId.GetTertiary());
             if (tertiaryPaletteMap)
             {
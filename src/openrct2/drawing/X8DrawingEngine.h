@@ -136,7 +136,9 @@ namespace OpenRCT2
         {
         private:
             X8DrawingEngine* _engine = nullptr;
-            rct_drawpixelinfo* _dpi = nullptr;
+
+            // Per thread, so each thread can draw to its own DPI through the same context.
+            static thread_local rct_drawpixelinfo* _dpi;
 
         public:
             explicit X8DrawingContext(X8DrawingEngine* engine);
@@ -39,6 +39,7 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../object/ObjectRepository.h"
+#include "../peep/GuestPathfinding.h"
 #include "../peep/Staff.h"
 #include "../platform/platform.h"
 #include "../ride/Ride.h"
@@ -1223,8 +1224,14 @@ static int32_t cc_remove_park_fences(InteractiveConsole& console, [[maybe_unused
 
 static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
 {
-    map_reorganise_elements();
-    int32_t tileElementCount = gNextFreeTileElement - gTileElements - 1;
+    // Tiles keep spare room after their elements, so only the elements on the tiles are counted
+    int32_t tileElementCount = 0;
+    tile_element_iterator it;
+    tile_element_iterator_begin(&it);
+    while (tile_element_iterator_next(&it))
+    {
+        tileElementCount++;
+    }
 
     int32_t rideCount = ride_get_count();
     int32_t spriteCount = 0;
@@ -1252,8 +1259,9 @@ static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] cons
         }
     }
 
-    console.WriteFormatLine("Sprites: %d/%d", spriteCount, MAX_SPRITES);
-    console.WriteFormatLine("Map Elements: %d/%d", tileElementCount, MAX_TILE_ELEMENTS);
+    console.WriteFormatLine("Sprites: %d/%zu", spriteCount, GetEntityPoolSize());
+    console.WriteFormatLine(
+        "Map Elements: %d/%zu", tileElementCount, MapGetTileElementLimit() - TILE_ELEMENT_HEAP_SPARE_ROOM);
     console.WriteFormatLine("Banners: %d/%zu", bannerCount, MAX_BANNERS);
     console.WriteFormatLine("Rides: %d/%d", rideCount, MAX_RIDES);
     console.WriteFormatLine("Staff: %d/%d", staffCount, STAFF_MAX_COUNT);
@@ -1261,6 +1269,23 @@ static int32_t cc_show_limits(InteractiveConsole& console, [[maybe_unused]] cons
     return 0;
 }
 
+static int32_t cc_pathfinding_cache(InteractiveConsole& console, const arguments_t& argv)
+{
+    if (!argv.empty() && argv[0] == "reset")
+    {
+        PathfindingCacheResetStats();
+    }
+
+    auto stats = PathfindingCacheGetStats();
+    auto lookups = stats.Hits + stats.Misses;
+    console.WriteFormatLine("Hits: %llu", static_cast<long long unsigned>(stats.Hits));
+    console.WriteFormatLine("Misses: %llu", static_cast<long long unsigned>(stats.Misses));
+    console.WriteFormatLine("Hit rate: %.1f%%", lookups == 0 ? 0.0 : stats.Hits * 100.0 / lookups);
+    console.WriteFormatLine("Invalidations: %llu", static_cast<long long unsigned>(stats.Invalidations));
+    console.WriteFormatLine("Entries: %zu", stats.Entries);
+    return 0;
+}
+
 static int32_t cc_for_date([[maybe_unused]] InteractiveConsole& console, [[maybe_unused]] const arguments_t& argv)
 {
     int32_t year = 0;
@@ -1575,7 +1600,7 @@ static int32_t cc_mp_desync(InteractiveConsole& console, const arguments_t& argv
 
     std::vector<Peep*> peeps;
 
-    for (int i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < GetEntityPoolSize(); i++)
     {
         auto* sprite = GetEntity(i);
         if (sprite == nullptr || sprite->sprite_identifier == SPRITE_IDENTIFIER_NULL)
@@ -1785,6 +1810,7 @@ static constexpr const console_command console_command_table[] = {
     { "load_park", cc_load_park, "Load park from save directory or by absolute path", "load_park <filename>" },
     { "object_count", cc_object_count, "Shows the number of objects of each type in the scenario.", "object_count" },
     { "open", cc_open, "Opens the window with the give name.", "open <window>." },
+    { "pathfinding_cache", cc_pathfinding_cache, "Shows the hit and miss counters of the guest pathfinding cache.", "pathfinding_cache [reset]" },
     { "quit", cc_close, "Closes the console.", "quit" },
     { "remove_park_fences", cc_remove_park_fences, "Removes all park fences from the surface", "remove_park_fences" },
     { "remove_unused_objects", cc_remove_unused_objects, "Removes all the unused objects from the object selection.", "remove_unused_objects" },
@@ -20,6 +20,7 @@
 #include "../drawing/Drawing.h"
 #include "../drawing/X8DrawingEngine.h"
 #include "../localisation/Localisation.h"
+#include "../paint/Painter.h"
 #include "../platform/Platform2.h"
 #include "../util/Util.h"
 #include "../world/Climate.h"
@@ -471,11 +472,16 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
         double totalTime = 0.0;
 
         std::array<double, MAX_ZOOM_LEVEL> zoomAverages;
+        std::array<ViewportPaintStats, MAX_ZOOM_LEVEL> zoomPaintStats;
+        std::array<Paint::PaintEntryStats, MAX_ZOOM_LEVEL> zoomPaintEntryStats;
+        auto painter = GetContext()->GetPainter();
 
         // Render at every zoom.
         for (int32_t zoom = 0; zoom < MAX_ZOOM_LEVEL; zoom++)
         {
             double zoomLevelTime = 0.0;
+            viewport_reset_paint_stats();
+            painter->ResetPaintEntryStats();
 
             // Render at every rotation.
             for (int32_t rotation = 0; rotation < MAX_ROTATIONS; rotation++)
@@ -492,6 +498,8 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
             }
 
             zoomAverages[zoom] = zoomLevelTime / static_cast<double>(MAX_ROTATIONS * iterationCount);
+            zoomPaintStats[zoom] = viewport_get_paint_stats();
+            zoomPaintEntryStats[zoom] = painter->GetPaintEntryStats();
         }
 
         const double average = totalTime / static_cast<double>(totalRenderCount);
@@ -499,10 +507,31 @@ static void benchgfx_render_screenshots(const char* inputPath, std::unique_ptr<I
         const auto engineName = format_string(engineStringId, nullptr);
         std::printf("Engine: %s\n", engineName.c_str());
         std::printf("Render Count: %u\n", totalRenderCount);
+        std::printf("Paint Threads: %zu\n", viewport_get_paint_thread_count());
         for (int32_t zoom = 0; zoom < MAX_ZOOM_LEVEL; zoom++)
         {
             const auto zoomAverage = zoomAverages[zoom];
             std::printf("Zoom[%d] average: %.06fs, %.f FPS\n", zoom, zoomAverage, 1.0 / zoomAverage);
+
+            // How many columns were busy at the same time shows how well painting scales with the threads
+            const auto& stats = zoomPaintStats[zoom];
+            const auto renders = static_cast<double>(MAX_ROTATIONS * iterationCount);
+            const auto columnSeconds = stats.GenerateColumnSeconds + stats.DrawColumnSeconds;
+            std::printf(
+                "    paint: %.06fs, columns generate: %.06fs, draw: %.06fs, %.2fx parallel\n", stats.Seconds / renders,
+                stats.GenerateColumnSeconds / renders, stats.DrawColumnSeconds / renders,
+                stats.Seconds > 0 ? columnSeconds / stats.Seconds : 0.0);
+
+            const auto& entryStats = zoomPaintEntryStats[zoom];
+            std::printf(
+                "    paint entries: %zu peak per column, %zu peak chunks in use, %zu KiB\n", entryStats.PeakSessionEntries,
+                entryStats.PeakChunksInUse, entryStats.ChunksAllocated * sizeof(paint_entry_chunk) / 1024);
+
+            // The first paint of a column is never cached and the second one records it
+            const auto& tileStats = stats.TileCache;
+            std::printf(
+                "    tile cache: %u cached, %u recorded, %u uncached tiles\n", tileStats.CachedTiles, tileStats.RecordedTiles,
+                tileStats.UncachedTiles);
         }
         std::printf("Total average: %.06fs, %.f FPS\n", average, 1.0 / average);
         std::printf("Time: %.05fs\n", totalTime);
@@ -15,10 +15,11 @@
 #include "../OpenRCT2.h"
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
-#include "../core/JobPool.hpp"
+#include "../core/TaskScheduler.h"
 #include "../drawing/Drawing.h"
 #include "../drawing/IDrawingEngine.h"
 #include "../paint/Paint.h"
+#include "../paint/PaintTileCache.h"
 #include "../peep/Staff.h"
 #include "../ride/Ride.h"
 #include "../ride/TrackDesign.h"
@@ -32,6 +33,7 @@
 #include "Window_internal.h"
 
 #include <algorithm>
+#include <chrono>
 #include <cstring>
 
 using namespace OpenRCT2;
@@ -44,7 +46,7 @@ uint8_t gShowConstuctionRightsRefCount;
 rct_viewport g_viewport_list[MAX_VIEWPORT_COUNT];
 rct_viewport* g_music_tracking_viewport;
 
-static std::unique_ptr<JobPool> _paintJobs;
+static ViewportPaintStats _paintStats;
 
 ScreenCoordsXY gSavedView;
 ZoomLevel gSavedViewZoom;
@@ -791,7 +793,7 @@ void viewport_update_smart_vehicle_follow(rct_window* window)
  */
 void viewport_render(
     rct_drawpixelinfo* dpi, const rct_viewport* viewport, int32_t left, int32_t top, int32_t right, int32_t bottom,
-    std::vector<paint_session>* sessions)
+    std::vector<RecordedPaintSession>* sessions)
 {
     if (right <= viewport->pos.x)
         return;
@@ -832,30 +834,64 @@ void viewport_render(
 #endif
 }
 
-static void record_session(const paint_session* session, std::vector<paint_session>* recorded_sessions, size_t record_index)
+// Returns the index of the entry plus one, so nullptr can be told apart from the first entry.
+static paint_struct* record_session_entry_index(const paint_session* session, const paint_struct* ps)
+{
+    if (ps == nullptr)
+        return nullptr;
+
+    size_t chunkStart = 0;
+    for (auto chunk = session->FirstPaintEntryChunk; chunk != nullptr; chunk = chunk->Next)
+    {
+        auto entry = reinterpret_cast<const paint_entry*>(ps);
+        if (entry >= chunk->Entries && entry < chunk->Entries + PAINT_ENTRY_CHUNK_SIZE)
+        {
+            return reinterpret_cast<paint_struct*>(chunkStart + (entry - chunk->Entries) + 1);
+        }
+        chunkStart += PAINT_ENTRY_CHUNK_SIZE;
+    }
+    return nullptr;
+}
+
+static void record_session(
+    const paint_session* session, std::vector<RecordedPaintSession>* recorded_sessions, size_t record_index)
 {
     // Perform a deep copy of the paint session, use relative offsets.
     // This is done to extract the session for benchmark.
     // Place the copied session at provided record_index, so the caller can decide which columns/paint sessions to copy; there
     // is no column information embedded in the session itself.
-    (*recorded_sessions)[record_index] = (*session);
-    paint_session* session_copy = &recorded_sessions->at(record_index);
+    auto& recorded = recorded_sessions->at(record_index);
+    recorded.Session = *session;
+    recorded.Session.FirstPaintEntryChunk = nullptr;
+    recorded.Session.CurrentPaintEntryChunk = nullptr;
+    recorded.Session.NextFreePaintStruct = nullptr;
+    recorded.Session.EndOfPaintStructArray = nullptr;
+    recorded.Session.TileCacheColumn = nullptr;
+    recorded.Session.TileCacheRoots = nullptr;
+
+    auto numEntries = paint_session_get_entry_count(session);
+    recorded.Entries.resize(numEntries);
+    size_t i = 0;
+    for (auto chunk = session->FirstPaintEntryChunk; chunk != nullptr && i < numEntries; chunk = chunk->Next)
+    {
+        auto numChunkEntries = std::min<size_t>(numEntries - i, PAINT_ENTRY_CHUNK_SIZE);
+        std::copy_n(chunk->Entries, numChunkEntries, recorded.Entries.begin() + i);
+        i += numChunkEntries;
+    }
 
-    // Mind the offset needs to be calculated against the original `session`, not `session_copy`
-    for (auto& ps : session_copy->PaintStructs)
+    // Mind the offset needs to be calculated against the original `session`, not the copy
+    for (auto& ps : recorded.Entries)
     {
-        ps.basic.next_quadrant_ps = reinterpret_cast<paint_struct*>(
-            ps.basic.next_quadrant_ps ? int(ps.basic.next_quadrant_ps - &session->PaintStructs[0].basic)
-                                      : std::size(session->PaintStructs));
+        ps.basic.next_quadrant_ps = record_session_entry_index(session, ps.basic.next_quadrant_ps);
     }
-    for (auto& quad : session_copy->Quadrants)
+    for (auto& quad : recorded.Session.Quadrants)
     {
-        quad = reinterpret_cast<paint_struct*>(
-            quad ? int(quad - &session->PaintStructs[0].basic) : std::size(session->Quadrants));
+        quad = record_session_entry_index(session, quad);
     }
 }
 
-static void viewport_fill_column(paint_session* session, std::vector<paint_session>* recorded_sessions, size_t record_index)
+static void viewport_fill_column(
+    paint_session* session, std::vector<RecordedPaintSession>* recorded_sessions, size_t record_index)
 {
     paint_session_generate(session);
     if (recorded_sessions != nullptr)
@@ -887,13 +923,40 @@ static void viewport_paint_column(paint_session* session)
     {
         viewport_paint_weather_gloom(&session->DPI);
     }
+}
 
+/**
+ * Text drawing uses global font and palette state, so unlike the rest of a column it is never drawn in parallel.
+ */
+static void viewport_paint_column_text(paint_session* session)
+{
     if (session->PSStringHead != nullptr)
     {
         paint_draw_money_structs(&session->DPI, session->PSStringHead);
     }
+}
+
+template<typename TFn> static double viewport_measure_time(const TFn& fn)
+{
+    const auto startTime = std::chrono::high_resolution_clock::now();
+    fn();
+    const auto endTime = std::chrono::high_resolution_clock::now();
+    return std::chrono::duration<double>(endTime - startTime).count();
+}
+
+size_t viewport_get_paint_thread_count()
+{
+    return gConfigGeneral.multithreading ? GetTaskScheduler().GetThreadCount() + 1 : 1;
+}
+
+const ViewportPaintStats& viewport_get_paint_stats()
+{
+    return _paintStats;
+}
 
-    paint_session_free(session);
+void viewport_reset_paint_stats()
+{
+    _paintStats = {};
 }
 
 /**
@@ -908,7 +971,7 @@ static void viewport_paint_column(paint_session* session)
  */
 void viewport_paint(
     const rct_viewport* viewport, rct_drawpixelinfo* dpi, int16_t left, int16_t top, int16_t right, int16_t bottom,
-    std::vector<paint_session>* recorded_sessions)
+    std::vector<RecordedPaintSession>* recorded_sessions)
 {
     uint32_t viewFlags = viewport->flags;
     uint16_t width = right - left;
@@ -947,19 +1010,15 @@ void viewport_paint(
     const int16_t alignedX = floor2(dpi1.x, 32);
 
     std::vector<paint_session*> columns;
+    PaintTileCacheBeginPaint();
 
     bool useMultithreading = gConfigGeneral.multithreading;
-    if (useMultithreading && _paintJobs == nullptr)
-    {
-        _paintJobs = std::make_unique<JobPool>();
-    }
-    else if (useMultithreading == false && _paintJobs != nullptr)
-    {
-        _paintJobs.reset();
-    }
 
-    // Create space to record sessions and keep track which index is being drawn
-    size_t index = 0;
+    // The pixels of the columns do not overlap, but only some drawing engines can draw from several threads
+    bool useParallelDrawing = useMultithreading && dpi->DrawingEngine != nullptr
+        && (dpi->DrawingEngine->GetFlags() & DEF_PARALLEL_DRAWING);
+
+    // Create space to record sessions, they are recorded at the index of their column
     if (recorded_sessions != nullptr)
     {
         const uint16_t columnSize = rightBorder - alignedX;
@@ -968,7 +1027,7 @@ void viewport_paint(
     }
 
     // Splits the area into 32 pixel columns and renders them
-    for (x = alignedX; x < rightBorder; x += 32, index++)
+    for (x = alignedX; x < rightBorder; x += 32)
     {
         paint_session* session = paint_session_alloc(&dpi1, viewFlags);
         columns.push_back(session);
@@ -992,26 +1051,73 @@ void viewport_paint(
         }
         dpi2.width = paintRight - dpi2.x;
 
+        PaintTileCacheAttach(session);
+    }
+
+    std::vector<double> generateSeconds(columns.size());
+    std::vector<double> drawSeconds(columns.size());
+    auto generateColumn = [&columns, &generateSeconds, recorded_sessions](size_t i) {
+        generateSeconds[i] = viewport_measure_time([&]() { viewport_fill_column(columns[i], recorded_sessions, i); });
+    };
+    auto drawColumn = [&columns, &drawSeconds](size_t i) {
+        drawSeconds[i] += viewport_measure_time([&]() { viewport_paint_column(columns[i]); });
+    };
+    auto drawColumnText = [&columns, &drawSeconds](size_t i) {
+        drawSeconds[i] += viewport_measure_time([&]() { viewport_paint_column_text(columns[i]); });
+    };
+
+    _paintStats.Seconds += viewport_measure_time([&]() {
         if (useMultithreading)
         {
-            _paintJobs->AddTask(
-                [session, recorded_sessions, index]() -> void { viewport_fill_column(session, recorded_sessions, index); });
+            // A column is drawn as soon as its paint structs are arranged, while other columns may still be generated
+            TaskGraph graph;
+            for (size_t i = 0; i < columns.size(); i++)
+            {
+                auto generateTask = graph.Add([&generateColumn, i]() { generateColumn(i); });
+                if (useParallelDrawing)
+                {
+                    graph.Add([&drawColumn, i]() { drawColumn(i); }, { generateTask });
+                }
+            }
+            graph.Run(GetTaskScheduler());
         }
         else
         {
-            viewport_fill_column(session, recorded_sessions, index);
+            for (size_t i = 0; i < columns.size(); i++)
+            {
+                generateColumn(i);
+            }
+        }
+
+        if (!useParallelDrawing)
+        {
+            for (size_t i = 0; i < columns.size(); i++)
+            {
+                drawColumn(i);
+            }
         }
-    }
 
-    if (useMultithreading)
+        // Text is drawn over the finished columns
+        for (size_t i = 0; i < columns.size(); i++)
+        {
+            drawColumnText(i);
+        }
+    });
+    for (size_t i = 0; i < columns.size(); i++)
     {
-        _paintJobs->Join();
+        _paintStats.GenerateColumnSeconds += generateSeconds[i];
+        _paintStats.DrawColumnSeconds += drawSeconds[i];
     }
 
+    // Sessions go back to the painter on this thread, it does not lock its list of free sessions
     for (auto&& column : columns)
     {
-        viewport_paint_column(column);
+        PaintTileCacheDetach(column, _paintStats.TileCache);
+        paint_session_free(column);
     }
+
+    _paintStats.Paints++;
+    _paintStats.Columns += static_cast<uint32_t>(columns.size());
 }
 
 static void viewport_paint_weather_gloom(rct_drawpixelinfo* dpi)
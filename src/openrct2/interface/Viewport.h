@@ -10,6 +10,7 @@
 #ifndef _VIEWPORT_H_
 #define _VIEWPORT_H_
 
+#include "../paint/PaintTileCache.h"
 #include "../world/Location.hpp"
 #include "Window.h"
 
@@ -18,6 +19,7 @@
 
 struct paint_session;
 struct paint_struct;
+struct RecordedPaintSession;
 struct rct_drawpixelinfo;
 struct Peep;
 struct TileElement;
@@ -96,6 +98,20 @@ struct InteractionInfo
     ViewportInteractionItem SpriteType = VIEWPORT_INTERACTION_ITEM_NONE;
 };
 
+/**
+ * The time spent in viewport_paint. The column times are summed over all columns, so dividing them by the elapsed
+ * time gives the number of columns that were painted at the same time on average.
+ */
+struct ViewportPaintStats
+{
+    uint32_t Paints;
+    uint32_t Columns;
+    double Seconds;
+    double GenerateColumnSeconds;
+    double DrawColumnSeconds;
+    PaintTileCacheStats TileCache;
+};
+
 #define MAX_VIEWPORT_COUNT WINDOW_LIMIT_MAX
 
 /**
@@ -129,10 +145,13 @@ void viewport_update_smart_staff_follow(rct_window* window, Peep* peep);
 void viewport_update_smart_vehicle_follow(rct_window* window);
 void viewport_render(
     rct_drawpixelinfo* dpi, const rct_viewport* viewport, int32_t left, int32_t top, int32_t right, int32_t bottom,
-    std::vector<paint_session>* sessions = nullptr);
+    std::vector<RecordedPaintSession>* sessions = nullptr);
 void viewport_paint(
     const rct_viewport* viewport, rct_drawpixelinfo* dpi, int16_t left, int16_t top, int16_t right, int16_t bottom,
-    std::vector<paint_session>* sessions = nullptr);
+    std::vector<RecordedPaintSession>* sessions = nullptr);
+size_t viewport_get_paint_thread_count();
+const ViewportPaintStats& viewport_get_paint_stats();
+void viewport_reset_paint_stats();
 
 CoordsXYZ viewport_adjust_for_map_height(const ScreenCoordsXY& startCoords);
 
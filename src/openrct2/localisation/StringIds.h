@@ -3891,6 +3891,8 @@ enum
     STR_CANT_RAISE_ELEMENT_HERE = 6388,
     STR_NO_CLEARANCE = 6389,
 
+    STR_NETWORK_COMPRESSION_SAVED = 6390,
+
     // Have to include resource strings (from scenarios and objects) for the time being now that language is partially working
     /* MAX_STR_COUNT = 32768 */ // MAX_STR_COUNT - upper limit for number of strings, not the current count strings
 };
@@ -25,6 +25,7 @@
 #include "../ui/WindowManager.h"
 #include "../util/SawyerCoding.h"
 #include "../world/Location.hpp"
+#include "../world/Map.h"
 #include "network.h"
 
 #include <algorithm>
@@ -34,7 +35,7 @@
 // This string specifies which version of network stream current build uses.
 // It is used for making sure only compatible builds get connected, even within
 // single OpenRCT2 version.
-#define NETWORK_STREAM_VERSION "0"
+#define NETWORK_STREAM_VERSION "5"
 #define NETWORK_STREAM_ID OPENRCT2_VERSION "-" NETWORK_STREAM_VERSION
 
 static Peep* _pickup_peep = nullptr;
@@ -64,6 +65,8 @@ static constexpr uint32_t CHUNK_SIZE = 1024 * 63;
 #    include "../object/ObjectManager.h"
 #    include "../object/ObjectRepository.h"
 #    include "../rct2/S6Exporter.h"
+#    include "NetworkMapResync.h"
+#    include "NetworkMapSnapshot.h"
 #    include "../scenario/Scenario.h"
 #    include "../util/Util.h"
 #    include "../world/Park.h"
@@ -156,6 +159,11 @@ bool NetworkBase::Init()
     ServerProviderName = std::string();
     ServerProviderEmail = std::string();
     ServerProviderWebsite = std::string();
+
+    if (_eventLoop == nullptr)
+    {
+        _eventLoop = CreateEventLoop();
+    }
     return true;
 }
 
@@ -191,6 +199,7 @@ void NetworkBase::Close()
         CloseConnection();
 
         client_connection_list.clear();
+        _eventLoop = nullptr;
         GameActions::ClearQueue();
         GameActions::ResumeQueue();
         player_list.clear();
@@ -198,6 +207,7 @@ void NetworkBase::Close()
         _serverTickData.clear();
         _pendingPlayerLists.clear();
         _pendingPlayerInfo.clear();
+        _mapResyncBase = nullptr;
 
         gfx_invalidate_screen();
 
@@ -498,6 +508,7 @@ void NetworkBase::Flush()
 
 void NetworkBase::UpdateServer()
 {
+    _serverUpdateCount++;
     for (auto& connection : client_connection_list)
     {
         // This can be called multiple times before the connection is removed.
@@ -511,6 +522,10 @@ void NetworkBase::UpdateServer()
         else
         {
             DecayCooldown(connection->Player);
+            if (connection->MapSnapshot != nullptr)
+            {
+                SendMapSnapshotPackets(*connection);
+            }
         }
     }
 
@@ -578,6 +593,10 @@ void NetworkBase::UpdateClient()
                 case SocketStatus::Connected:
                 {
                     status = NETWORK_STATUS_CONNECTED;
+                    if (_eventLoop != nullptr)
+                    {
+                        _serverConnection->UseEventLoop(*_eventLoop);
+                    }
                     _serverConnection->ResetLastPacketTime();
                     Client_Send_TOKEN();
                     char str_authenticating[256];
@@ -716,6 +735,8 @@ const char* NetworkBase::FormatChat(NetworkPlayer* fromplayer, const char* text)
 
 void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, bool gameCmd)
 {
+    // Every client gets the same buffer, the packet is only serialised once
+    auto outbound = NetworkOutboundPacket::Create(packet);
     for (auto& client_connection : client_connection_list)
     {
         if (client_connection->IsDisconnected)
@@ -735,8 +756,7 @@ void NetworkBase::SendPacketToClients(const NetworkPacket& packet, bool front, b
                 continue;
             }
         }
-        auto packetCopy = packet;
-        client_connection->QueuePacket(std::move(packetCopy), front);
+        client_connection->QueuePacket(outbound, front);
     }
 }
 
@@ -1223,6 +1243,8 @@ void NetworkBase::Client_Send_AUTH(
     assert(signature.size() <= static_cast<size_t>(UINT32_MAX));
     packet << static_cast<uint32_t>(signature.size());
     packet.Write(signature.data(), signature.size());
+    // Tell the server this client reads compressed packets
+    packet << static_cast<uint8_t>(1);
     _serverConnection->AuthStatus = NetworkAuth::Requested;
     _serverConnection->QueuePacket(std::move(packet));
 }
@@ -1237,6 +1259,14 @@ void NetworkBase::Client_Send_MAPREQUEST(const std::vector<std::string>& objects
         log_verbose("client requests object %s", object.c_str());
         packet.Write(reinterpret_cast<const uint8_t*>(object.c_str()), 8);
     }
+
+    // Only what changed is needed if this client still has the map of the server, objects can only come with a full map
+    _mapResyncBase = objects.empty() ? ExportMapResyncBase() : nullptr;
+    packet << static_cast<uint8_t>(_mapResyncBase != nullptr);
+    if (_mapResyncBase != nullptr)
+    {
+        NetworkMapResyncRequest::Create(_mapResyncBase->GetData(), gCurrentTicks).Write(packet);
+    }
     _serverConnection->QueuePacket(std::move(packet));
 }
 
@@ -1338,6 +1368,8 @@ NetworkStats_t NetworkBase::GetStats() const
                 stats.bytesReceived[n] += connection->Stats.bytesReceived[n];
                 stats.bytesSent[n] += connection->Stats.bytesSent[n];
             }
+            stats.bytesSavedReceived += connection->Stats.bytesSavedReceived;
+            stats.bytesSavedSent += connection->Stats.bytesSavedSent;
         }
     }
     return stats;
@@ -1356,6 +1388,8 @@ void NetworkBase::Server_Send_AUTH(NetworkConnection& connection)
     {
         packet.WriteString(network_get_version().c_str());
     }
+    // Tell the client this server reads compressed packets
+    packet << static_cast<uint8_t>(1);
     connection.QueuePacket(std::move(packet));
     if (connection.AuthStatus != NetworkAuth::Ok && connection.AuthStatus != NetworkAuth::RequirePassword)
     {
@@ -1379,67 +1413,92 @@ void NetworkBase::Server_Send_MAP(NetworkConnection* connection)
         objects = objManager.GetPackableObjects();
     }
 
-    auto header = save_for_network(objects);
-    if (header.empty())
+    std::unique_ptr<NetworkMapResyncRequest> resyncRequest;
+    if (connection)
     {
-        if (connection)
+        resyncRequest = std::move(connection->MapResyncRequest);
+    }
+
+    // Clients that join during the same update get the same map, the game state can not change in between
+    std::shared_ptr<NetworkMapSnapshot> snapshot;
+    if (resyncRequest != nullptr && objects.empty())
+    {
+        snapshot = CreateMapSnapshot(objects, std::move(resyncRequest));
+    }
+    else if (connection)
+    {
+        snapshot = _lastMapSnapshot.lock();
+        if (snapshot != nullptr && (_lastMapSnapshotUpdate != _serverUpdateCount || snapshot->GetObjects() != objects))
         {
-            connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
-            connection->Socket->Disconnect();
+            snapshot = nullptr;
         }
-        return;
     }
-    size_t chunksize = CHUNK_SIZE;
-    for (size_t i = 0; i < header.size(); i += chunksize)
+    if (snapshot == nullptr)
     {
-        size_t datasize = std::min(chunksize, header.size() - i);
-        NetworkPacket packet(NetworkCommand::Map);
-        packet << static_cast<uint32_t>(header.size()) << static_cast<uint32_t>(i);
-        packet.Write(&header[i], datasize);
+        snapshot = CreateMapSnapshot(objects);
+        if (snapshot == nullptr)
+        {
+            if (connection)
+            {
+                connection->SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
+                connection->Socket->Disconnect();
+            }
+            return;
+        }
         if (connection)
         {
-            connection->QueuePacket(std::move(packet));
+            _lastMapSnapshot = snapshot;
+            _lastMapSnapshotUpdate = _serverUpdateCount;
         }
-        else
+    }
+
+    // The first packet goes out straight away, so clients only buffer what the server sends after the snapshot
+    if (connection)
+    {
+        connection->MapSnapshot = snapshot;
+        connection->MapSnapshotPacketsSent = 0;
+        SendMapSnapshotPackets(*connection);
+    }
+    else
+    {
+        for (auto& client_connection : client_connection_list)
         {
-            SendPacketToClients(packet);
+            if (!client_connection->IsDisconnected)
+            {
+                client_connection->MapSnapshot = snapshot;
+                client_connection->MapSnapshotPacketsSent = 0;
+                SendMapSnapshotPackets(*client_connection);
+            }
         }
     }
 }
 
-std::vector<uint8_t> NetworkBase::save_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const
+void NetworkBase::SendMapSnapshotPackets(NetworkConnection& connection)
 {
-    std::vector<uint8_t> header;
-    bool RLEState = gUseRLE;
-    gUseRLE = false;
-
-    auto ms = OpenRCT2::MemoryStream();
-    if (!SaveMap(&ms, objects))
+    auto snapshot = connection.MapSnapshot;
+    if (snapshot->HasFailed())
     {
-        log_warning("Failed to export map.");
-        return header;
+        connection.MapSnapshot = nullptr;
+        connection.SetLastDisconnectReason(STR_MULTIPLAYER_CONNECTION_CLOSED);
+        connection.Socket->Disconnect();
+        return;
     }
-    gUseRLE = RLEState;
 
-    const void* data = ms.GetData();
-    int32_t size = ms.GetLength();
-
-    auto compressed = util_zlib_deflate(static_cast<const uint8_t*>(data), size);
-    if (compressed != std::nullopt)
+    bool isLast = false;
+    while (!isLast)
     {
-        std::string headerString = "open2_sv6_zlib";
-        header.resize(headerString.size() + 1 + compressed->size());
-        std::memcpy(&header[0], headerString.c_str(), headerString.size() + 1);
-        std::memcpy(&header[headerString.size() + 1], compressed->data(), compressed->size());
-        log_verbose("Sending map of size %u bytes, compressed to %u bytes", size, headerString.size() + 1 + compressed->size());
+        auto packet = snapshot->GetPacket(connection.MapSnapshotPacketsSent, isLast);
+        if (packet == nullptr)
+        {
+            break;
+        }
+        connection.QueuePacket(std::move(packet));
+        connection.MapSnapshotPacketsSent++;
     }
-    else
+    if (isLast)
     {
-        log_warning("Failed to compress the data, falling back to non-compressed sv6.");
-        header.resize(size);
-        std::memcpy(header.data(), data, size);
+        connection.MapSnapshot = nullptr;
     }
-    return header;
 }
 
 void NetworkBase::Client_Send_CHAT(const char* text)
@@ -1461,12 +1520,13 @@ void NetworkBase::Server_Send_CHAT(const char* text, const std::vector<uint8_t>&
     }
     else
     {
+        auto outbound = NetworkOutboundPacket::Create(std::move(packet));
         for (auto playerId : playerIds)
         {
             auto conn = GetPlayerConnection(playerId);
             if (conn != nullptr && !conn->IsDisconnected)
             {
-                conn->QueuePacket(packet);
+                conn->QueuePacket(outbound);
             }
         }
     }
@@ -1948,6 +2008,10 @@ void NetworkBase::AddClient(std::unique_ptr<ITcpSocket>&& socket)
     // Store connection
     auto connection = std::make_unique<NetworkConnection>();
     connection->Socket = std::move(socket);
+    if (_eventLoop != nullptr)
+    {
+        connection->UseEventLoop(*_eventLoop);
+    }
 
     client_connection_list.push_back(std::move(connection));
 }
@@ -2221,8 +2285,13 @@ void NetworkBase::Client_Handle_AUTH(NetworkConnection& connection, NetworkPacke
     switch (connection.AuthStatus)
     {
         case NetworkAuth::Ok:
+        {
+            uint8_t acceptsCompression;
+            packet >> acceptsCompression;
+            connection.CompressionEnabled = acceptsCompression != 0;
             Client_Send_GAMEINFO();
             break;
+        }
         case NetworkAuth::BadName:
             connection.SetLastDisconnectReason(STR_MULTIPLAYER_BAD_PLAYER_NAME);
             connection.Socket->Disconnect();
@@ -2494,6 +2563,17 @@ void NetworkBase::Server_Handle_MAPREQUEST(NetworkConnection& connection, Networ
         }
     }
 
+    uint8_t hasResyncRequest{};
+    packet >> hasResyncRequest;
+    if (hasResyncRequest != 0)
+    {
+        auto request = std::make_unique<NetworkMapResyncRequest>();
+        if (request->Read(packet))
+        {
+            connection.MapResyncRequest = std::move(request);
+        }
+    }
+
     const char* player_name = static_cast<const char*>(connection.Player->Name.c_str());
     Server_Send_MAP(&connection);
     Server_Send_EVENT_PLAYER_JOINED(player_name);
@@ -2563,6 +2643,10 @@ void NetworkBase::Server_Handle_AUTH(NetworkConnection& connection, NetworkPacke
             }
         }
 
+        uint8_t acceptsCompression;
+        packet >> acceptsCompression;
+        connection.CompressionEnabled = acceptsCompression != 0;
+
         bool passwordless = false;
         if (connection.AuthStatus == NetworkAuth::Verified)
         {
@@ -2633,14 +2717,16 @@ void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connecti
         _serverTickData.clear();
         _clientMapLoaded = false;
     }
-    if (size > chunk_buffer.size())
+    // The size is 0 until the server has compressed the whole map
+    const uint32_t bufferSize = std::max<uint32_t>(size, offset + chunksize);
+    if (bufferSize > chunk_buffer.size())
     {
-        chunk_buffer.resize(size);
+        chunk_buffer.resize(bufferSize);
     }
     char str_downloading_map[256];
     uint32_t downloading_map_args[2] = {
         (offset + chunksize) / 1024,
-        size / 1024,
+        bufferSize / 1024,
     };
     format_string(str_downloading_map, 256, STR_MULTIPLAYER_DOWNLOADING_MAP, downloading_map_args);
 
@@ -2650,7 +2736,7 @@ void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connecti
     context_open_intent(&intent);
 
     std::memcpy(&chunk_buffer[offset], const_cast<void*>(static_cast<const void*>(packet.Read(chunksize))), chunksize);
-    if (offset + chunksize == size)
+    if (size != 0 && offset + chunksize == size)
     {
         // Allow queue processing of game actions again.
         GameActions::ResumeQueue();
@@ -2659,12 +2745,13 @@ void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connecti
         bool has_to_free = false;
         uint8_t* data = &chunk_buffer[0];
         size_t data_size = size;
-        // zlib-compressed
-        if (strcmp("open2_sv6_zlib", reinterpret_cast<char*>(&chunk_buffer[0])) == 0)
+        // zlib-compressed, either the whole map or what changed since this client last had it
+        const bool isResync = strcmp("open2_sv6_delta_zlib", reinterpret_cast<char*>(&chunk_buffer[0])) == 0;
+        if (isResync || strcmp("open2_sv6_zlib", reinterpret_cast<char*>(&chunk_buffer[0])) == 0)
         {
             log_verbose("Received zlib-compressed sv6 map");
             has_to_free = true;
-            size_t header_len = strlen("open2_sv6_zlib") + 1;
+            size_t header_len = strlen(isResync ? "open2_sv6_delta_zlib" : "open2_sv6_zlib") + 1;
             data = util_zlib_inflate(&chunk_buffer[header_len], size - header_len, &data_size);
             if (data == nullptr)
             {
@@ -2679,8 +2766,10 @@ void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connecti
         }
 
         auto ms = MemoryStream(data, data_size);
-        if (LoadMap(&ms))
+        if (isResync ? LoadMapResync(&ms) : LoadMap(&ms))
         {
+            _lastMapHost = _host;
+            _lastMapPort = _port;
             game_load_init();
             game_load_scripts();
             _serverState.tick = gCurrentTicks;
@@ -2713,6 +2802,52 @@ void NetworkBase::Client_Handle_MAP([[maybe_unused]] NetworkConnection& connecti
     }
 }
 
+bool NetworkBase::LoadMapResync(IStream* stream)
+{
+    // The delta is applied to the map this client reported, which is then loaded like any other map
+    auto base = std::move(_mapResyncBase);
+    if (base == nullptr || !NetworkMapResyncApplyDelta(*stream, base->GetData()))
+    {
+        log_warning("Failed to apply the map changes sent from server.");
+        return false;
+    }
+
+    auto ms = MemoryStream();
+    bool RLEState = gUseRLE;
+    gUseRLE = false;
+    base->SaveGame(&ms);
+    gUseRLE = RLEState;
+
+    // Followed by the data not in normal save files
+    std::vector<uint8_t> extraData(stream->GetLength() - stream->GetPosition());
+    stream->Read(extraData.data(), extraData.size());
+    ms.Write(extraData.data(), extraData.size());
+
+    ms.SetPosition(0);
+    return LoadMap(&ms);
+}
+
+std::unique_ptr<S6Exporter> NetworkBase::ExportMapResyncBase() const
+{
+    if (gScreenFlags != SCREEN_FLAGS_PLAYING || _lastMapHost != _host || _lastMapPort != _port)
+    {
+        return nullptr;
+    }
+
+    map_reorganise_elements();
+    try
+    {
+        auto s6exporter = std::make_unique<S6Exporter>();
+        s6exporter->Export();
+        return s6exporter;
+    }
+    catch (const std::exception&)
+    {
+        log_warning("Failed to export map for resync.");
+    }
+    return nullptr;
+}
+
 bool NetworkBase::LoadMap(IStream* stream)
 {
     bool result = false;
@@ -2758,6 +2893,7 @@ bool NetworkBase::LoadMap(IStream* stream)
         gCheatsDisableRideValueAging = stream->ReadValue<uint8_t>() != 0;
         gConfigGeneral.show_real_names_of_guests = stream->ReadValue<uint8_t>() != 0;
         gCheatsIgnoreResearchStatus = stream->ReadValue<uint8_t>() != 0;
+        MapSetTileElementLimit(stream->ReadValue<uint32_t>());
 
         gLastAutoSaveUpdate = AUTOSAVE_PAUSE;
         result = true;
@@ -2768,9 +2904,9 @@ bool NetworkBase::LoadMap(IStream* stream)
     return result;
 }
 
-bool NetworkBase::SaveMap(IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects) const
+std::shared_ptr<NetworkMapSnapshot> NetworkBase::CreateMapSnapshot(
+    const std::vector<const ObjectRepositoryItem*>& objects, std::unique_ptr<NetworkMapResyncRequest> resync) const
 {
-    bool result = false;
     map_reorganise_elements();
     viewport_set_saved_view();
     try
@@ -2778,9 +2914,10 @@ bool NetworkBase::SaveMap(IStream* stream, const std::vector<const ObjectReposit
         auto s6exporter = std::make_unique<S6Exporter>();
         s6exporter->ExportObjectsList = objects;
         s6exporter->Export();
-        s6exporter->SaveGame(stream);
 
         // Write other data not in normal save files
+        auto ms = OpenRCT2::MemoryStream();
+        auto stream = &ms;
         stream->WriteValue<uint32_t>(gGamePaused);
         stream->WriteValue<uint32_t>(_guestGenerationProbability);
         stream->WriteValue<uint32_t>(_suggestedGuestMaximum);
@@ -2807,13 +2944,18 @@ bool NetworkBase::SaveMap(IStream* stream, const std::vector<const ObjectReposit
         stream->WriteValue<uint8_t>(gCheatsDisableRideValueAging);
         stream->WriteValue<uint8_t>(gConfigGeneral.show_real_names_of_guests);
         stream->WriteValue<uint8_t>(gCheatsIgnoreResearchStatus);
+        stream->WriteValue<uint32_t>(static_cast<uint32_t>(MapGetTileElementLimit()));
 
-        result = true;
+        const auto* extraData = static_cast<const uint8_t*>(ms.GetData());
+        return std::make_shared<NetworkMapSnapshot>(
+            std::move(s6exporter), std::vector<uint8_t>(extraData, extraData + ms.GetLength()), CHUNK_SIZE,
+            std::move(resync));
     }
     catch (const std::exception&)
     {
+        log_warning("Failed to export map.");
     }
-    return result;
+    return nullptr;
 }
 
 void NetworkBase::Client_Handle_CHAT([[maybe_unused]] NetworkConnection& connection, NetworkPacket& packet)
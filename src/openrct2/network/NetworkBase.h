@@ -2,6 +2,7 @@
 
 #include "../actions/GameAction.h"
 #include "NetworkConnection.h"
+#include "NetworkEventLoop.h"
 #include "NetworkGroup.h"
 #include "NetworkPlayer.h"
 #include "NetworkServerAdvertiser.h"
@@ -12,6 +13,10 @@
 
 #ifndef DISABLE_NETWORK
 
+class NetworkMapSnapshot;
+class S6Exporter;
+struct NetworkMapResyncRequest;
+
 class NetworkBase
 {
 public:
@@ -68,8 +73,10 @@ public: // Server
     void RemovePlayer(std::unique_ptr<NetworkConnection>& connection);
     void UpdateServer();
     void ServerClientDisconnected(std::unique_ptr<NetworkConnection>& connection);
-    bool SaveMap(OpenRCT2::IStream* stream, const std::vector<const ObjectRepositoryItem*>& objects) const;
-    std::vector<uint8_t> save_for_network(const std::vector<const ObjectRepositoryItem*>& objects) const;
+    std::shared_ptr<NetworkMapSnapshot> CreateMapSnapshot(
+        const std::vector<const ObjectRepositoryItem*>& objects,
+        std::unique_ptr<NetworkMapResyncRequest> resync = nullptr) const;
+    void SendMapSnapshotPackets(NetworkConnection& connection);
     std::string MakePlayerNameUnique(const std::string& name);
 
     // Packet dispatchers.
@@ -121,6 +128,8 @@ public: // Client
     NetworkServerState_t GetServerState() const;
     void ServerClientDisconnected();
     bool LoadMap(OpenRCT2::IStream* stream);
+    bool LoadMapResync(OpenRCT2::IStream* stream);
+    std::unique_ptr<S6Exporter> ExportMapResyncBase() const;
     void UpdateClient();
 
     // Packet dispatchers.
@@ -174,6 +183,8 @@ private: // Common Data
     using CommandHandler = void (NetworkBase::*)(NetworkConnection& connection, NetworkPacket& packet);
 
     std::shared_ptr<OpenRCT2::IPlatformEnvironment> _env;
+    // Declared before the connections, which stop using it when they are destroyed.
+    std::unique_ptr<IEventLoop> _eventLoop;
     std::vector<uint8_t> chunk_buffer;
     std::ofstream _chat_log_fs;
     uint32_t _lastUpdateTime = 0;
@@ -192,6 +203,9 @@ private: // Server Data
     std::string _serverLogPath;
     std::string _serverLogFilenameFormat = "%Y%m%d-%H%M%S.txt";
     std::ofstream _server_log_fs;
+    std::weak_ptr<NetworkMapSnapshot> _lastMapSnapshot;
+    uint32_t _lastMapSnapshotUpdate = 0;
+    uint32_t _serverUpdateCount = 0;
     uint16_t listening_port = 0;
     bool _playerListInvalidated = false;
 
@@ -215,10 +229,12 @@ private: // Client Data
     std::map<uint32_t, ServerTickData_t> _serverTickData;
     std::vector<std::string> _missingObjects;
     std::string _host;
+    std::string _lastMapHost;
     std::string _chatLogPath;
     std::string _chatLogFilenameFormat = "%Y%m%d-%H%M%S.txt";
     std::string _password;
     OpenRCT2::MemoryStream _serverGameState;
+    std::unique_ptr<S6Exporter> _mapResyncBase;
     NetworkServerState_t _serverState;
     uint32_t _lastSentHeartbeat = 0;
     uint32_t last_ping_sent_time = 0;
@@ -227,6 +243,7 @@ private: // Client Data
     int32_t status = NETWORK_STATUS_NONE;
     uint8_t player_id = 0;
     uint16_t _port = 0;
+    uint16_t _lastMapPort = 0;
     SocketStatus _lastConnectStatus = SocketStatus::Closed;
     bool _requireReconnect = false;
     bool _clientMapLoaded = false;
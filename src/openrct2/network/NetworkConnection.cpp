@@ -14,11 +14,16 @@
 #    include "../core/String.hpp"
 #    include "../localisation/Localisation.h"
 #    include "../platform/platform.h"
+#    include "NetworkEventLoop.h"
+#    include "NetworkMapResync.h"
 #    include "Socket.h"
 #    include "network.h"
 
+#    include <array>
+
 constexpr size_t NETWORK_DISCONNECT_REASON_BUFFER_SIZE = 256;
 constexpr size_t NetworkBufferSize = 1024 * 64; // 64 KiB, maximum packet size.
+constexpr size_t MaxPacketsPerSend = 32;
 
 NetworkConnection::NetworkConnection()
 {
@@ -27,29 +32,75 @@ NetworkConnection::NetworkConnection()
 
 NetworkConnection::~NetworkConnection()
 {
+    if (_channel != nullptr)
+    {
+        _eventLoop->Remove(*_channel);
+    }
     delete[] _lastDisconnectReason;
 }
 
+void NetworkConnection::UseEventLoop(IEventLoop& eventLoop)
+{
+    _channel = eventLoop.Add(*Socket);
+    if (_channel != nullptr)
+    {
+        _eventLoop = &eventLoop;
+    }
+}
+
 NetworkReadPacket NetworkConnection::ReadPacket()
+{
+    NetworkReadPacket status;
+    if (_channel != nullptr)
+    {
+        // Check for the disconnect first, the packets received before it are all in the queue by then.
+        const bool isDisconnected = _channel->IsDisconnected;
+        if (_channel->InboundPackets.TryPop(InboundPacket))
+        {
+            status = NetworkReadPacket::Success;
+        }
+        else
+        {
+            status = isDisconnected ? NetworkReadPacket::Disconnected : NetworkReadPacket::NoData;
+        }
+    }
+    else
+    {
+        status = ReceivePacket(*Socket, InboundPacket);
+    }
+
+    if (status == NetworkReadPacket::Success)
+    {
+        // Received complete packet.
+        _lastPacketTime = platform_get_ticks();
+
+        const size_t size = sizeof(InboundPacket.Header) + InboundPacket.Data.size();
+        const size_t sizeSaved = size > InboundPacket.BytesTransferred ? size - InboundPacket.BytesTransferred : 0;
+        RecordPacketStats(InboundPacket.GetCommand(), InboundPacket.BytesTransferred, sizeSaved, false);
+    }
+    return status;
+}
+
+NetworkReadPacket NetworkConnection::ReceivePacket(ITcpSocket& socket, NetworkPacket& packet)
 {
     size_t bytesRead = 0;
 
     // Read packet header.
-    auto& header = InboundPacket.Header;
-    if (InboundPacket.BytesTransferred < sizeof(InboundPacket.Header))
+    auto& header = packet.Header;
+    if (packet.BytesTransferred < sizeof(packet.Header))
     {
-        const size_t missingLength = sizeof(header) - InboundPacket.BytesTransferred;
+        const size_t missingLength = sizeof(header) - packet.BytesTransferred;
 
-        uint8_t* buffer = reinterpret_cast<uint8_t*>(&InboundPacket.Header);
+        uint8_t* buffer = reinterpret_cast<uint8_t*>(&packet.Header);
 
-        NetworkReadPacket status = Socket->ReceiveData(buffer, missingLength, &bytesRead);
+        NetworkReadPacket status = socket.ReceiveData(buffer + packet.BytesTransferred, missingLength, &bytesRead);
         if (status != NetworkReadPacket::Success)
         {
             return status;
         }
 
-        InboundPacket.BytesTransferred += bytesRead;
-        if (InboundPacket.BytesTransferred < sizeof(InboundPacket.Header))
+        packet.BytesTransferred += bytesRead;
+        if (packet.BytesTransferred < sizeof(packet.Header))
         {
             // If still not enough data for header, keep waiting.
             return NetworkReadPacket::MoreData;
@@ -68,29 +119,29 @@ NetworkReadPacket NetworkConnection::ReadPacket()
 
     // Read packet body.
     {
-        const size_t missingLength = header.Size - (InboundPacket.BytesTransferred - sizeof(header));
+        const size_t missingLength = header.Size - (packet.BytesTransferred - sizeof(header));
 
         uint8_t buffer[NetworkBufferSize];
 
         if (missingLength > 0)
         {
-            NetworkReadPacket status = Socket->ReceiveData(buffer, std::min(missingLength, NetworkBufferSize), &bytesRead);
+            NetworkReadPacket status = socket.ReceiveData(buffer, std::min(missingLength, NetworkBufferSize), &bytesRead);
             if (status != NetworkReadPacket::Success)
             {
                 return status;
             }
 
-            InboundPacket.BytesTransferred += bytesRead;
-            InboundPacket.Write(buffer, bytesRead);
+            packet.BytesTransferred += bytesRead;
+            packet.Write(buffer, bytesRead);
         }
 
-        if (InboundPacket.Data.size() == header.Size)
+        if (packet.Data.size() == header.Size)
         {
-            // Received complete packet.
-            _lastPacketTime = platform_get_ticks();
-
-            RecordPacketStats(InboundPacket, false);
-
+            if (!packet.Decompress())
+            {
+                log_warning("Received invalid compressed packet.");
+                return NetworkReadPacket::Disconnected;
+            }
             return NetworkReadPacket::Success;
         }
     }
@@ -98,42 +149,15 @@ NetworkReadPacket NetworkConnection::ReadPacket()
     return NetworkReadPacket::MoreData;
 }
 
-bool NetworkConnection::SendPacket(NetworkPacket& packet)
+void NetworkConnection::QueuePacket(std::shared_ptr<const NetworkOutboundPacket> packet, bool front)
 {
-    auto header = packet.Header;
-
-    std::vector<uint8_t> buffer;
-    buffer.reserve(sizeof(header) + header.Size);
-
-    // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
-    // Previously the Id field was not part of the header rather part of the body.
-    header.Size += sizeof(header.Id);
-    header.Size = Convert::HostToNetwork(header.Size);
-    header.Id = ByteSwapBE(header.Id);
-
-    buffer.insert(buffer.end(), reinterpret_cast<uint8_t*>(&header), reinterpret_cast<uint8_t*>(&header) + sizeof(header));
-    buffer.insert(buffer.end(), packet.Data.begin(), packet.Data.end());
-
-    size_t bufferSize = buffer.size() - packet.BytesTransferred;
-    size_t sent = Socket->SendData(buffer.data() + packet.BytesTransferred, bufferSize);
-    if (sent > 0)
-    {
-        packet.BytesTransferred += sent;
-    }
-
-    bool sendComplete = packet.BytesTransferred == buffer.size();
-    if (sendComplete)
+    if (AuthStatus == NetworkAuth::Ok || !packet->RequiresAuth)
     {
-        RecordPacketStats(packet, true);
-    }
-    return sendComplete;
-}
+        if (CompressionEnabled && packet->Compressed != nullptr)
+        {
+            packet = packet->Compressed;
+        }
 
-void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
-{
-    if (AuthStatus == NetworkAuth::Ok || !packet.CommandRequiresAuth())
-    {
-        packet.Header.Size = static_cast<uint16_t>(packet.Data.size());
         if (front)
         {
             // If the first packet was already partially sent add new packet to second position
@@ -141,25 +165,100 @@ void NetworkConnection::QueuePacket(NetworkPacket&& packet, bool front)
             {
                 auto it = _outboundPackets.begin();
                 it++; // Second position
-                _outboundPackets.insert(it, std::move(packet));
+                _outboundPackets.insert(it, { std::move(packet) });
             }
             else
             {
-                _outboundPackets.push_front(std::move(packet));
+                _outboundPackets.push_front({ std::move(packet) });
             }
         }
         else
         {
-            _outboundPackets.push_back(std::move(packet));
+            _outboundPackets.push_back({ std::move(packet) });
         }
     }
 }
 
 void NetworkConnection::SendQueuedPackets()
 {
-    while (!_outboundPackets.empty() && SendPacket(_outboundPackets.front()))
+    if (_channel != nullptr)
+    {
+        // The I/O thread of the event loop sends the packets, the send is counted once they are handed to it
+        if (_outboundPackets.empty())
+        {
+            return;
+        }
+        for (auto& queued : _outboundPackets)
+        {
+            RecordPacketStats(queued.Packet->Command, queued.Packet->GetSize(), queued.Packet->BytesSaved, true);
+            _channel->OutboundPackets.Push(std::move(queued.Packet));
+        }
+        _outboundPackets.clear();
+        _eventLoop->Notify();
+        return;
+    }
+
+    SendPackets(*Socket, _outboundPackets, [this](const NetworkOutboundPacket& packet) {
+        RecordPacketStats(packet.Command, packet.GetSize(), packet.BytesSaved, true);
+    });
+}
+
+void NetworkConnection::SendPackets(
+    ITcpSocket& socket, std::deque<QueuedPacket>& packets, const std::function<void(const NetworkOutboundPacket&)>& onSent)
+{
+    while (!packets.empty())
     {
-        _outboundPackets.pop_front();
+        // Send the headers and data of as many packets as possible at once, straight from their shared buffers
+        std::array<NetworkBufferView, MaxPacketsPerSend * 2> buffers;
+        size_t numBuffers = 0;
+        size_t bytesQueued = 0;
+        for (auto it = packets.begin(); it != packets.end() && numBuffers < buffers.size(); it++)
+        {
+            const auto& packet = *it->Packet;
+            buffers[numBuffers++] = { &packet.Header, sizeof(packet.Header) };
+            buffers[numBuffers++] = { packet.Data.data(), packet.Data.size() };
+            bytesQueued += packet.GetSize();
+        }
+
+        const auto& front = packets.front();
+        if (front.BytesTransferred < sizeof(front.Packet->Header))
+        {
+            buffers[0].Data = reinterpret_cast<const uint8_t*>(buffers[0].Data) + front.BytesTransferred;
+            buffers[0].Size -= front.BytesTransferred;
+        }
+        else
+        {
+            auto dataOffset = front.BytesTransferred - sizeof(front.Packet->Header);
+            buffers[0].Size = 0;
+            buffers[1].Data = reinterpret_cast<const uint8_t*>(buffers[1].Data) + dataOffset;
+            buffers[1].Size -= dataOffset;
+        }
+        bytesQueued -= front.BytesTransferred;
+
+        size_t sent = socket.SendData(buffers.data(), numBuffers);
+        const bool sentAll = sent == bytesQueued;
+        while (sent > 0)
+        {
+            auto& packet = packets.front();
+            auto remaining = packet.Packet->GetSize() - packet.BytesTransferred;
+            if (sent < remaining)
+            {
+                packet.BytesTransferred += sent;
+                break;
+            }
+            sent -= remaining;
+            if (onSent)
+            {
+                onSent(*packet.Packet);
+            }
+            packets.pop_front();
+        }
+
+        if (!sentAll)
+        {
+            // The socket would block, the rest is sent on the next call
+            break;
+        }
     }
 }
 
@@ -207,12 +306,12 @@ void NetworkConnection::SetLastDisconnectReason(const rct_string_id string_id, v
     SetLastDisconnectReason(buffer);
 }
 
-void NetworkConnection::RecordPacketStats(const NetworkPacket& packet, bool sending)
+void NetworkConnection::RecordPacketStats(NetworkCommand command, size_t size, size_t sizeSaved, bool sending)
 {
-    uint32_t packetSize = static_cast<uint32_t>(packet.BytesTransferred);
+    uint32_t packetSize = static_cast<uint32_t>(size);
     NetworkStatisticsGroup trafficGroup;
 
-    switch (packet.GetCommand())
+    switch (command)
     {
         case NetworkCommand::GameAction:
             trafficGroup = NetworkStatisticsGroup::Commands;
@@ -229,11 +328,13 @@ void NetworkConnection::RecordPacketStats(const NetworkPacket& packet, bool send
     {
         Stats.bytesSent[EnumValue(trafficGroup)] += packetSize;
         Stats.bytesSent[EnumValue(NetworkStatisticsGroup::Total)] += packetSize;
+        Stats.bytesSavedSent += sizeSaved;
     }
     else
     {
         Stats.bytesReceived[EnumValue(trafficGroup)] += packetSize;
         Stats.bytesReceived[EnumValue(NetworkStatisticsGroup::Total)] += packetSize;
+        Stats.bytesSavedReceived += sizeSaved;
     }
 }
 
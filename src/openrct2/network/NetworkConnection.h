@@ -17,15 +17,26 @@
 #    include "Socket.h"
 
 #    include <deque>
+#    include <functional>
 #    include <memory>
 #    include <vector>
 
+class NetworkChannel;
+class NetworkMapSnapshot;
 class NetworkPlayer;
+struct IEventLoop;
+struct NetworkMapResyncRequest;
 struct ObjectRepositoryItem;
 
 class NetworkConnection final
 {
 public:
+    struct QueuedPacket
+    {
+        std::shared_ptr<const NetworkOutboundPacket> Packet;
+        size_t BytesTransferred = 0;
+    };
+
     std::unique_ptr<ITcpSocket> Socket = nullptr;
     NetworkPacket InboundPacket;
     NetworkAuth AuthStatus = NetworkAuth::None;
@@ -35,17 +46,31 @@ public:
     NetworkKey Key;
     std::vector<uint8_t> Challenge;
     std::vector<const ObjectRepositoryItem*> RequestedObjects;
+    std::shared_ptr<NetworkMapSnapshot> MapSnapshot;
+    size_t MapSnapshotPacketsSent = 0;
+    std::unique_ptr<NetworkMapResyncRequest> MapResyncRequest;
+    // Set once the other side said it can read compressed packets.
+    bool CompressionEnabled = false;
     bool IsDisconnected = false;
 
     NetworkConnection();
     ~NetworkConnection();
 
+    /**
+     * Hands the socket to the I/O thread of the event loop, packets are then exchanged with it instead of being read and
+     * sent on the calling thread. Keeps using the socket directly if the event loop cannot take it.
+     */
+    void UseEventLoop(IEventLoop& eventLoop);
+
     NetworkReadPacket ReadPacket();
-    void QueuePacket(NetworkPacket&& packet, bool front = false);
+    void QueuePacket(std::shared_ptr<const NetworkOutboundPacket> packet, bool front = false);
+    void QueuePacket(NetworkPacket&& packet, bool front = false)
+    {
+        return QueuePacket(NetworkOutboundPacket::Create(std::move(packet)), front);
+    }
     void QueuePacket(const NetworkPacket& packet, bool front = false)
     {
-        auto copy = packet;
-        return QueuePacket(std::move(copy), front);
+        return QueuePacket(NetworkOutboundPacket::Create(packet), front);
     }
 
     void SendQueuedPackets();
@@ -56,13 +81,21 @@ public:
     void SetLastDisconnectReason(const utf8* src);
     void SetLastDisconnectReason(const rct_string_id string_id, void* args = nullptr);
 
+    // Reads as much of the packet as the socket has without blocking, returns Success once the packet is complete.
+    static NetworkReadPacket ReceivePacket(ITcpSocket& socket, NetworkPacket& packet);
+    // Sends as much of the packets as the socket takes without blocking, onSent is called for each completed packet.
+    static void SendPackets(
+        ITcpSocket& socket, std::deque<QueuedPacket>& packets,
+        const std::function<void(const NetworkOutboundPacket&)>& onSent);
+
 private:
-    std::deque<NetworkPacket> _outboundPackets;
+    std::deque<QueuedPacket> _outboundPackets;
+    IEventLoop* _eventLoop = nullptr;
+    std::shared_ptr<NetworkChannel> _channel;
     uint32_t _lastPacketTime = 0;
     utf8* _lastDisconnectReason = nullptr;
 
-    void RecordPacketStats(const NetworkPacket& packet, bool sending);
-    bool SendPacket(NetworkPacket& packet);
+    void RecordPacketStats(NetworkCommand command, size_t size, size_t sizeSaved, bool sending);
 };
 
 #endif // DISABLE_NETWORK
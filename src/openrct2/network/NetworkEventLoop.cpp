@@ -0,0 +1,297 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifndef DISABLE_NETWORK
+
+#    include "NetworkEventLoop.h"
+
+#    ifdef __linux__
+
+#        include "NetworkConnection.h"
+
+#        include <cerrno>
+#        include <deque>
+#        include <mutex>
+#        include <stdexcept>
+#        include <thread>
+#        include <unordered_map>
+
+#        include <sys/epoll.h>
+#        include <sys/eventfd.h>
+#        include <unistd.h>
+
+// The number of socket events handled per wake up of the I/O thread.
+constexpr int32_t MaxEventsPerWait = 64;
+
+// The id of the event that wakes the I/O thread, channels are numbered from 1.
+constexpr uint64_t WakeEventId = 0;
+
+class EpollEventLoop final : public IEventLoop
+{
+private:
+    // What the I/O thread keeps for each socket.
+    struct Entry
+    {
+        std::shared_ptr<NetworkChannel> Channel;
+        ITcpSocket* Socket = nullptr;
+        NetworkPacket InboundPacket;
+        std::deque<NetworkConnection::QueuedPacket> OutboundPackets;
+        bool IsDisconnected = false;
+    };
+
+    int32_t _epoll = -1;
+    int32_t _wakeEvent = -1;
+
+    // Held by the I/O thread while it handles events, so sockets are not removed while they are in use.
+    std::mutex _mutex;
+    std::unordered_map<uint64_t, Entry> _entries;
+    uint64_t _nextId = WakeEventId + 1;
+
+    std::atomic_bool _stop{ false };
+    std::atomic_bool _wakePending{ false };
+    std::thread _thread;
+
+public:
+    EpollEventLoop()
+    {
+        _epoll = epoll_create1(EPOLL_CLOEXEC);
+        _wakeEvent = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = WakeEventId;
+        if (_epoll == -1 || _wakeEvent == -1 || epoll_ctl(_epoll, EPOLL_CTL_ADD, _wakeEvent, &event) != 0)
+        {
+            auto error = errno;
+            CloseHandles();
+            throw std::runtime_error("Failed to create epoll instance: " + std::to_string(error));
+        }
+        _thread = std::thread(&EpollEventLoop::Run, this);
+    }
+
+    ~EpollEventLoop() override
+    {
+        _stop = true;
+        Wake();
+        _thread.join();
+        CloseHandles();
+    }
+
+    std::shared_ptr<NetworkChannel> Add(ITcpSocket& socket) override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto id = _nextId++;
+        auto channel = std::make_shared<NetworkChannel>();
+        channel->Id = id;
+
+        // Edge triggered, the I/O thread reads and sends until the socket would block
+        epoll_event event{};
+        event.events = EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET;
+        event.data.u64 = id;
+        if (epoll_ctl(_epoll, EPOLL_CTL_ADD, static_cast<int32_t>(socket.GetHandle()), &event) != 0)
+        {
+            log_warning("Failed to add socket to epoll instance: %d", errno);
+            return nullptr;
+        }
+
+        auto& entry = _entries[id];
+        entry.Channel = channel;
+        entry.Socket = &socket;
+        return channel;
+    }
+
+    void Remove(NetworkChannel& channel) override
+    {
+        std::lock_guard<std::mutex> lock(_mutex);
+        auto it = _entries.find(channel.Id);
+        if (it != _entries.end())
+        {
+            epoll_ctl(_epoll, EPOLL_CTL_DEL, static_cast<int32_t>(it->second.Socket->GetHandle()), nullptr);
+            _entries.erase(it);
+        }
+    }
+
+    void Notify() override
+    {
+        // Only the first notification until the I/O thread wakes up needs a system call
+        if (!_wakePending.exchange(true))
+        {
+            Wake();
+        }
+    }
+
+private:
+    void Wake()
+    {
+        uint64_t value = 1;
+        if (write(_wakeEvent, &value, sizeof(value)) == -1 && errno != EAGAIN)
+        {
+            log_warning("Failed to wake network I/O thread: %d", errno);
+        }
+    }
+
+    void CloseHandles()
+    {
+        if (_wakeEvent != -1)
+        {
+            close(_wakeEvent);
+            _wakeEvent = -1;
+        }
+        if (_epoll != -1)
+        {
+            close(_epoll);
+            _epoll = -1;
+        }
+    }
+
+    void Run()
+    {
+        epoll_event events[MaxEventsPerWait];
+        while (!_stop)
+        {
+            int32_t numEvents = epoll_wait(_epoll, events, MaxEventsPerWait, -1);
+            if (numEvents == -1)
+            {
+                if (errno == EINTR)
+                    continue;
+
+                log_error("Failed to wait for network events: %d", errno);
+                std::lock_guard<std::mutex> lock(_mutex);
+                for (auto& it : _entries)
+                {
+                    it.second.Channel->IsDisconnected = true;
+                }
+                break;
+            }
+
+            std::lock_guard<std::mutex> lock(_mutex);
+            bool sendQueued = false;
+            for (int32_t i = 0; i < numEvents; i++)
+            {
+                const auto& event = events[i];
+                if (event.data.u64 == WakeEventId)
+                {
+                    uint64_t value;
+                    [[maybe_unused]] auto result = read(_wakeEvent, &value, sizeof(value));
+                    // Cleared before the queues are read, so packets queued from here on wake the thread again
+                    _wakePending = false;
+                    sendQueued = true;
+                    continue;
+                }
+
+                // The socket may have been removed after the events were taken
+                auto it = _entries.find(event.data.u64);
+                if (it == _entries.end())
+                    continue;
+
+                auto& entry = it->second;
+                if (event.events & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR))
+                {
+                    Receive(entry);
+                }
+                if (event.events & EPOLLOUT)
+                {
+                    Send(entry);
+                }
+            }
+
+            if (sendQueued)
+            {
+                for (auto& it : _entries)
+                {
+                    Send(it.second);
+                }
+            }
+        }
+    }
+
+    void Receive(Entry& entry)
+    {
+        if (entry.IsDisconnected)
+            return;
+
+        try
+        {
+            NetworkReadPacket status;
+            do
+            {
+                status = NetworkConnection::ReceivePacket(*entry.Socket, entry.InboundPacket);
+                if (status == NetworkReadPacket::Success)
+                {
+                    entry.Channel->InboundPackets.Push(std::move(entry.InboundPacket));
+                    entry.InboundPacket = NetworkPacket();
+                }
+            } while (status == NetworkReadPacket::Success || status == NetworkReadPacket::MoreData);
+
+            if (status == NetworkReadPacket::Disconnected)
+            {
+                SetDisconnected(entry);
+            }
+        }
+        catch (const std::exception& e)
+        {
+            log_verbose("Failed to receive data: %s", e.what());
+            SetDisconnected(entry);
+        }
+    }
+
+    void Send(Entry& entry)
+    {
+        std::shared_ptr<const NetworkOutboundPacket> packet;
+        while (entry.Channel->OutboundPackets.TryPop(packet))
+        {
+            entry.OutboundPackets.push_back({ std::move(packet) });
+        }
+        if (entry.IsDisconnected)
+        {
+            entry.OutboundPackets.clear();
+            return;
+        }
+
+        try
+        {
+            NetworkConnection::SendPackets(*entry.Socket, entry.OutboundPackets, nullptr);
+        }
+        catch (const std::exception& e)
+        {
+            log_verbose("Failed to send data: %s", e.what());
+            SetDisconnected(entry);
+        }
+    }
+
+    void SetDisconnected(Entry& entry)
+    {
+        entry.IsDisconnected = true;
+        entry.OutboundPackets.clear();
+        entry.Channel->IsDisconnected = true;
+    }
+};
+
+std::unique_ptr<IEventLoop> CreateEventLoop()
+{
+    try
+    {
+        return std::make_unique<EpollEventLoop>();
+    }
+    catch (const std::exception& e)
+    {
+        log_warning("%s", e.what());
+        return nullptr;
+    }
+}
+
+#    else
+
+std::unique_ptr<IEventLoop> CreateEventLoop()
+{
+    return nullptr;
+}
+
+#    endif // __linux__
+
+#endif // DISABLE_NETWORK
@@ -0,0 +1,69 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#ifndef DISABLE_NETWORK
+
+#    include "../common.h"
+#    include "../core/SpscQueue.h"
+#    include "NetworkPacket.h"
+#    include "Socket.h"
+
+#    include <atomic>
+#    include <memory>
+
+/**
+ * The packets a connection exchanges with the I/O thread of an event loop. The I/O thread only queues complete
+ * packets, the game thread never touches the socket while it is served by the loop.
+ */
+class NetworkChannel final
+{
+public:
+    // Set by the event loop, identifies the socket of the channel.
+    uint64_t Id = 0;
+    // Received by the I/O thread, taken by the game thread.
+    SpscQueue<NetworkPacket> InboundPackets;
+    // Queued by the game thread, sent by the I/O thread.
+    SpscQueue<std::shared_ptr<const NetworkOutboundPacket>> OutboundPackets;
+    // Set by the I/O thread once the socket is closed or failed, after the last packet it received was queued.
+    std::atomic_bool IsDisconnected{ false };
+};
+
+/**
+ * Waits for data on many sockets at once on a thread of its own, so the game thread does not read and send on every
+ * connection each update.
+ */
+struct IEventLoop
+{
+    virtual ~IEventLoop() = default;
+
+    /**
+     * Starts serving the socket on the I/O thread. Returns nullptr if the socket cannot be added, it then has to be
+     * served by the caller.
+     */
+    virtual std::shared_ptr<NetworkChannel> Add(ITcpSocket& socket) abstract;
+
+    /**
+     * Stops serving the socket of the channel, the I/O thread no longer uses it once this returns.
+     */
+    virtual void Remove(NetworkChannel& channel) abstract;
+
+    /**
+     * Wakes the I/O thread to send the packets queued on the channels.
+     */
+    virtual void Notify() abstract;
+};
+
+/**
+ * Returns nullptr if there is no event loop for the platform, connections are then served by the game thread.
+ */
+std::unique_ptr<IEventLoop> CreateEventLoop();
+
+#endif // DISABLE_NETWORK
@@ -0,0 +1,342 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifndef DISABLE_NETWORK
+
+#    include "NetworkMapResync.h"
+
+#    include "../core/IStream.hpp"
+#    include "../scenario/Scenario.h"
+#    include "../world/MapChangeJournal.h"
+#    include "NetworkPacket.h"
+
+#    include <algorithm>
+#    include <array>
+#    include <cstring>
+#    include <stdexcept>
+
+static constexpr size_t MAP_RESYNC_NUM_TILES = MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL;
+static constexpr size_t MAP_RESYNC_NUM_CHUNKS = MAP_CHUNKS_PER_SIDE * MAP_CHUNKS_PER_SIDE;
+
+// Entities are compared in groups to keep the request small, a moving guest changes a whole group either way.
+static constexpr size_t MAP_RESYNC_SPRITE_GROUP_SIZE = 4;
+static constexpr size_t MAP_RESYNC_NUM_SPRITE_GROUPS = (RCT2_MAX_SPRITES + MAP_RESYNC_SPRITE_GROUP_SIZE - 1)
+    / MAP_RESYNC_SPRITE_GROUP_SIZE;
+
+struct MapResyncRange
+{
+    size_t Offset;
+    size_t Length;
+};
+
+static void map_resync_hash(uint64_t& hash, const void* data, size_t length)
+{
+    // FNV-1a
+    const auto* bytes = static_cast<const uint8_t*>(data);
+    for (size_t i = 0; i < length; i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+// The parts of the data that are always sent as they are, which is everything but the tile elements and sprites.
+static std::array<MapResyncRange, 3> map_resync_get_other_ranges(const rct_s6_data& s6)
+{
+    const auto* base = reinterpret_cast<const uint8_t*>(&s6);
+    const size_t tileElements = reinterpret_cast<const uint8_t*>(s6.tile_elements) - base;
+    const size_t tileElementsEnd = tileElements + sizeof(s6.tile_elements);
+    const size_t sprites = reinterpret_cast<const uint8_t*>(s6.sprites) - base;
+    const size_t spritesEnd = sprites + sizeof(s6.sprites);
+    return { {
+        { 0, tileElements },
+        { tileElementsEnd, sprites - tileElementsEnd },
+        { spritesEnd, sizeof(rct_s6_data) - spritesEnd },
+    } };
+}
+
+/**
+ * Finds the first element of each tile, followed by the end of the last tile. Returns false if the tile elements are
+ * not valid.
+ */
+static bool map_resync_get_tile_starts(const rct_s6_data& s6, std::vector<uint32_t>& tileStarts)
+{
+    tileStarts.resize(MAP_RESYNC_NUM_TILES + 1);
+    uint32_t index = 0;
+    for (size_t tile = 0; tile < MAP_RESYNC_NUM_TILES; tile++)
+    {
+        tileStarts[tile] = index;
+        do
+        {
+            if (index >= RCT2_MAX_TILE_ELEMENTS)
+                return false;
+        } while (!s6.tile_elements[index++].IsLastForTile());
+    }
+    tileStarts[MAP_RESYNC_NUM_TILES] = index;
+    return true;
+}
+
+static size_t map_resync_get_chunk_of_tile(size_t tile)
+{
+    const auto x = tile % MAXIMUM_MAP_SIZE_TECHNICAL;
+    const auto y = tile / MAXIMUM_MAP_SIZE_TECHNICAL;
+    return ((y / MAP_CHUNK_SIZE) * MAP_CHUNKS_PER_SIDE) + (x / MAP_CHUNK_SIZE);
+}
+
+// Calls fn with each tile of the chunk, in the order the tiles are saved in.
+template<typename TFn> static void map_resync_for_each_tile_of_chunk(size_t chunk, TFn&& fn)
+{
+    const auto firstX = (chunk % MAP_CHUNKS_PER_SIDE) * MAP_CHUNK_SIZE;
+    const auto firstY = (chunk / MAP_CHUNKS_PER_SIDE) * MAP_CHUNK_SIZE;
+    for (size_t y = firstY; y < firstY + MAP_CHUNK_SIZE; y++)
+    {
+        for (size_t x = firstX; x < firstX + MAP_CHUNK_SIZE; x++)
+        {
+            fn((y * MAXIMUM_MAP_SIZE_TECHNICAL) + x);
+        }
+    }
+}
+
+static uint64_t map_resync_hash_chunk(const rct_s6_data& s6, const std::vector<uint32_t>& tileStarts, size_t chunk)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    map_resync_for_each_tile_of_chunk(chunk, [&](size_t tile) {
+        const auto numElements = tileStarts[tile + 1] - tileStarts[tile];
+        map_resync_hash(hash, &s6.tile_elements[tileStarts[tile]], numElements * sizeof(RCT12TileElement));
+    });
+    return hash;
+}
+
+static size_t map_resync_get_sprite_group_size(size_t group)
+{
+    return std::min(MAP_RESYNC_SPRITE_GROUP_SIZE, RCT2_MAX_SPRITES - (group * MAP_RESYNC_SPRITE_GROUP_SIZE));
+}
+
+static uint64_t map_resync_hash_sprite_group(const rct_s6_data& s6, size_t group)
+{
+    uint64_t hash = 14695981039346656037ULL;
+    map_resync_hash(
+        hash, &s6.sprites[group * MAP_RESYNC_SPRITE_GROUP_SIZE], map_resync_get_sprite_group_size(group) * sizeof(RCT2Sprite));
+    return hash;
+}
+
+NetworkMapResyncRequest NetworkMapResyncRequest::Create(const rct_s6_data& s6, uint32_t tick)
+{
+    NetworkMapResyncRequest request;
+    request.Tick = tick;
+
+    // Without valid tile elements no chunk is reported, the server then sends all of them
+    std::vector<uint32_t> tileStarts;
+    if (map_resync_get_tile_starts(s6, tileStarts))
+    {
+        request.ChunkHashes.resize(MAP_RESYNC_NUM_CHUNKS);
+        for (size_t chunk = 0; chunk < MAP_RESYNC_NUM_CHUNKS; chunk++)
+        {
+            request.ChunkHashes[chunk] = map_resync_hash_chunk(s6, tileStarts, chunk);
+        }
+    }
+
+    request.SpriteGroupHashes.resize(MAP_RESYNC_NUM_SPRITE_GROUPS);
+    for (size_t group = 0; group < MAP_RESYNC_NUM_SPRITE_GROUPS; group++)
+    {
+        request.SpriteGroupHashes[group] = map_resync_hash_sprite_group(s6, group);
+    }
+    return request;
+}
+
+void NetworkMapResyncRequest::Write(NetworkPacket& packet) const
+{
+    packet << Tick << static_cast<uint32_t>(ChunkHashes.size());
+    for (auto hash : ChunkHashes)
+    {
+        packet << hash;
+    }
+    packet << static_cast<uint32_t>(SpriteGroupHashes.size());
+    for (auto hash : SpriteGroupHashes)
+    {
+        packet << hash;
+    }
+}
+
+bool NetworkMapResyncRequest::Read(NetworkPacket& packet)
+{
+    uint32_t numChunkHashes{};
+    packet >> Tick >> numChunkHashes;
+    if (numChunkHashes != 0 && numChunkHashes != MAP_RESYNC_NUM_CHUNKS)
+        return false;
+
+    ChunkHashes.resize(numChunkHashes);
+    for (auto& hash : ChunkHashes)
+    {
+        packet >> hash;
+    }
+
+    uint32_t numSpriteGroupHashes{};
+    packet >> numSpriteGroupHashes;
+    if (numSpriteGroupHashes != 0 && numSpriteGroupHashes != MAP_RESYNC_NUM_SPRITE_GROUPS)
+        return false;
+
+    SpriteGroupHashes.resize(numSpriteGroupHashes);
+    for (auto& hash : SpriteGroupHashes)
+    {
+        packet >> hash;
+    }
+    return true;
+}
+
+void NetworkMapResyncWriteDelta(OpenRCT2::IStream& stream, const rct_s6_data& s6, const NetworkMapResyncRequest& request)
+{
+    const auto* data = reinterpret_cast<const uint8_t*>(&s6);
+    for (const auto& range : map_resync_get_other_ranges(s6))
+    {
+        stream.Write(data + range.Offset, range.Length);
+    }
+
+    std::vector<uint32_t> tileStarts;
+    if (!map_resync_get_tile_starts(s6, tileStarts))
+    {
+        throw std::runtime_error("Invalid tile elements.");
+    }
+
+    std::vector<uint32_t> changedChunks;
+    const bool hasChunkHashes = request.ChunkHashes.size() == MAP_RESYNC_NUM_CHUNKS;
+    for (size_t chunk = 0; chunk < MAP_RESYNC_NUM_CHUNKS; chunk++)
+    {
+        if (!hasChunkHashes || request.ChunkHashes[chunk] != map_resync_hash_chunk(s6, tileStarts, chunk))
+        {
+            changedChunks.push_back(static_cast<uint32_t>(chunk));
+        }
+    }
+
+    stream.WriteValue<uint32_t>(static_cast<uint32_t>(changedChunks.size()));
+    for (auto chunk : changedChunks)
+    {
+        uint32_t numElements = 0;
+        map_resync_for_each_tile_of_chunk(chunk, [&](size_t tile) { numElements += tileStarts[tile + 1] - tileStarts[tile]; });
+
+        stream.WriteValue<uint32_t>(chunk);
+        stream.WriteValue<uint32_t>(numElements);
+        map_resync_for_each_tile_of_chunk(chunk, [&](size_t tile) {
+            const auto numTileElements = tileStarts[tile + 1] - tileStarts[tile];
+            stream.Write(&s6.tile_elements[tileStarts[tile]], numTileElements * sizeof(RCT12TileElement));
+        });
+    }
+
+    std::vector<uint32_t> changedSpriteGroups;
+    const bool hasSpriteGroupHashes = request.SpriteGroupHashes.size() == MAP_RESYNC_NUM_SPRITE_GROUPS;
+    for (size_t group = 0; group < MAP_RESYNC_NUM_SPRITE_GROUPS; group++)
+    {
+        if (!hasSpriteGroupHashes || request.SpriteGroupHashes[group] != map_resync_hash_sprite_group(s6, group))
+        {
+            changedSpriteGroups.push_back(static_cast<uint32_t>(group));
+        }
+    }
+
+    stream.WriteValue<uint32_t>(static_cast<uint32_t>(changedSpriteGroups.size()));
+    for (auto group : changedSpriteGroups)
+    {
+        stream.WriteValue<uint32_t>(group);
+        stream.Write(
+            &s6.sprites[group * MAP_RESYNC_SPRITE_GROUP_SIZE], map_resync_get_sprite_group_size(group) * sizeof(RCT2Sprite));
+    }
+
+    log_verbose(
+        "Map resync from tick %u: %u of %u chunks and %u of %u entity groups changed", request.Tick,
+        static_cast<uint32_t>(changedChunks.size()), static_cast<uint32_t>(MAP_RESYNC_NUM_CHUNKS),
+        static_cast<uint32_t>(changedSpriteGroups.size()), static_cast<uint32_t>(MAP_RESYNC_NUM_SPRITE_GROUPS));
+}
+
+bool NetworkMapResyncApplyDelta(OpenRCT2::IStream& stream, rct_s6_data& s6)
+{
+    std::vector<uint32_t> tileStarts;
+    if (!map_resync_get_tile_starts(s6, tileStarts))
+        return false;
+
+    try
+    {
+        auto* data = reinterpret_cast<uint8_t*>(&s6);
+        for (const auto& range : map_resync_get_other_ranges(s6))
+        {
+            stream.Read(data + range.Offset, range.Length);
+        }
+
+        std::vector<std::vector<RCT12TileElement>> chunkElements(MAP_RESYNC_NUM_CHUNKS);
+        std::vector<bool> chunkChanged(MAP_RESYNC_NUM_CHUNKS);
+        auto numChangedChunks = stream.ReadValue<uint32_t>();
+        if (numChangedChunks > MAP_RESYNC_NUM_CHUNKS)
+            return false;
+
+        for (uint32_t i = 0; i < numChangedChunks; i++)
+        {
+            auto chunk = stream.ReadValue<uint32_t>();
+            auto numElements = stream.ReadValue<uint32_t>();
+            if (chunk >= MAP_RESYNC_NUM_CHUNKS || numElements > RCT2_MAX_TILE_ELEMENTS)
+                return false;
+
+            chunkElements[chunk].resize(numElements);
+            stream.Read(chunkElements[chunk].data(), numElements * sizeof(RCT12TileElement));
+            chunkChanged[chunk] = true;
+        }
+
+        // Put the tile elements back together in map order, with the tiles of changed chunks from the server
+        std::vector<RCT12TileElement> tileElements(RCT2_MAX_TILE_ELEMENTS);
+        std::vector<size_t> chunkPositions(MAP_RESYNC_NUM_CHUNKS);
+        size_t numElements = 0;
+        for (size_t tile = 0; tile < MAP_RESYNC_NUM_TILES; tile++)
+        {
+            const RCT12TileElement* src = &s6.tile_elements[tileStarts[tile]];
+            size_t numTileElements = tileStarts[tile + 1] - tileStarts[tile];
+
+            const auto chunk = map_resync_get_chunk_of_tile(tile);
+            if (chunkChanged[chunk])
+            {
+                const auto& elements = chunkElements[chunk];
+                auto& position = chunkPositions[chunk];
+                auto end = position;
+                do
+                {
+                    if (end >= elements.size())
+                        return false;
+                } while (!elements[end++].IsLastForTile());
+
+                src = &elements[position];
+                numTileElements = end - position;
+                position = end;
+            }
+
+            if (numElements + numTileElements > RCT2_MAX_TILE_ELEMENTS)
+                return false;
+            std::memcpy(&tileElements[numElements], src, numTileElements * sizeof(RCT12TileElement));
+            numElements += numTileElements;
+        }
+        std::memcpy(s6.tile_elements, tileElements.data(), sizeof(s6.tile_elements));
+
+        auto numChangedSpriteGroups = stream.ReadValue<uint32_t>();
+        if (numChangedSpriteGroups > MAP_RESYNC_NUM_SPRITE_GROUPS)
+            return false;
+
+        for (uint32_t i = 0; i < numChangedSpriteGroups; i++)
+        {
+            auto group = stream.ReadValue<uint32_t>();
+            if (group >= MAP_RESYNC_NUM_SPRITE_GROUPS)
+                return false;
+
+            stream.Read(
+                &s6.sprites[group * MAP_RESYNC_SPRITE_GROUP_SIZE],
+                map_resync_get_sprite_group_size(group) * sizeof(RCT2Sprite));
+        }
+    }
+    catch (const std::exception&)
+    {
+        return false;
+    }
+    return true;
+}
+
+#endif
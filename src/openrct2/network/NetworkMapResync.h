@@ -0,0 +1,60 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#ifndef DISABLE_NETWORK
+
+#    include "../common.h"
+
+#    include <vector>
+
+namespace OpenRCT2
+{
+    struct IStream;
+}
+
+struct NetworkPacket;
+struct rct_s6_data;
+
+// A client that reconnects to the server it got its map from still holds that map, usually only seconds older than
+// the one on the server. Instead of the whole map the server then sends the tile element chunks and groups of entities
+// that differ from what the client has, together with the rest of the game state which is small in comparison.
+//
+// Both sides work on the exported .sv6 data with the tile elements in map order, so the client can load the result
+// like any other map.
+
+/**
+ * What the client reports about its map, the hashes of the exported tile elements of each chunk of the map and of
+ * each group of entities.
+ */
+struct NetworkMapResyncRequest
+{
+    uint32_t Tick = 0;
+    std::vector<uint64_t> ChunkHashes;
+    std::vector<uint64_t> SpriteGroupHashes;
+
+    static NetworkMapResyncRequest Create(const rct_s6_data& s6, uint32_t tick);
+
+    void Write(NetworkPacket& packet) const;
+    bool Read(NetworkPacket& packet);
+};
+
+/**
+ * Writes the differences of s6 to the map of the request. Throws if s6 has invalid tile elements.
+ */
+void NetworkMapResyncWriteDelta(OpenRCT2::IStream& stream, const rct_s6_data& s6, const NetworkMapResyncRequest& request);
+
+/**
+ * Applies a delta to s6, which has to be the data the request was created from. Returns false if the delta does not
+ * fit.
+ */
+bool NetworkMapResyncApplyDelta(OpenRCT2::IStream& stream, rct_s6_data& s6);
+
+#endif // DISABLE_NETWORK
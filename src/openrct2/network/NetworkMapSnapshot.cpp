@@ -0,0 +1,193 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#ifndef DISABLE_NETWORK
+
+#    include "NetworkMapSnapshot.h"
+
+#    include "../core/MemoryStream.h"
+#    include "../rct2/S6Exporter.h"
+#    include "../util/SawyerCoding.h"
+#    include "NetworkTypes.h"
+
+#    include <algorithm>
+#    include <cstring>
+#    include <stdexcept>
+#    include <zlib.h>
+
+// Tells clients how the map is sent, it is the start of the first packet.
+static constexpr const char MAP_SNAPSHOT_HEADER[] = "open2_sv6_zlib";
+static constexpr const char MAP_SNAPSHOT_RESYNC_HEADER[] = "open2_sv6_delta_zlib";
+
+// The amount of the saved map that is compressed before the output is handed to the main thread.
+static constexpr size_t MAP_SNAPSHOT_COMPRESS_STEP = 256 * 1024;
+
+NetworkMapSnapshot::NetworkMapSnapshot(
+    std::unique_ptr<S6Exporter> exporter, std::vector<uint8_t> extraData, size_t chunkSize,
+    std::unique_ptr<NetworkMapResyncRequest> resync)
+    : _exporter(std::move(exporter))
+    , _extraData(std::move(extraData))
+    , _objects(_exporter->ExportObjectsList)
+    , _resync(std::move(resync))
+    , _chunkSize(chunkSize)
+{
+    if (_resync != nullptr)
+    {
+        _data.assign(MAP_SNAPSHOT_RESYNC_HEADER, MAP_SNAPSHOT_RESYNC_HEADER + sizeof(MAP_SNAPSHOT_RESYNC_HEADER));
+    }
+    else
+    {
+        _data.assign(MAP_SNAPSHOT_HEADER, MAP_SNAPSHOT_HEADER + sizeof(MAP_SNAPSHOT_HEADER));
+    }
+    _headerSize = _data.size();
+    _worker = std::thread(&NetworkMapSnapshot::Save, this);
+}
+
+NetworkMapSnapshot::~NetworkMapSnapshot()
+{
+    _cancel = true;
+    if (_worker.joinable())
+    {
+        _worker.join();
+    }
+}
+
+bool NetworkMapSnapshot::HasFailed()
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    return _hasFailed;
+}
+
+std::shared_ptr<const NetworkOutboundPacket> NetworkMapSnapshot::GetPacket(size_t index, bool& isLast)
+{
+    std::lock_guard<std::mutex> lock(_mutex);
+    if (index < _packets.size())
+    {
+        isLast = _isComplete && GetPacketOffset(index + 1) >= _data.size();
+        return _packets[index];
+    }
+
+    isLast = false;
+    auto offset = GetPacketOffset(index);
+    auto end = GetPacketOffset(index + 1);
+    if (index != _packets.size() || offset >= _data.size())
+    {
+        return nullptr;
+    }
+
+    // A packet is only created once more data follows it, so the last packet is always created with the total size.
+    // The header is sent straight away, clients start buffering everything else the server sends from then on.
+    if (index != 0 && !_isComplete && _data.size() <= end)
+    {
+        return nullptr;
+    }
+
+    end = std::min(end, _data.size());
+    isLast = _isComplete && end == _data.size();
+
+    NetworkPacket packet(NetworkCommand::Map);
+    packet << static_cast<uint32_t>(_isComplete ? _data.size() : 0) << static_cast<uint32_t>(offset);
+    packet.Write(&_data[offset], end - offset);
+    _packets.push_back(NetworkOutboundPacket::Create(std::move(packet)));
+    return _packets.back();
+}
+
+void NetworkMapSnapshot::Save()
+{
+    // The map is saved without RLE, zlib compresses it a lot better on its own
+    gUseRLE = false;
+
+    z_stream strm{};
+    bool initialised = false;
+    try
+    {
+        auto ms = OpenRCT2::MemoryStream();
+        if (_resync != nullptr)
+        {
+            NetworkMapResyncWriteDelta(ms, _exporter->GetData(), *_resync);
+        }
+        else
+        {
+            _exporter->SaveGame(&ms);
+        }
+        ms.Write(_extraData.data(), _extraData.size());
+        _exporter = nullptr;
+
+        if (deflateInit(&strm, Z_DEFAULT_COMPRESSION) != Z_OK)
+        {
+            throw std::runtime_error("Failed to initialise zlib.");
+        }
+        initialised = true;
+
+        const auto* input = static_cast<const uint8_t*>(ms.GetData());
+        const size_t inputSize = ms.GetLength();
+        size_t inputOffset = 0;
+        std::vector<uint8_t> output(MAP_SNAPSHOT_COMPRESS_STEP);
+        int32_t ret = Z_OK;
+        while (ret != Z_STREAM_END)
+        {
+            if (_cancel)
+            {
+                deflateEnd(&strm);
+                return;
+            }
+
+            auto inputLength = std::min(inputSize - inputOffset, MAP_SNAPSHOT_COMPRESS_STEP);
+            strm.next_in = const_cast<Bytef*>(input + inputOffset);
+            strm.avail_in = static_cast<uInt>(inputLength);
+            inputOffset += inputLength;
+
+            const int32_t flush = inputOffset == inputSize ? Z_FINISH : Z_NO_FLUSH;
+            do
+            {
+                strm.next_out = output.data();
+                strm.avail_out = static_cast<uInt>(output.size());
+                ret = deflate(&strm, flush);
+                if (ret == Z_STREAM_ERROR)
+                {
+                    throw std::runtime_error("Failed to compress the map.");
+                }
+
+                auto outputLength = output.size() - strm.avail_out;
+                if (outputLength > 0)
+                {
+                    std::lock_guard<std::mutex> lock(_mutex);
+                    _data.insert(_data.end(), output.begin(), output.begin() + outputLength);
+                }
+            } while (strm.avail_out == 0);
+        }
+        deflateEnd(&strm);
+
+        std::lock_guard<std::mutex> lock(_mutex);
+        log_verbose("Sending map of size %u bytes, compressed to %u bytes", inputSize, _data.size());
+        _isComplete = true;
+    }
+    catch (const std::exception& e)
+    {
+        log_warning("Failed to export map: %s", e.what());
+        if (initialised)
+        {
+            deflateEnd(&strm);
+        }
+        std::lock_guard<std::mutex> lock(_mutex);
+        _hasFailed = true;
+    }
+}
+
+size_t NetworkMapSnapshot::GetPacketOffset(size_t index) const
+{
+    // The first packet only holds the header
+    if (index == 0)
+    {
+        return 0;
+    }
+    return _headerSize + ((index - 1) * _chunkSize);
+}
+
+#endif
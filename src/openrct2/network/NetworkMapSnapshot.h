@@ -0,0 +1,92 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#ifndef DISABLE_NETWORK
+
+#    include "../common.h"
+#    include "NetworkMapResync.h"
+#    include "NetworkPacket.h"
+
+#    include <atomic>
+#    include <memory>
+#    include <mutex>
+#    include <thread>
+#    include <vector>
+
+class S6Exporter;
+struct ObjectRepositoryItem;
+
+/**
+ * The map as it is sent to joining clients. The game state is exported on the main thread when the snapshot is
+ * created, saving and compressing it happens on a worker thread. The map packets are taken from the snapshot while the
+ * worker is still compressing, so the first of them are sent before the whole map is compressed. Each packet is only
+ * created once and shared by all connections the snapshot is sent to.
+ *
+ * The total size of the map is only known once the worker is done, packets created before that have a size of 0.
+ *
+ * A snapshot for a resync request only holds the differences to the map of that client, and is only sent to it.
+ */
+class NetworkMapSnapshot final
+{
+private:
+    std::unique_ptr<S6Exporter> _exporter;
+    std::vector<uint8_t> _extraData;
+    std::vector<const ObjectRepositoryItem*> _objects;
+    std::unique_ptr<NetworkMapResyncRequest> _resync;
+    size_t _chunkSize;
+    size_t _headerSize = 0;
+
+    std::mutex _mutex;
+    std::vector<uint8_t> _data;
+    bool _isComplete = false;
+    bool _hasFailed = false;
+
+    std::vector<std::shared_ptr<const NetworkOutboundPacket>> _packets;
+    std::atomic_bool _cancel{ false };
+    std::thread _worker;
+
+public:
+    /**
+     * Starts saving the game state the exporter holds, followed by extraData. The map is sent in packets of up to
+     * chunkSize bytes. With a resync request only the differences to the map of the client are saved.
+     */
+    NetworkMapSnapshot(
+        std::unique_ptr<S6Exporter> exporter, std::vector<uint8_t> extraData, size_t chunkSize,
+        std::unique_ptr<NetworkMapResyncRequest> resync = nullptr);
+    ~NetworkMapSnapshot();
+
+    NetworkMapSnapshot(const NetworkMapSnapshot&) = delete;
+    NetworkMapSnapshot& operator=(const NetworkMapSnapshot&) = delete;
+
+    const std::vector<const ObjectRepositoryItem*>& GetObjects() const
+    {
+        return _objects;
+    }
+
+    bool IsResync() const
+    {
+        return _resync != nullptr;
+    }
+
+    bool HasFailed();
+
+    /**
+     * Returns the map packet with the given index, or nullptr if its data is not compressed yet. Sets isLast when it is
+     * the final packet of the map.
+     */
+    std::shared_ptr<const NetworkOutboundPacket> GetPacket(size_t index, bool& isLast);
+
+private:
+    void Save();
+    size_t GetPacketOffset(size_t index) const;
+};
+
+#endif // DISABLE_NETWORK
@@ -12,8 +12,14 @@
 #    include "NetworkPacket.h"
 
 #    include "NetworkTypes.h"
+#    include "Socket.h"
 
+#    include <cstring>
 #    include <memory>
+#    include <zlib.h>
+
+// Packets with less data are sent as they are, compressing them saves too little to be worth the time.
+constexpr size_t NetworkCompressionThreshold = 1024;
 
 NetworkPacket::NetworkPacket(NetworkCommand id)
     : Header{ 0, id }
@@ -42,7 +48,37 @@ void NetworkPacket::Clear()
     Data.clear();
 }
 
-bool NetworkPacket::CommandRequiresAuth()
+bool NetworkPacket::Decompress()
+{
+    auto id = static_cast<uint32_t>(Header.Id);
+    if (!(id & NetworkPacketCompressedFlag))
+    {
+        return true;
+    }
+    Header.Id = static_cast<NetworkCommand>(id & ~NetworkPacketCompressedFlag);
+
+    // The data starts with its uncompressed size
+    uint16_t size;
+    if (Data.size() < sizeof(size))
+    {
+        return false;
+    }
+    std::memcpy(&size, Data.data(), sizeof(size));
+    size = ByteSwapBE(size);
+
+    std::vector<uint8_t> data(size);
+    uLongf dataSize = size;
+    if (uncompress(data.data(), &dataSize, &Data[sizeof(size)], static_cast<uLong>(Data.size() - sizeof(size))) != Z_OK
+        || dataSize != size)
+    {
+        return false;
+    }
+    Data = std::move(data);
+    Header.Size = size;
+    return true;
+}
+
+bool NetworkPacket::CommandRequiresAuth() const
 {
     switch (GetCommand())
     {
@@ -101,4 +137,68 @@ const utf8* NetworkPacket::ReadString()
     return str;
 }
 
+static std::shared_ptr<NetworkOutboundPacket> CreateOutboundPacket(
+    const NetworkPacket& packet, std::vector<uint8_t>&& data, uint32_t flags)
+{
+    auto outbound = std::make_shared<NetworkOutboundPacket>();
+    outbound->Command = packet.GetCommand();
+    outbound->RequiresAuth = packet.CommandRequiresAuth();
+    outbound->Data = std::move(data);
+
+    // NOTE: For compatibility reasons for the master server we need to add sizeof(Header.Id) to the size.
+    // Previously the Id field was not part of the header rather part of the body.
+    auto& header = outbound->Header;
+    header.Size = static_cast<uint16_t>(outbound->Data.size() + sizeof(header.Id));
+    header.Size = Convert::HostToNetwork(header.Size);
+    header.Id = ByteSwapBE(static_cast<NetworkCommand>(static_cast<uint32_t>(packet.GetCommand()) | flags));
+    return outbound;
+}
+
+static std::shared_ptr<const NetworkOutboundPacket> CreateCompressedPacket(const NetworkPacket& packet)
+{
+    // Map data is compressed as a whole already
+    if (packet.Data.size() < NetworkCompressionThreshold || packet.GetCommand() == NetworkCommand::Map)
+    {
+        return nullptr;
+    }
+
+    // The data starts with its uncompressed size, packets can not hold more than that anyway
+    uint16_t size = static_cast<uint16_t>(packet.Data.size());
+    std::vector<uint8_t> data(sizeof(size) + compressBound(static_cast<uLong>(size)));
+    uLongf compressedSize = static_cast<uLongf>(data.size() - sizeof(size));
+    if (compress2(&data[sizeof(size)], &compressedSize, packet.Data.data(), size, Z_BEST_SPEED) != Z_OK)
+    {
+        return nullptr;
+    }
+    if (sizeof(size) + compressedSize >= packet.Data.size())
+    {
+        return nullptr;
+    }
+
+    size = ByteSwapBE(size);
+    std::memcpy(data.data(), &size, sizeof(size));
+    data.resize(sizeof(size) + compressedSize);
+
+    auto compressed = CreateOutboundPacket(packet, std::move(data), NetworkPacketCompressedFlag);
+    compressed->BytesSaved = packet.Data.size() - compressed->Data.size();
+    return compressed;
+}
+
+std::shared_ptr<const NetworkOutboundPacket> NetworkOutboundPacket::Create(const NetworkPacket& packet)
+{
+    auto compressed = CreateCompressedPacket(packet);
+    auto data = packet.Data;
+    auto outbound = CreateOutboundPacket(packet, std::move(data), 0);
+    outbound->Compressed = std::move(compressed);
+    return outbound;
+}
+
+std::shared_ptr<const NetworkOutboundPacket> NetworkOutboundPacket::Create(NetworkPacket&& packet)
+{
+    auto compressed = CreateCompressedPacket(packet);
+    auto outbound = CreateOutboundPacket(packet, std::move(packet.Data), 0);
+    outbound->Compressed = std::move(compressed);
+    return outbound;
+}
+
 #endif
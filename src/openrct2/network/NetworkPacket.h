@@ -25,6 +25,9 @@ struct PacketHeader
 static_assert(sizeof(PacketHeader) == 6);
 #pragma pack(pop)
 
+// Set in the command of a packet header when the data of the packet is compressed.
+constexpr uint32_t NetworkPacketCompressedFlag = 0x80000000;
+
 struct NetworkPacket final
 {
     NetworkPacket() = default;
@@ -36,7 +39,10 @@ struct NetworkPacket final
     NetworkCommand GetCommand() const;
 
     void Clear();
-    bool CommandRequiresAuth();
+    bool CommandRequiresAuth() const;
+
+    // Restores the data of a received packet that was sent compressed. Returns false if the data is invalid.
+    bool Decompress();
 
     const uint8_t* Read(size_t size);
     const utf8* ReadString();
@@ -79,3 +85,29 @@ public:
     size_t BytesTransferred = 0;
     size_t BytesRead = 0;
 };
+
+/**
+ * A packet as it goes out on the socket, with its header in network byte order. It does not change once it is created,
+ * so a packet that is sent to several connections shares one buffer between all of them.
+ */
+struct NetworkOutboundPacket final
+{
+    NetworkCommand Command = NetworkCommand::Invalid;
+    bool RequiresAuth = true;
+    PacketHeader Header{};
+    std::vector<uint8_t> Data;
+    // The same packet with its data compressed, for connections that accept it. Only set for packets with enough data
+    // to be worth compressing.
+    std::shared_ptr<const NetworkOutboundPacket> Compressed;
+    // How many bytes less than the uncompressed packet this packet is.
+    size_t BytesSaved = 0;
+
+    static std::shared_ptr<const NetworkOutboundPacket> Create(const NetworkPacket& packet);
+    static std::shared_ptr<const NetworkOutboundPacket> Create(NetworkPacket&& packet);
+
+    // The number of bytes sent for the packet, including the header.
+    size_t GetSize() const
+    {
+        return sizeof(Header) + Data.size();
+    }
+};
@@ -145,4 +145,7 @@ struct NetworkStats_t
 {
     uint64_t bytesReceived[EnumValue(NetworkStatisticsGroup::Max)];
     uint64_t bytesSent[EnumValue(NetworkStatisticsGroup::Max)];
+    // The bytes compression kept off the wire.
+    uint64_t bytesSavedReceived;
+    uint64_t bytesSavedSent;
 };
@@ -9,6 +9,7 @@
 
 #ifndef DISABLE_NETWORK
 
+#    include <algorithm>
 #    include <atomic>
 #    include <chrono>
 #    include <cmath>
@@ -51,6 +52,7 @@
     #include <netinet/tcp.h>
     #include <sys/ioctl.h>
     #include <sys/socket.h>
+    #include <sys/uio.h>
     #include "../common.h"
     using SOCKET = int32_t;
     #define SOCKET_ERROR -1
@@ -70,6 +72,9 @@
 
 constexpr auto CONNECT_TIMEOUT = std::chrono::milliseconds(3000);
 
+// The number of buffers passed to the system in one gathered send, well below the limit of every platform.
+constexpr size_t MaxGatheredBuffers = 64;
+
 // RAII WSA initialisation needed for Windows
 #    ifdef _WIN32
 class WSA
@@ -566,6 +571,64 @@ public:
         return totalSent;
     }
 
+    size_t SendData(const NetworkBufferView* buffers, size_t count) override
+    {
+        if (_status != SocketStatus::Connected)
+        {
+            throw std::runtime_error("Socket not connected.");
+        }
+
+        size_t totalSent = 0;
+        size_t bufferOffset = 0;
+        while (count > 0)
+        {
+            // Skip what was sent already, the first buffer may have been sent in part
+            while (count > 0 && bufferOffset >= buffers->Size)
+            {
+                bufferOffset -= buffers->Size;
+                buffers++;
+                count--;
+            }
+            if (count == 0)
+                break;
+
+            const size_t numBuffers = std::min(count, MaxGatheredBuffers);
+#    ifdef _WIN32
+            WSABUF gathered[MaxGatheredBuffers];
+            for (size_t i = 0; i < numBuffers; i++)
+            {
+                const size_t offset = i == 0 ? bufferOffset : 0;
+                gathered[i].buf = static_cast<char*>(const_cast<void*>(buffers[i].Data)) + offset;
+                gathered[i].len = static_cast<ULONG>(buffers[i].Size - offset);
+            }
+            DWORD sentBytes = 0;
+            if (WSASend(_socket, gathered, static_cast<DWORD>(numBuffers), &sentBytes, 0, nullptr, nullptr) == SOCKET_ERROR)
+            {
+                return totalSent;
+            }
+#    else
+            iovec gathered[MaxGatheredBuffers];
+            for (size_t i = 0; i < numBuffers; i++)
+            {
+                const size_t offset = i == 0 ? bufferOffset : 0;
+                gathered[i].iov_base = static_cast<char*>(const_cast<void*>(buffers[i].Data)) + offset;
+                gathered[i].iov_len = buffers[i].Size - offset;
+            }
+            msghdr message{};
+            message.msg_iov = gathered;
+            message.msg_iovlen = numBuffers;
+            ssize_t sentBytes = sendmsg(_socket, &message, FLAG_NO_PIPE);
+            if (sentBytes == SOCKET_ERROR)
+            {
+                return totalSent;
+            }
+#    endif
+            totalSent += sentBytes;
+            bufferOffset += sentBytes;
+        }
+        return totalSent;
+    }
+
     NetworkReadPacket ReceiveData(void* buffer, size_t size, size_t* sizeReceived) override
     {
         if (_status != SocketStatus::Connected)
@@ -629,6 +692,11 @@ public:
         return _ipAddress;
     }
 
+    intptr_t GetHandle() const override
+    {
+        return static_cast<intptr_t>(_socket);
+    }
+
 private:
     explicit TcpSocket(SOCKET socket, const std::string& hostName, const std::string& ipAddress)
     {
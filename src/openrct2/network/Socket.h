@@ -33,6 +33,15 @@ enum class NetworkReadPacket : int32_t
     Disconnected
 };
 
+/**
+ * One part of the data of a gathered send.
+ */
+struct NetworkBufferView
+{
+    const void* Data;
+    size_t Size;
+};
+
 /**
  * Represents an address and port.
  */
@@ -57,6 +66,8 @@ public:
     virtual const char* GetError() const abstract;
     virtual const char* GetHostName() const abstract;
     virtual std::string GetIpAddress() const abstract;
+    // The native handle of the socket, for waiting on it together with other sockets.
+    virtual intptr_t GetHandle() const abstract;
 
     virtual void Listen(uint16_t port) abstract;
     virtual void Listen(const std::string& address, uint16_t port) abstract;
@@ -66,6 +77,8 @@ public:
     virtual void ConnectAsync(const std::string& address, uint16_t port) abstract;
 
     virtual size_t SendData(const void* buffer, size_t size) abstract;
+    // Sends the buffers one after another as if they were one, without copying them together first.
+    virtual size_t SendData(const NetworkBufferView* buffers, size_t count) abstract;
     virtual NetworkReadPacket ReceiveData(void* buffer, size_t size, size_t* sizeReceived) abstract;
 
     virtual void SetNoDelay(bool noDelay) abstract;
@@ -16,12 +16,14 @@
 #include "../localisation/Localisation.h"
 #include "../localisation/LocalisationService.h"
 #include "../paint/Painter.h"
+#include "PaintTileCache.h"
 #include "sprite/Paint.Sprite.h"
 #include "tile_element/Paint.TileElement.h"
 
 #include <algorithm>
 #include <array>
 #include <atomic>
+#include <vector>
 
 using namespace OpenRCT2;
 
@@ -56,15 +58,40 @@ static void paint_ps_image_with_bounding_boxes(
 static void paint_ps_image(rct_drawpixelinfo* dpi, paint_struct* ps, uint32_t imageId, int16_t x, int16_t y);
 static uint32_t paint_ps_colourify_image(uint32_t imageId, uint8_t spriteType, uint32_t viewFlags);
 
+// Makes sure NextFreePaintStruct points at a free entry, the session grows when its current chunk is full.
+static void paint_session_reserve_entry(paint_session* session)
+{
+    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
+    {
+        paint_session_grow(session);
+    }
+}
+
+paint_entry* paint_session_add_entry(paint_session* session)
+{
+    paint_session_reserve_entry(session);
+    return session->NextFreePaintStruct++;
+}
+
+void paint_session_add_ps_to_quadrant_index(paint_session* session, paint_struct* ps, uint32_t quadrantIndex)
+{
+    ps->quadrant_index = quadrantIndex;
+    ps->next_quadrant_ps = session->Quadrants[quadrantIndex];
+    session->Quadrants[quadrantIndex] = ps;
+
+    session->QuadrantBackIndex = std::min(session->QuadrantBackIndex, quadrantIndex);
+    session->QuadrantFrontIndex = std::max(session->QuadrantFrontIndex, quadrantIndex);
+
+    if (session->TileCacheRoots != nullptr)
+    {
+        session->TileCacheRoots->push_back(ps);
+    }
+}
+
 static void paint_session_add_ps_to_quadrant(paint_session* session, paint_struct* ps, int32_t positionHash)
 {
     uint32_t paintQuadrantIndex = std::clamp(positionHash / 32, 0, MAX_PAINT_QUADRANTS - 1);
-    ps->quadrant_index = paintQuadrantIndex;
-    ps->next_quadrant_ps = session->Quadrants[paintQuadrantIndex];
-    session->Quadrants[paintQuadrantIndex] = ps;
-
-    session->QuadrantBackIndex = std::min(session->QuadrantBackIndex, paintQuadrantIndex);
-    session->QuadrantFrontIndex = std::max(session->QuadrantFrontIndex, paintQuadrantIndex);
+    paint_session_add_ps_to_quadrant_index(session, ps, paintQuadrantIndex);
 }
 
 /**
@@ -73,8 +100,7 @@ static void paint_session_add_ps_to_quadrant(paint_session* session, paint_struc
 static paint_struct* sub_9819_c(
     paint_session* session, uint32_t image_id, const CoordsXYZ& offset, CoordsXYZ boundBoxSize, CoordsXYZ boundBoxOffset)
 {
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
-        return nullptr;
+    paint_session_reserve_entry(session);
     auto g1 = gfx_get_g1_element(image_id & 0x7FFFF);
     if (g1 == nullptr)
     {
@@ -155,6 +181,19 @@ static paint_struct* sub_9819_c(
     return ps;
 }
 
+// Paints the elements of a tile, or adds the paint structs of the tile from the tile cache when they are unchanged.
+static void paint_session_setup_tile(paint_session* session, int32_t x, int32_t y)
+{
+    if (session->TileCacheColumn != nullptr)
+    {
+        PaintTileCacheSetupTile(session, x, y);
+    }
+    else
+    {
+        tile_element_paint_setup(session, x, y);
+    }
+}
+
 /**
  *
  *  rct2: 0x0068B6C2
@@ -179,12 +218,12 @@ void paint_session_generate(paint_session* session)
 
             for (; num_vertical_quadrants > 0; --num_vertical_quadrants)
             {
-                tile_element_paint_setup(session, mapTile.x, mapTile.y);
+                paint_session_setup_tile(session, mapTile.x, mapTile.y);
                 sprite_paint_setup(session, mapTile.x, mapTile.y);
 
                 sprite_paint_setup(session, mapTile.x - 32, mapTile.y + 32);
 
-                tile_element_paint_setup(session, mapTile.x, mapTile.y + 32);
+                paint_session_setup_tile(session, mapTile.x, mapTile.y + 32);
                 sprite_paint_setup(session, mapTile.x, mapTile.y + 32);
 
                 mapTile.x += 32;
@@ -202,12 +241,12 @@ void paint_session_generate(paint_session* session)
 
             for (; num_vertical_quadrants > 0; --num_vertical_quadrants)
             {
-                tile_element_paint_setup(session, mapTile.x, mapTile.y);
+                paint_session_setup_tile(session, mapTile.x, mapTile.y);
                 sprite_paint_setup(session, mapTile.x, mapTile.y);
 
                 sprite_paint_setup(session, mapTile.x - 32, mapTile.y - 32);
 
-                tile_element_paint_setup(session, mapTile.x - 32, mapTile.y);
+                paint_session_setup_tile(session, mapTile.x - 32, mapTile.y);
                 sprite_paint_setup(session, mapTile.x - 32, mapTile.y);
 
                 mapTile.y += 32;
@@ -225,12 +264,12 @@ void paint_session_generate(paint_session* session)
 
             for (; num_vertical_quadrants > 0; --num_vertical_quadrants)
             {
-                tile_element_paint_setup(session, mapTile.x, mapTile.y);
+                paint_session_setup_tile(session, mapTile.x, mapTile.y);
                 sprite_paint_setup(session, mapTile.x, mapTile.y);
 
                 sprite_paint_setup(session, mapTile.x + 32, mapTile.y - 32);
 
-                tile_element_paint_setup(session, mapTile.x, mapTile.y - 32);
+                paint_session_setup_tile(session, mapTile.x, mapTile.y - 32);
                 sprite_paint_setup(session, mapTile.x, mapTile.y - 32);
 
                 mapTile.x -= 32;
@@ -249,12 +288,12 @@ void paint_session_generate(paint_session* session)
 
             for (; num_vertical_quadrants > 0; --num_vertical_quadrants)
             {
-                tile_element_paint_setup(session, mapTile.x, mapTile.y);
+                paint_session_setup_tile(session, mapTile.x, mapTile.y);
                 sprite_paint_setup(session, mapTile.x, mapTile.y);
 
                 sprite_paint_setup(session, mapTile.x + 32, mapTile.y + 32);
 
-                tile_element_paint_setup(session, mapTile.x + 32, mapTile.y);
+                paint_session_setup_tile(session, mapTile.x + 32, mapTile.y);
                 sprite_paint_setup(session, mapTile.x + 32, mapTile.y);
 
                 mapTile.y -= 32;
@@ -313,11 +352,25 @@ template<> bool check_bounding_box<3>(const paint_struct_bound_box& initialBBox,
     return false;
 }
 
+/**
+ * A paint struct of the quadrants that are being arranged. They are copied next to each other, so comparing the bounding
+ * boxes does not have to follow the list through the paint entry chunks.
+ */
+struct paint_arrange_entry
+{
+    paint_struct_bound_box Bounds;
+    uint8_t QuadrantFlags;
+    paint_struct* PS;
+};
+
+// Sessions are arranged on the paint threads, each needs its own buffers.
+static thread_local std::vector<paint_arrange_entry> _arrangeEntries;
+static thread_local std::vector<paint_arrange_entry> _arrangeMovedEntries;
+
 template<uint8_t _TRotation>
 static paint_struct* paint_arrange_structs_helper_rotation(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag)
 {
     paint_struct* ps;
-    paint_struct* ps_temp;
     do
     {
         ps = ps_next;
@@ -329,13 +382,14 @@ static paint_struct* paint_arrange_structs_helper_rotation(paint_struct* ps_next
     // Cache the last visited node so we don't have to walk the whole list again
     paint_struct* ps_cache = ps;
 
-    ps_temp = ps;
-    do
+    // Flag the structs of this quadrant and the next one. The structs before the first one flagged as bigger are the
+    // ones that get arranged.
+    auto& entries = _arrangeEntries;
+    entries.clear();
+    paint_struct* ps_end = nullptr;
+    bool isArranged = true;
+    for (ps = ps_cache->next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
     {
-        ps = ps->next_quadrant_ps;
-        if (ps == nullptr)
-            break;
-
         if (ps->quadrant_index > quadrantIndex + 1)
         {
             ps->quadrant_flags = PAINT_QUADRANT_FLAG_BIGGER;
@@ -348,55 +402,75 @@ static paint_struct* paint_arrange_structs_helper_rotation(paint_struct* ps_next
         {
             ps->quadrant_flags = flag | PAINT_QUADRANT_FLAG_IDENTICAL;
         }
-    } while (ps->quadrant_index <= quadrantIndex + 1);
-    ps = ps_temp;
 
-    while (true)
-    {
-        while (true)
+        if (isArranged && (ps->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER))
         {
-            ps_next = ps->next_quadrant_ps;
-            if (ps_next == nullptr)
-                return ps_cache;
-            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
-                return ps_cache;
-            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_IDENTICAL)
-                break;
-            ps = ps_next;
+            ps_end = ps;
+            isArranged = false;
         }
-
-        ps_next->quadrant_flags &= ~PAINT_QUADRANT_FLAG_IDENTICAL;
-        ps_temp = ps;
-
-        const paint_struct_bound_box& initialBBox = ps_next->bounds;
-
-        while (true)
+        else if (isArranged)
         {
-            ps = ps_next;
-            ps_next = ps_next->next_quadrant_ps;
-            if (ps_next == nullptr)
-                break;
-            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
-                break;
-            if (!(ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_NEXT))
-                continue;
+            entries.push_back({ ps->bounds, ps->quadrant_flags, ps });
+        }
 
-            const paint_struct_bound_box& currentBBox = ps_next->bounds;
+        if (ps->quadrant_index > quadrantIndex + 1)
+            break;
+    }
 
-            const bool compareResult = check_bounding_box<_TRotation>(initialBBox, currentBBox);
+    // Each identical struct in turn moves the next quadrant's structs in front of it before itself. The moved structs
+    // end up in reverse order of finding them, and are looked at again from their new position.
+    auto& movedEntries = _arrangeMovedEntries;
+    size_t searchStart = 0;
+    while (true)
+    {
+        auto it = std::find_if(entries.begin() + searchStart, entries.end(), [](const paint_arrange_entry& entry) {
+            return (entry.QuadrantFlags & PAINT_QUADRANT_FLAG_IDENTICAL) != 0;
+        });
+        if (it == entries.end())
+            break;
 
-            if (compareResult)
+        searchStart = it - entries.begin();
+        it->QuadrantFlags &= ~PAINT_QUADRANT_FLAG_IDENTICAL;
+        const paint_struct_bound_box initialBBox = it->Bounds;
+        auto isInFront = [&initialBBox](const paint_arrange_entry& entry) {
+            return (entry.QuadrantFlags & PAINT_QUADRANT_FLAG_NEXT)
+                && check_bounding_box<_TRotation>(initialBBox, entry.Bounds);
+        };
+
+        // Only start compacting the structs that stay once the first one to move is found
+        auto firstMoved = std::find_if(it + 1, entries.end(), isInFront);
+        if (firstMoved == entries.end())
+            continue;
+
+        movedEntries.clear();
+        auto keptEnd = firstMoved;
+        for (auto entry = firstMoved; entry != entries.end(); entry++)
+        {
+            if (isInFront(*entry))
             {
-                ps->next_quadrant_ps = ps_next->next_quadrant_ps;
-                paint_struct* ps_temp2 = ps_temp->next_quadrant_ps;
-                ps_temp->next_quadrant_ps = ps_next;
-                ps_next->next_quadrant_ps = ps_temp2;
-                ps_next = ps;
+                movedEntries.push_back(*entry);
+            }
+            else
+            {
+                *keptEnd++ = *entry;
             }
         }
 
-        ps = ps_temp;
+        std::move_backward(it, keptEnd, entries.end());
+        std::reverse_copy(movedEntries.begin(), movedEntries.end(), it);
     }
+
+    // Link the structs in their new order
+    ps = ps_cache;
+    for (const auto& entry : entries)
+    {
+        entry.PS->quadrant_flags = entry.QuadrantFlags;
+        ps->next_quadrant_ps = entry.PS;
+        ps = entry.PS;
+    }
+    ps->next_quadrant_ps = ps_end;
+
+    return ps_cache;
 }
 
 static paint_struct* paint_arrange_structs_helper(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag, uint8_t rotation)
@@ -691,6 +765,26 @@ void paint_session_free([[maybe_unused]] paint_session* session)
     GetContext()->GetPainter()->ReleaseSession(session);
 }
 
+void paint_session_grow(paint_session* session)
+{
+    GetContext()->GetPainter()->GrowSession(session);
+}
+
+size_t paint_session_get_entry_count(const paint_session* session)
+{
+    size_t count = 0;
+    for (auto chunk = session->FirstPaintEntryChunk; chunk != nullptr; chunk = chunk->Next)
+    {
+        if (chunk == session->CurrentPaintEntryChunk)
+        {
+            count += session->NextFreePaintStruct - chunk->Entries;
+            break;
+        }
+        count += PAINT_ENTRY_CHUNK_SIZE;
+    }
+    return count;
+}
+
 /**
  *  rct2: 0x006861AC, 0x00686337, 0x006864D0, 0x0068666B, 0x0098196C
  *
@@ -713,10 +807,7 @@ paint_struct* sub_98196C(
     session->LastRootPS = nullptr;
     session->UnkF1AD2C = nullptr;
 
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
-    {
-        return nullptr;
-    }
+    paint_session_reserve_entry(session);
 
     auto g1Element = gfx_get_g1_element(image_id & 0x7FFFF);
     if (g1Element == nullptr)
@@ -1006,10 +1097,7 @@ bool paint_attach_to_previous_attach(paint_session* session, uint32_t image_id,
         return paint_attach_to_previous_ps(session, image_id, x, y);
     }
 
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
-    {
-        return false;
-    }
+    paint_session_reserve_entry(session);
     attached_paint_struct* ps = &session->NextFreePaintStruct->attached;
     ps->image_id = image_id;
     ps->x = x;
@@ -1038,10 +1126,7 @@ bool paint_attach_to_previous_attach(paint_session* session, uint32_t image_id,
  */
 bool paint_attach_to_previous_ps(paint_session* session, uint32_t image_id, int16_t x, int16_t y)
 {
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
-    {
-        return false;
-    }
+    paint_session_reserve_entry(session);
     attached_paint_struct* ps = &session->NextFreePaintStruct->attached;
 
     ps->image_id = image_id;
@@ -1081,10 +1166,7 @@ void paint_floating_money_effect(
     paint_session* session, money32 amount, rct_string_id string_id, int16_t y, int16_t z, int8_t y_offsets[], int16_t offset_x,
     uint32_t rotation)
 {
-    if (session->NextFreePaintStruct >= session->EndOfPaintStructArray)
-    {
-        return;
-    }
+    paint_session_reserve_entry(session);
 
     paint_string_struct* ps = &session->NextFreePaintStruct->string;
     ps->string_id = string_id;
@@ -14,6 +14,9 @@
 #include "../interface/Colour.h"
 #include "../world/Location.hpp"
 
+#include <vector>
+
+struct PaintTileCacheColumn;
 struct TileElement;
 enum ViewportInteractionItem : uint8_t;
 
@@ -133,11 +136,23 @@ struct tunnel_entry
 
 #define MAX_PAINT_QUADRANTS 512
 #define TUNNEL_MAX_COUNT 65
+#define PAINT_ENTRY_CHUNK_SIZE 512
+
+/**
+ * Paint entries are bump allocated from chunks, a session takes another chunk from the painter when its current one
+ * is full. Chunks never move, so entries stay where they are while the session grows.
+ */
+struct paint_entry_chunk
+{
+    paint_entry_chunk* Next;
+    paint_entry Entries[PAINT_ENTRY_CHUNK_SIZE];
+};
 
 struct paint_session
 {
     rct_drawpixelinfo DPI;
-    paint_entry PaintStructs[4000];
+    paint_entry_chunk* FirstPaintEntryChunk;
+    paint_entry_chunk* CurrentPaintEntryChunk;
     paint_struct* Quadrants[MAX_PAINT_QUADRANTS];
     paint_struct PaintHead;
     uint32_t ViewFlags;
@@ -169,6 +184,20 @@ struct paint_session
     uint8_t Unk141E9DB;
     uint16_t WaterHeight;
     uint32_t TrackColours[4];
+    // The cached paint structs of the tiles of this column, nullptr when the tiles are always painted again.
+    PaintTileCacheColumn* TileCacheColumn;
+    // Collects the paint structs added to the quadrants while a tile is recorded for the tile cache.
+    std::vector<paint_struct*>* TileCacheRoots;
+};
+
+/**
+ * A copy of a generated session for the sprite sort benchmark. Entries holds the paint entries of all chunks in order,
+ * and the paint struct pointers of the session are replaced by their index in Entries plus one, 0 for nullptr.
+ */
+struct RecordedPaintSession
+{
+    paint_session Session;
+    std::vector<paint_entry> Entries;
 };
 
 extern paint_session gPaintSession;
@@ -226,6 +255,10 @@ void paint_floating_money_effect(
 
 paint_session* paint_session_alloc(rct_drawpixelinfo* dpi, uint32_t viewFlags);
 void paint_session_free(paint_session* session);
+void paint_session_grow(paint_session* session);
+size_t paint_session_get_entry_count(const paint_session* session);
+paint_entry* paint_session_add_entry(paint_session* session);
+void paint_session_add_ps_to_quadrant_index(paint_session* session, paint_struct* ps, uint32_t quadrantIndex);
 void paint_session_generate(paint_session* session);
 void paint_session_arrange(paint_session* session);
 void paint_draw_structs(paint_session* session);
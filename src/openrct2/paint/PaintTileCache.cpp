@@ -0,0 +1,786 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "PaintTileCache.h"
+
+#include "../Cheats.h"
+#include "../OpenRCT2.h"
+#include "../config/Config.h"
+#include "../drawing/LightFX.h"
+#include "../interface/Viewport.h"
+#include "../peep/Staff.h"
+#include "../ride/TrackDesign.h"
+#include "../world/Banner.h"
+#include "../world/Map.h"
+#include "../world/MapChangeJournal.h"
+#include "../world/Scenery.h"
+#include "../world/SmallScenery.h"
+#include "Paint.h"
+#include "VirtualFloor.h"
+#include "tile_element/Paint.TileElement.h"
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+#include <memory>
+#include <unordered_map>
+#include <vector>
+
+// Columns that were not painted for this many draws are dropped.
+static constexpr const uint32_t PAINT_TILE_CACHE_MAX_COLUMN_AGE = 64;
+// Above this number of cached entries, the columns that were painted least recently are dropped.
+static constexpr const size_t PAINT_TILE_CACHE_MAX_ENTRIES = 1 << 20;
+
+// Pointers between the cached entries of a tile are stored as the index of the entry plus one, 0 for nullptr. The
+// pointers the tile leaves in the session can also be left unchanged.
+static constexpr const uint32_t CACHED_POINTER_UNCHANGED = std::numeric_limits<uint32_t>::max();
+
+enum class CachedEntryKind : uint8_t
+{
+    Unused,
+    Basic,
+    Attached,
+};
+
+struct CachedEntry
+{
+    paint_entry Entry;
+    CachedEntryKind Kind;
+};
+
+// The state of the session that the elements of a tile can read before they set it.
+struct CachedTileInputs
+{
+    const TileElement* SurfaceElement;
+    const TileElement* PathElementOnSameHeight;
+    const TileElement* TrackElementOnSameHeight;
+    uint32_t TrackColours[4];
+    bool HasLastRootPS;
+    bool HasUnkF1AD2C;
+    bool HasWoodenSupportsPrependTo;
+
+    bool operator==(const CachedTileInputs& other) const
+    {
+        return SurfaceElement == other.SurfaceElement && PathElementOnSameHeight == other.PathElementOnSameHeight
+            && TrackElementOnSameHeight == other.TrackElementOnSameHeight
+            && std::equal(std::begin(TrackColours), std::end(TrackColours), std::begin(other.TrackColours))
+            && HasLastRootPS == other.HasLastRootPS && HasUnkF1AD2C == other.HasUnkF1AD2C
+            && HasWoodenSupportsPrependTo == other.HasWoodenSupportsPrependTo;
+    }
+};
+
+struct CachedTile
+{
+    int32_t X;
+    int32_t Y;
+    uint64_t Version;
+    bool IsRecorded;
+    bool IsCacheable;
+    CachedTileInputs Inputs;
+
+    // The state the tile leaves in the session for the sprites and tiles painted after it. Tunnels and support heights
+    // are only read while a tile is painted and set again by the next one.
+    const void* CurrentlyDrawnItem;
+    CoordsXY SpritePosition;
+    ViewportInteractionItem InteractionType;
+    CoordsXY MapPosition;
+    const TileElement* SurfaceElement;
+    TileElement* PathElementOnSameHeight;
+    TileElement* TrackElementOnSameHeight;
+    bool DidPassSurface;
+    uint32_t TrackColours[4];
+    uint32_t LastRootPS;
+    uint32_t UnkF1AD2C;
+    uint32_t WoodenSupportsPrependTo;
+
+    uint32_t EntryBegin;
+    uint32_t EntryCount;
+    uint32_t RootBegin;
+    uint32_t RootCount;
+};
+
+/**
+ * The tiles of one column in the order they are painted, which only depends on the key of the column. Only the
+ * session the column is attached to uses it while it is generated.
+ */
+struct PaintTileCacheColumn
+{
+    std::vector<CachedTile> Tiles;
+    std::vector<CachedEntry> Entries;
+    // The entries of each tile that were added to the quadrants, in the order they were added.
+    std::vector<uint32_t> Roots;
+    size_t NextTile = 0;
+    // Entries and roots of tiles that were recorded again, the column is compacted once they are the majority.
+    size_t UnusedEntries = 0;
+    size_t UnusedRoots = 0;
+    size_t CountedEntries = 0;
+    uint32_t LastDrawCount = 0;
+    uint64_t LastPaint = 0;
+    PaintTileCacheStats Stats{};
+};
+
+struct PaintTileCacheKey
+{
+    int32_t X;
+    int32_t Y;
+    int32_t Width;
+    int32_t Height;
+    int8_t ZoomLevel;
+    uint8_t Rotation;
+    uint32_t ViewFlags;
+
+    bool operator==(const PaintTileCacheKey& other) const
+    {
+        return X == other.X && Y == other.Y && Width == other.Width && Height == other.Height
+            && ZoomLevel == other.ZoomLevel && Rotation == other.Rotation && ViewFlags == other.ViewFlags;
+    }
+};
+
+struct PaintTileCacheKeyHash
+{
+    size_t operator()(const PaintTileCacheKey& key) const
+    {
+        size_t hash = std::hash<int32_t>()(key.X);
+        hash = (hash * 31) + std::hash<int32_t>()(key.Y);
+        hash = (hash * 31) + std::hash<int32_t>()(key.Width);
+        hash = (hash * 31) + std::hash<int32_t>()(key.Height);
+        hash = (hash * 31) + std::hash<int32_t>()((key.ZoomLevel << 8) | key.Rotation);
+        hash = (hash * 31) + std::hash<uint32_t>()(key.ViewFlags);
+        return hash;
+    }
+};
+
+// A run of the entries of a tile within one chunk of the session.
+struct RecordedEntrySpan
+{
+    const paint_entry* Begin;
+    const paint_entry* End;
+    uint32_t FirstIndex;
+};
+
+static std::unordered_map<PaintTileCacheKey, std::unique_ptr<PaintTileCacheColumn>, PaintTileCacheKeyHash> _columns;
+static uint64_t _globalStateHash;
+static bool _isInvalidated;
+static bool _isDisabled;
+static uint64_t _paintCount;
+static uint32_t _lastTrimDrawCount;
+static size_t _numCachedEntries;
+
+static thread_local std::vector<paint_struct*> _recordedRoots;
+static thread_local std::vector<RecordedEntrySpan> _recordedSpans;
+static thread_local std::vector<CachedEntryKind> _recordedKinds;
+static thread_local std::vector<paint_entry*> _replayedEntries;
+
+template<typename T> static void paint_tile_cache_hash(uint64_t& hash, const T& value)
+{
+    // FNV-1a
+    auto bytes = reinterpret_cast<const uint8_t*>(&value);
+    for (size_t i = 0; i < sizeof(T); i++)
+    {
+        hash ^= bytes[i];
+        hash *= 1099511628211ULL;
+    }
+}
+
+// Everything other than the map and the view that the painting of surfaces, paths and scenery depends on.
+static uint64_t paint_tile_cache_hash_global_state()
+{
+    uint64_t hash = 14695981039346656037ULL;
+    paint_tile_cache_hash(hash, gScreenFlags);
+    paint_tile_cache_hash(hash, gMapSelectFlags);
+    paint_tile_cache_hash(hash, gMapSelectType);
+    paint_tile_cache_hash(hash, gMapSelectPositionA.x);
+    paint_tile_cache_hash(hash, gMapSelectPositionA.y);
+    paint_tile_cache_hash(hash, gMapSelectPositionB.x);
+    paint_tile_cache_hash(hash, gMapSelectPositionB.y);
+    for (const auto& position : gMapSelectionTiles)
+    {
+        paint_tile_cache_hash(hash, position.x);
+        paint_tile_cache_hash(hash, position.y);
+    }
+    paint_tile_cache_hash(hash, gStaffDrawPatrolAreas);
+    paint_tile_cache_hash(hash, gCheatsSandboxMode);
+    paint_tile_cache_hash(hash, gTrackDesignSaveMode);
+    paint_tile_cache_hash(hash, gTrackDesignSaveRideIndex);
+    paint_tile_cache_hash(hash, gClipHeight);
+    paint_tile_cache_hash(hash, gClipSelectionA.x);
+    paint_tile_cache_hash(hash, gClipSelectionA.y);
+    paint_tile_cache_hash(hash, gClipSelectionB.x);
+    paint_tile_cache_hash(hash, gClipSelectionB.y);
+    paint_tile_cache_hash(hash, gPaintWidePathsAsGhost);
+    paint_tile_cache_hash(hash, gPaintBlockedTiles);
+    paint_tile_cache_hash(hash, gShowSupportSegmentHeights);
+    paint_tile_cache_hash(hash, gShowGridLinesRefCount);
+    paint_tile_cache_hash(hash, gShowLandRightsRefCount);
+    paint_tile_cache_hash(hash, gShowConstuctionRightsRefCount);
+    paint_tile_cache_hash(hash, gMapSizeUnits);
+    paint_tile_cache_hash(hash, gMapBaseZ);
+    for (const auto& spawn : gPeepSpawns)
+    {
+        paint_tile_cache_hash(hash, spawn.x);
+        paint_tile_cache_hash(hash, spawn.y);
+        paint_tile_cache_hash(hash, spawn.z);
+        paint_tile_cache_hash(hash, spawn.direction);
+    }
+    paint_tile_cache_hash(hash, gConfigGeneral.landscape_smoothing);
+    paint_tile_cache_hash(hash, get_height_marker_offset());
+    return hash;
+}
+
+static void paint_tile_cache_clear()
+{
+    _columns.clear();
+    _numCachedEntries = 0;
+}
+
+static void paint_tile_cache_erase_column(
+    std::unordered_map<PaintTileCacheKey, std::unique_ptr<PaintTileCacheColumn>, PaintTileCacheKeyHash>::iterator it)
+{
+    _numCachedEntries -= it->second->CountedEntries;
+    _columns.erase(it);
+}
+
+static void paint_tile_cache_trim()
+{
+    if (_lastTrimDrawCount != gCurrentDrawCount)
+    {
+        _lastTrimDrawCount = gCurrentDrawCount;
+        for (auto it = _columns.begin(); it != _columns.end();)
+        {
+            auto next = std::next(it);
+            if (gCurrentDrawCount - it->second->LastDrawCount > PAINT_TILE_CACHE_MAX_COLUMN_AGE)
+            {
+                paint_tile_cache_erase_column(it);
+            }
+            it = next;
+        }
+    }
+
+    if (_numCachedEntries > PAINT_TILE_CACHE_MAX_ENTRIES)
+    {
+        std::vector<std::pair<uint64_t, PaintTileCacheKey>> columnsByAge;
+        for (const auto& [key, column] : _columns)
+        {
+            columnsByAge.emplace_back(column->LastPaint, key);
+        }
+        std::sort(columnsByAge.begin(), columnsByAge.end(), [](const auto& a, const auto& b) { return a.first < b.first; });
+
+        // Leave some room, so this does not happen again on the next paint
+        for (const auto& [lastPaint, key] : columnsByAge)
+        {
+            if (_numCachedEntries <= PAINT_TILE_CACHE_MAX_ENTRIES * 3 / 4)
+                break;
+            paint_tile_cache_erase_column(_columns.find(key));
+        }
+    }
+}
+
+void PaintTileCacheInvalidate()
+{
+    _isInvalidated = true;
+}
+
+void PaintTileCacheBeginPaint()
+{
+    _paintCount++;
+
+    // The virtual floor and lights depend on more than the tile itself
+    _isDisabled = virtual_floor_is_enabled();
+#ifdef __ENABLE_LIGHTFX__
+    _isDisabled |= lightfx_is_available();
+#endif
+
+    const auto globalStateHash = paint_tile_cache_hash_global_state();
+    if (_isInvalidated || _isDisabled || globalStateHash != _globalStateHash)
+    {
+        paint_tile_cache_clear();
+        _globalStateHash = globalStateHash;
+        _isInvalidated = false;
+    }
+    paint_tile_cache_trim();
+}
+
+void PaintTileCacheAttach(paint_session* session)
+{
+    if (_isDisabled)
+        return;
+
+    // The rotation of the session is only set once it is generated
+    const auto& dpi = session->DPI;
+    const PaintTileCacheKey key = {
+        dpi.x, dpi.y, dpi.width, dpi.height, static_cast<int8_t>(dpi.zoom_level), get_current_rotation(), session->ViewFlags,
+    };
+    auto& column = _columns[key];
+    if (column == nullptr)
+    {
+        // Only columns that are painted a second time are recorded, a column painted once costs no more than before
+        column = std::make_unique<PaintTileCacheColumn>();
+        column->LastDrawCount = gCurrentDrawCount;
+        column->LastPaint = _paintCount;
+        return;
+    }
+
+    column->LastDrawCount = gCurrentDrawCount;
+    column->LastPaint = _paintCount;
+    column->NextTile = 0;
+    session->TileCacheColumn = column.get();
+}
+
+static void paint_tile_cache_compact(PaintTileCacheColumn& column)
+{
+    std::vector<CachedEntry> entries;
+    std::vector<uint32_t> roots;
+    entries.reserve(column.Entries.size() - column.UnusedEntries);
+    roots.reserve(column.Roots.size() - column.UnusedRoots);
+    for (auto& tile : column.Tiles)
+    {
+        auto entryBegin = column.Entries.begin() + tile.EntryBegin;
+        auto rootBegin = column.Roots.begin() + tile.RootBegin;
+        tile.EntryBegin = static_cast<uint32_t>(entries.size());
+        tile.RootBegin = static_cast<uint32_t>(roots.size());
+        entries.insert(entries.end(), entryBegin, entryBegin + tile.EntryCount);
+        roots.insert(roots.end(), rootBegin, rootBegin + tile.RootCount);
+    }
+    column.Entries = std::move(entries);
+    column.Roots = std::move(roots);
+    column.UnusedEntries = 0;
+    column.UnusedRoots = 0;
+}
+
+void PaintTileCacheDetach(paint_session* session, PaintTileCacheStats& stats)
+{
+    auto column = session->TileCacheColumn;
+    if (column == nullptr)
+        return;
+
+    session->TileCacheColumn = nullptr;
+    stats.CachedTiles += column->Stats.CachedTiles;
+    stats.RecordedTiles += column->Stats.RecordedTiles;
+    stats.UncachedTiles += column->Stats.UncachedTiles;
+    column->Stats = {};
+
+    if (column->UnusedEntries > column->Entries.size() / 2 || column->UnusedRoots > column->Roots.size() / 2)
+    {
+        paint_tile_cache_compact(*column);
+    }
+    _numCachedEntries -= column->CountedEntries;
+    column->CountedEntries = column->Entries.size();
+    _numCachedEntries += column->CountedEntries;
+}
+
+static uint64_t paint_tile_cache_get_tile_version(int32_t x, int32_t y)
+{
+    // The surface edges and supports of a tile depend on its neighbours
+    const auto tilePos = TileCoordsXY{ CoordsXY{ x, y } };
+    uint64_t version = 0;
+    for (int32_t offsetY = -1; offsetY <= 1; offsetY++)
+    {
+        for (int32_t offsetX = -1; offsetX <= 1; offsetX++)
+        {
+            version = std::max(
+                version, MapChangeJournalGetTileVersion({ tilePos.x + offsetX, tilePos.y + offsetY }));
+        }
+    }
+    return version;
+}
+
+static bool paint_tile_cache_is_element_cacheable(const TileElement* tileElement)
+{
+    switch (tileElement->GetType())
+    {
+        case TILE_ELEMENT_TYPE_SURFACE:
+            return true;
+        case TILE_ELEMENT_TYPE_PATH:
+            // Queues show the colours and the state of their ride
+            return !tileElement->AsPath()->IsQueue();
+        case TILE_ELEMENT_TYPE_SMALL_SCENERY:
+        {
+            auto sceneryEntry = tileElement->AsSmallScenery()->GetEntry();
+            return sceneryEntry == nullptr
+                || !scenery_small_entry_has_flag(
+                       sceneryEntry, SMALL_SCENERY_FLAG_ANIMATED | SMALL_SCENERY_FLAG_IS_CLOCK | SMALL_SCENERY_FLAG_SWAMP_GOO);
+        }
+        case TILE_ELEMENT_TYPE_WALL:
+        {
+            auto sceneryEntry = tileElement->AsWall()->GetEntry();
+            return sceneryEntry == nullptr
+                || (!(sceneryEntry->wall.flags & WALL_SCENERY_IS_DOOR)
+                    && !(sceneryEntry->wall.flags2 & WALL_SCENERY_2_ANIMATED)
+                    && sceneryEntry->wall.scrolling_mode == SCROLLING_MODE_NONE);
+        }
+        case TILE_ELEMENT_TYPE_LARGE_SCENERY:
+        {
+            auto sceneryEntry = tileElement->AsLargeScenery()->GetEntry();
+            return sceneryEntry == nullptr
+                || (!(sceneryEntry->large_scenery.flags & (LARGE_SCENERY_FLAG_3D_TEXT | LARGE_SCENERY_FLAG_ANIMATED))
+                    && sceneryEntry->large_scenery.scrolling_mode == SCROLLING_MODE_NONE);
+        }
+        default:
+            // Rides, entrances and banners change with the state of their ride or text, corrupt elements hide others
+            return false;
+    }
+}
+
+static bool paint_tile_cache_is_tile_cacheable(int32_t x, int32_t y)
+{
+    // Blank tiles and the arrow take the element of whatever was painted before them
+    if (x >= gMapSizeUnits || y >= gMapSizeUnits || x < 32 || y < 32)
+        return false;
+    if ((gMapSelectFlags & MAP_SELECT_FLAG_ENABLE_ARROW) && x == gMapSelectArrowPosition.x && y == gMapSelectArrowPosition.y)
+        return false;
+
+    const TileElement* tileElement = map_get_first_element_at({ x, y });
+    if (tileElement == nullptr)
+        return true;
+    do
+    {
+        if (!paint_tile_cache_is_element_cacheable(tileElement))
+            return false;
+    } while (!(tileElement++)->IsLastForTile());
+    return true;
+}
+
+static CachedTileInputs paint_tile_cache_get_inputs(const paint_session* session)
+{
+    CachedTileInputs inputs{};
+    inputs.SurfaceElement = session->SurfaceElement;
+    inputs.PathElementOnSameHeight = session->PathElementOnSameHeight;
+    inputs.TrackElementOnSameHeight = session->TrackElementOnSameHeight;
+    std::copy(std::begin(session->TrackColours), std::end(session->TrackColours), std::begin(inputs.TrackColours));
+    inputs.HasLastRootPS = session->LastRootPS != nullptr;
+    inputs.HasUnkF1AD2C = session->UnkF1AD2C != nullptr;
+    inputs.HasWoodenSupportsPrependTo = session->WoodenSupportsPrependTo != nullptr;
+    return inputs;
+}
+
+// Returns the index plus one of a recorded entry, or 0 when the pointer is not one of the entries of the tile.
+static uint32_t paint_tile_cache_find_entry(const void* ptr)
+{
+    auto entry = static_cast<const paint_entry*>(ptr);
+    for (const auto& span : _recordedSpans)
+    {
+        if (entry >= span.Begin && entry < span.End)
+        {
+            auto offset = reinterpret_cast<const uint8_t*>(entry) - reinterpret_cast<const uint8_t*>(span.Begin);
+            if (offset % sizeof(paint_entry) != 0)
+                return 0;
+            return span.FirstIndex + static_cast<uint32_t>(entry - span.Begin) + 1;
+        }
+    }
+    return 0;
+}
+
+// Encodes a pointer of a recorded entry, returns false when it points outside of the entries of the tile.
+static bool paint_tile_cache_encode(const void* ptr, uint32_t& encoded)
+{
+    encoded = ptr == nullptr ? 0 : paint_tile_cache_find_entry(ptr);
+    return ptr == nullptr || encoded != 0;
+}
+
+template<typename T> static T* paint_tile_cache_encoded_pointer(uint32_t encoded)
+{
+    return reinterpret_cast<T*>(static_cast<uintptr_t>(encoded));
+}
+
+static uint32_t paint_tile_cache_pointer_index(const void* encodedPointer)
+{
+    return static_cast<uint32_t>(reinterpret_cast<uintptr_t>(encodedPointer));
+}
+
+// Encodes a pointer the tile left in the session.
+static bool paint_tile_cache_encode_session_pointer(const void* before, const void* after, uint32_t& encoded)
+{
+    if (after == before)
+    {
+        encoded = CACHED_POINTER_UNCHANGED;
+        return true;
+    }
+    return paint_tile_cache_encode(after, encoded);
+}
+
+static const paint_entry* paint_tile_cache_get_recorded_entry(uint32_t index)
+{
+    for (const auto& span : _recordedSpans)
+    {
+        if (index < span.FirstIndex + static_cast<uint32_t>(span.End - span.Begin))
+            return &span.Begin[index - span.FirstIndex];
+    }
+    return nullptr;
+}
+
+// Marks a paint struct, its children and the structs attached to them, returns false when one of them is not an unused
+// entry of the tile.
+static bool paint_tile_cache_mark_basic(uint32_t encoded)
+{
+    while (encoded != 0)
+    {
+        if (_recordedKinds[encoded - 1] != CachedEntryKind::Unused)
+            return false;
+        _recordedKinds[encoded - 1] = CachedEntryKind::Basic;
+
+        const paint_struct* ps = &paint_tile_cache_get_recorded_entry(encoded - 1)->basic;
+        for (auto attached = ps->attached_ps; attached != nullptr; attached = attached->next)
+        {
+            auto attachedEncoded = paint_tile_cache_find_entry(attached);
+            if (attachedEncoded == 0 || _recordedKinds[attachedEncoded - 1] != CachedEntryKind::Unused)
+                return false;
+            _recordedKinds[attachedEncoded - 1] = CachedEntryKind::Attached;
+        }
+
+        if (ps->children == nullptr)
+            break;
+        encoded = paint_tile_cache_find_entry(ps->children);
+        if (encoded == 0)
+            return false;
+    }
+    return true;
+}
+
+// Copies the entries a tile added to the session into the column, returns false when the tile can not be cached.
+static bool paint_tile_cache_store_entries(
+    paint_session* session, PaintTileCacheColumn& column, CachedTile& tile, paint_entry_chunk* startChunk,
+    paint_entry* startEntry)
+{
+    _recordedSpans.clear();
+    uint32_t numEntries = 0;
+    for (auto chunk = startChunk;; chunk = chunk->Next)
+    {
+        const bool isLast = chunk == session->CurrentPaintEntryChunk;
+        const paint_entry* begin = chunk == startChunk ? startEntry : chunk->Entries;
+        const paint_entry* end = isLast ? session->NextFreePaintStruct : chunk->Entries + PAINT_ENTRY_CHUNK_SIZE;
+        _recordedSpans.push_back({ begin, end, numEntries });
+        numEntries += static_cast<uint32_t>(end - begin);
+        if (isLast)
+            break;
+    }
+
+    _recordedKinds.assign(numEntries, CachedEntryKind::Unused);
+    for (auto root : _recordedRoots)
+    {
+        auto encoded = paint_tile_cache_find_entry(root);
+        if (encoded == 0 || !paint_tile_cache_mark_basic(encoded))
+            return false;
+    }
+
+    const auto entryBegin = column.Entries.size();
+    for (const auto& span : _recordedSpans)
+    {
+        for (auto entry = span.Begin; entry < span.End; entry++)
+        {
+            const auto index = span.FirstIndex + static_cast<uint32_t>(entry - span.Begin);
+            auto& cachedEntry = column.Entries.emplace_back(CachedEntry{ *entry, _recordedKinds[index] });
+            uint32_t first = 0;
+            uint32_t second = 0;
+            bool isInside = true;
+            switch (cachedEntry.Kind)
+            {
+                case CachedEntryKind::Basic:
+                    isInside = paint_tile_cache_encode(entry->basic.attached_ps, first)
+                        && paint_tile_cache_encode(entry->basic.children, second);
+                    cachedEntry.Entry.basic.attached_ps = paint_tile_cache_encoded_pointer<attached_paint_struct>(first);
+                    cachedEntry.Entry.basic.children = paint_tile_cache_encoded_pointer<paint_struct>(second);
+                    cachedEntry.Entry.basic.next_quadrant_ps = nullptr;
+                    break;
+                case CachedEntryKind::Attached:
+                    isInside = paint_tile_cache_encode(entry->attached.next, first);
+                    cachedEntry.Entry.attached.next = paint_tile_cache_encoded_pointer<attached_paint_struct>(first);
+                    break;
+                case CachedEntryKind::Unused:
+                    break;
+            }
+            if (!isInside)
+            {
+                column.Entries.resize(entryBegin);
+                return false;
+            }
+        }
+    }
+
+    const auto rootBegin = column.Roots.size();
+    for (auto root : _recordedRoots)
+    {
+        column.Roots.push_back(paint_tile_cache_find_entry(root) - 1);
+    }
+
+    tile.EntryBegin = static_cast<uint32_t>(entryBegin);
+    tile.EntryCount = numEntries;
+    tile.RootBegin = static_cast<uint32_t>(rootBegin);
+    tile.RootCount = static_cast<uint32_t>(_recordedRoots.size());
+    return true;
+}
+
+// Paints a tile and records the entries it added, returns false when the tile can not be cached.
+static bool paint_tile_cache_record_tile(
+    paint_session* session, PaintTileCacheColumn& column, CachedTile& tile, int32_t x, int32_t y)
+{
+    // The entries painted before the tile that the tile can link to
+    paint_struct* lastRootPS = session->LastRootPS;
+    attached_paint_struct* unkF1AD2C = session->UnkF1AD2C;
+    paint_struct* woodenSupportsPrependTo = session->WoodenSupportsPrependTo;
+    const auto lastRootChildren = lastRootPS != nullptr ? lastRootPS->children : nullptr;
+    const auto lastRootAttached = lastRootPS != nullptr ? lastRootPS->attached_ps : nullptr;
+    const auto unkF1AD2CNext = unkF1AD2C != nullptr ? unkF1AD2C->next : nullptr;
+    const auto woodenSupportsChildren = woodenSupportsPrependTo != nullptr ? woodenSupportsPrependTo->children : nullptr;
+    const auto woodenSupportsAttached = woodenSupportsPrependTo != nullptr ? woodenSupportsPrependTo->attached_ps : nullptr;
+    const auto psStringHead = session->PSStringHead;
+    const auto lastPSString = session->LastPSString;
+
+    auto startChunk = session->CurrentPaintEntryChunk;
+    auto startEntry = session->NextFreePaintStruct;
+
+    _recordedRoots.clear();
+    session->TileCacheRoots = &_recordedRoots;
+    tile_element_paint_setup(session, x, y);
+    session->TileCacheRoots = nullptr;
+
+    if ((lastRootPS != nullptr && (lastRootPS->children != lastRootChildren || lastRootPS->attached_ps != lastRootAttached))
+        || (unkF1AD2C != nullptr && unkF1AD2C->next != unkF1AD2CNext)
+        || (woodenSupportsPrependTo != nullptr
+            && (woodenSupportsPrependTo->children != woodenSupportsChildren
+                || woodenSupportsPrependTo->attached_ps != woodenSupportsAttached))
+        || session->PSStringHead != psStringHead || session->LastPSString != lastPSString)
+    {
+        return false;
+    }
+
+    if (!paint_tile_cache_encode_session_pointer(lastRootPS, session->LastRootPS, tile.LastRootPS)
+        || !paint_tile_cache_encode_session_pointer(unkF1AD2C, session->UnkF1AD2C, tile.UnkF1AD2C)
+        || !paint_tile_cache_encode_session_pointer(
+            woodenSupportsPrependTo, session->WoodenSupportsPrependTo, tile.WoodenSupportsPrependTo))
+    {
+        return false;
+    }
+
+    if (!paint_tile_cache_store_entries(session, column, tile, startChunk, startEntry))
+        return false;
+
+    tile.CurrentlyDrawnItem = session->CurrentlyDrawnItem;
+    tile.SpritePosition = session->SpritePosition;
+    tile.InteractionType = session->InteractionType;
+    tile.MapPosition = session->MapPosition;
+    tile.SurfaceElement = session->SurfaceElement;
+    tile.PathElementOnSameHeight = session->PathElementOnSameHeight;
+    tile.TrackElementOnSameHeight = session->TrackElementOnSameHeight;
+    tile.DidPassSurface = session->DidPassSurface;
+    std::copy(std::begin(session->TrackColours), std::end(session->TrackColours), std::begin(tile.TrackColours));
+    return true;
+}
+
+template<typename T> static T* paint_tile_cache_decode(uint32_t encoded, T* unchanged, T paint_entry::*member)
+{
+    if (encoded == CACHED_POINTER_UNCHANGED)
+        return unchanged;
+    return encoded == 0 ? nullptr : &(_replayedEntries[encoded - 1]->*member);
+}
+
+static void paint_tile_cache_replay_tile(paint_session* session, const PaintTileCacheColumn& column, const CachedTile& tile)
+{
+    _replayedEntries.resize(tile.EntryCount);
+    for (uint32_t i = 0; i < tile.EntryCount; i++)
+    {
+        _replayedEntries[i] = paint_session_add_entry(session);
+        *_replayedEntries[i] = column.Entries[tile.EntryBegin + i].Entry;
+    }
+
+    for (uint32_t i = 0; i < tile.EntryCount; i++)
+    {
+        auto entry = _replayedEntries[i];
+        switch (column.Entries[tile.EntryBegin + i].Kind)
+        {
+            case CachedEntryKind::Basic:
+                entry->basic.attached_ps = paint_tile_cache_decode<attached_paint_struct>(
+                    paint_tile_cache_pointer_index(entry->basic.attached_ps), nullptr, &paint_entry::attached);
+                entry->basic.children = paint_tile_cache_decode<paint_struct>(
+                    paint_tile_cache_pointer_index(entry->basic.children), nullptr, &paint_entry::basic);
+                break;
+            case CachedEntryKind::Attached:
+                entry->attached.next = paint_tile_cache_decode<attached_paint_struct>(
+                    paint_tile_cache_pointer_index(entry->attached.next), nullptr, &paint_entry::attached);
+                break;
+            case CachedEntryKind::Unused:
+                break;
+        }
+    }
+
+    for (uint32_t i = 0; i < tile.RootCount; i++)
+    {
+        auto ps = &_replayedEntries[column.Roots[tile.RootBegin + i]]->basic;
+        paint_session_add_ps_to_quadrant_index(session, ps, ps->quadrant_index);
+    }
+
+    session->CurrentlyDrawnItem = tile.CurrentlyDrawnItem;
+    session->SpritePosition = tile.SpritePosition;
+    session->InteractionType = tile.InteractionType;
+    session->MapPosition = tile.MapPosition;
+    session->SurfaceElement = tile.SurfaceElement;
+    session->PathElementOnSameHeight = tile.PathElementOnSameHeight;
+    session->TrackElementOnSameHeight = tile.TrackElementOnSameHeight;
+    session->DidPassSurface = tile.DidPassSurface;
+    std::copy(std::begin(tile.TrackColours), std::end(tile.TrackColours), std::begin(session->TrackColours));
+    session->LastRootPS = paint_tile_cache_decode<paint_struct>(tile.LastRootPS, session->LastRootPS, &paint_entry::basic);
+    session->UnkF1AD2C = paint_tile_cache_decode<attached_paint_struct>(
+        tile.UnkF1AD2C, session->UnkF1AD2C, &paint_entry::attached);
+    session->WoodenSupportsPrependTo = paint_tile_cache_decode<paint_struct>(
+        tile.WoodenSupportsPrependTo, session->WoodenSupportsPrependTo, &paint_entry::basic);
+}
+
+void PaintTileCacheSetupTile(paint_session* session, int32_t x, int32_t y)
+{
+    auto& column = *session->TileCacheColumn;
+    if (column.NextTile == column.Tiles.size())
+    {
+        column.Tiles.emplace_back();
+    }
+    auto& tile = column.Tiles[column.NextTile++];
+
+    const auto version = paint_tile_cache_get_tile_version(x, y);
+    const auto inputs = paint_tile_cache_get_inputs(session);
+    if (tile.IsRecorded && tile.X == x && tile.Y == y && tile.Version == version)
+    {
+        if (!tile.IsCacheable)
+        {
+            tile_element_paint_setup(session, x, y);
+            column.Stats.UncachedTiles++;
+            return;
+        }
+        if (tile.Inputs == inputs)
+        {
+            paint_tile_cache_replay_tile(session, column, tile);
+            column.Stats.CachedTiles++;
+            return;
+        }
+    }
+
+    column.UnusedEntries += tile.EntryCount;
+    column.UnusedRoots += tile.RootCount;
+    tile.X = x;
+    tile.Y = y;
+    tile.Version = version;
+    tile.IsRecorded = true;
+    tile.Inputs = inputs;
+    tile.EntryCount = 0;
+    tile.RootCount = 0;
+    if (!paint_tile_cache_is_tile_cacheable(x, y))
+    {
+        tile.IsCacheable = false;
+        tile_element_paint_setup(session, x, y);
+        column.Stats.UncachedTiles++;
+        return;
+    }
+
+    tile.IsCacheable = paint_tile_cache_record_tile(session, column, tile, x, y);
+    if (tile.IsCacheable)
+    {
+        column.Stats.RecordedTiles++;
+    }
+    else
+    {
+        column.Stats.UncachedTiles++;
+    }
+}
@@ -0,0 +1,51 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+
+struct paint_session;
+
+// The paint tile cache keeps the paint structs that the elements of each tile produced for a viewport column, so the
+// next paint of the same column can copy them instead of painting the elements again. A tile is only taken from the
+// cache while the map change journal versions of it and its neighbours are unchanged, and everything else its painting
+// depends on is part of the key of the column. Tiles whose look changes without a map change, such as animated
+// scenery, scrolling signs and rides, are always painted again.
+
+struct PaintTileCacheStats
+{
+    uint32_t CachedTiles;
+    uint32_t RecordedTiles;
+    uint32_t UncachedTiles;
+};
+
+// Drops every cached tile before the next paint, for changes that are not part of the map such as new objects.
+void PaintTileCacheInvalidate();
+
+/**
+ * Checks the state that all tiles depend on and drops columns that were not painted recently. Called on the main
+ * thread before the sessions of a viewport paint are created.
+ */
+void PaintTileCacheBeginPaint();
+
+/**
+ * Gives the session the cached tiles of its column, when the column has been painted before. Called on the main
+ * thread before the session is generated.
+ */
+void PaintTileCacheAttach(paint_session* session);
+
+/**
+ * Adds the tiles of the session to stats and takes the column from the session. Called on the main thread after the
+ * session was generated.
+ */
+void PaintTileCacheDetach(paint_session* session, PaintTileCacheStats& stats);
+
+// Adds the paint structs of a tile to a session that has a column, from the cache or by painting it.
+void PaintTileCacheSetupTile(paint_session* session, int32_t x, int32_t y);
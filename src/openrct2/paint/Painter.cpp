@@ -24,6 +24,8 @@
 #include "../title/TitleScreen.h"
 #include "../ui/UiContext.h"
 
+#include <algorithm>
+
 using namespace OpenRCT2;
 using namespace OpenRCT2::Drawing;
 using namespace OpenRCT2::Paint;
@@ -34,8 +36,19 @@ Painter::Painter(const std::shared_ptr<IUiContext>& uiContext)
 {
 }
 
+Painter::~Painter()
+{
+    for (auto& session : _paintSessionPool)
+    {
+        FreePaintEntryChunks(session->FirstPaintEntryChunk);
+    }
+    FreePaintEntryChunks(_freePaintEntryChunks);
+}
+
 void Painter::Paint(IDrawingEngine& de)
 {
+    TrimPaintEntryChunks();
+
     auto dpi = de.GetDrawingPixelInfo();
     if (gIntroState != IntroState::None)
     {
@@ -161,8 +174,9 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
     }
 
     session->DPI = *dpi;
-    session->EndOfPaintStructArray = &session->PaintStructs[4000 - 1];
-    session->NextFreePaintStruct = session->PaintStructs;
+    session->FirstPaintEntryChunk = nullptr;
+    session->CurrentPaintEntryChunk = nullptr;
+    GrowSession(session);
     session->LastRootPS = nullptr;
     session->UnkF1AD2C = nullptr;
     session->ViewFlags = viewFlags;
@@ -177,11 +191,110 @@ paint_session* Painter::CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags
     session->WoodenSupportsPrependTo = nullptr;
     session->CurrentlyDrawnItem = nullptr;
     session->SurfaceElement = nullptr;
+    session->PathElementOnSameHeight = nullptr;
+    session->TrackElementOnSameHeight = nullptr;
+    std::fill(std::begin(session->TrackColours), std::end(session->TrackColours), 0);
+    session->TileCacheColumn = nullptr;
+    session->TileCacheRoots = nullptr;
 
     return session;
 }
 
 void Painter::ReleaseSession(paint_session* session)
 {
+    {
+        std::lock_guard<std::mutex> lock(_paintEntryMutex);
+        auto numEntries = paint_session_get_entry_count(session);
+        _paintEntryStats.PeakSessionEntries = std::max(_paintEntryStats.PeakSessionEntries, numEntries);
+
+        // Hand the chunks of the session back in one go
+        size_t numChunks = 1;
+        auto lastChunk = session->FirstPaintEntryChunk;
+        while (lastChunk->Next != nullptr)
+        {
+            lastChunk = lastChunk->Next;
+            numChunks++;
+        }
+        lastChunk->Next = _freePaintEntryChunks;
+        _freePaintEntryChunks = session->FirstPaintEntryChunk;
+        _numFreePaintEntryChunks += numChunks;
+        _numPaintEntryChunksInUse -= numChunks;
+    }
+
+    session->FirstPaintEntryChunk = nullptr;
+    session->CurrentPaintEntryChunk = nullptr;
+    session->NextFreePaintStruct = nullptr;
+    session->EndOfPaintStructArray = nullptr;
     _freePaintSessions.push_back(session);
 }
+
+void Painter::GrowSession(paint_session* session)
+{
+    paint_entry_chunk* chunk;
+    {
+        std::lock_guard<std::mutex> lock(_paintEntryMutex);
+        if (_freePaintEntryChunks != nullptr)
+        {
+            chunk = _freePaintEntryChunks;
+            _freePaintEntryChunks = chunk->Next;
+            _numFreePaintEntryChunks--;
+        }
+        else
+        {
+            chunk = new paint_entry_chunk;
+            _paintEntryStats.ChunksAllocated++;
+        }
+        _numPaintEntryChunksInUse++;
+        _paintEntryChunksFramePeak = std::max(_paintEntryChunksFramePeak, _numPaintEntryChunksInUse);
+        _paintEntryStats.PeakChunksInUse = std::max(_paintEntryStats.PeakChunksInUse, _numPaintEntryChunksInUse);
+    }
+
+    chunk->Next = nullptr;
+    if (session->CurrentPaintEntryChunk == nullptr)
+    {
+        session->FirstPaintEntryChunk = chunk;
+    }
+    else
+    {
+        session->CurrentPaintEntryChunk->Next = chunk;
+    }
+    session->CurrentPaintEntryChunk = chunk;
+    session->NextFreePaintStruct = chunk->Entries;
+    session->EndOfPaintStructArray = chunk->Entries + PAINT_ENTRY_CHUNK_SIZE;
+}
+
+void Painter::ResetPaintEntryStats()
+{
+    std::lock_guard<std::mutex> lock(_paintEntryMutex);
+    _paintEntryStats.PeakSessionEntries = 0;
+    _paintEntryStats.PeakChunksInUse = _numPaintEntryChunksInUse;
+}
+
+void Painter::FreePaintEntryChunks(paint_entry_chunk* chunk)
+{
+    while (chunk != nullptr)
+    {
+        auto next = chunk->Next;
+        delete chunk;
+        chunk = next;
+    }
+}
+
+/**
+ * Frees the chunks the previous frame did not need, so the memory of a giant screenshot or a very large view does not
+ * stay around.
+ */
+void Painter::TrimPaintEntryChunks()
+{
+    std::lock_guard<std::mutex> lock(_paintEntryMutex);
+    while (_freePaintEntryChunks != nullptr
+           && _numPaintEntryChunksInUse + _numFreePaintEntryChunks > _paintEntryChunksFramePeak)
+    {
+        auto chunk = _freePaintEntryChunks;
+        _freePaintEntryChunks = chunk->Next;
+        _numFreePaintEntryChunks--;
+        _paintEntryStats.ChunksAllocated--;
+        delete chunk;
+    }
+    _paintEntryChunksFramePeak = _numPaintEntryChunksInUse;
+}
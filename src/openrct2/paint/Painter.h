@@ -14,6 +14,7 @@
 
 #include <ctime>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 struct rct_drawpixelinfo;
@@ -32,27 +33,65 @@ namespace OpenRCT2
 
     namespace Paint
     {
+        /**
+         * How many paint entries the sessions needed, to see how much memory painting a view takes.
+         */
+        struct PaintEntryStats
+        {
+            // The most entries a single session used.
+            size_t PeakSessionEntries;
+            // The most chunks that were in use by all sessions at the same time.
+            size_t PeakChunksInUse;
+            // The chunks that are allocated now, including the free ones kept for the next frame.
+            size_t ChunksAllocated;
+        };
+
         struct Painter final
         {
         private:
             std::shared_ptr<Ui::IUiContext> const _uiContext;
             std::vector<std::unique_ptr<paint_session>> _paintSessionPool;
             std::vector<paint_session*> _freePaintSessions;
+
+            // Sessions grow from the threads that generate them, so the chunks are shared under a lock.
+            std::mutex _paintEntryMutex;
+            paint_entry_chunk* _freePaintEntryChunks = nullptr;
+            size_t _numFreePaintEntryChunks = 0;
+            size_t _numPaintEntryChunksInUse = 0;
+            size_t _paintEntryChunksFramePeak = 0;
+            PaintEntryStats _paintEntryStats{};
+
             time_t _lastSecond = 0;
             int32_t _currentFPS = 0;
             int32_t _frames = 0;
 
         public:
             explicit Painter(const std::shared_ptr<Ui::IUiContext>& uiContext);
+            ~Painter();
+
+            Painter(const Painter&) = delete;
+            Painter& operator=(const Painter&) = delete;
+
             void Paint(Drawing::IDrawingEngine& de);
 
             paint_session* CreateSession(rct_drawpixelinfo* dpi, uint32_t viewFlags);
             void ReleaseSession(paint_session* session);
 
+            // Gives the session another chunk of paint entries, safe to call from any thread.
+            void GrowSession(paint_session* session);
+
+            const PaintEntryStats& GetPaintEntryStats() const
+            {
+                return _paintEntryStats;
+            }
+            void ResetPaintEntryStats();
+
         private:
             void PaintReplayNotice(rct_drawpixelinfo* dpi, const char* text);
             void PaintFPS(rct_drawpixelinfo* dpi);
             void MeasureFPS();
+            void FreePaintEntryChunks(paint_entry_chunk* chunk);
+            void TrimPaintEntryChunks();
         };
     } // namespace Paint
 } // namespace OpenRCT2
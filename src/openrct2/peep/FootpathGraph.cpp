@@ -0,0 +1,699 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "FootpathGraph.h"
+
+#include "../util/Util.h"
+#include "../world/Footpath.h"
+#include "../world/Map.h"
+#include "GuestPathfinding.h"
+
+#include <algorithm>
+#include <array>
+#include <queue>
+#include <vector>
+
+static constexpr const int32_t FOOTPATH_GRAPH_NONE = -1;
+
+struct FootpathGraphNode
+{
+    TileCoordsXYZ Location;
+    // The segment leaving the node in each direction.
+    std::array<int32_t, NumOrthogonalDirections> Segments;
+    bool Used;
+};
+
+struct FootpathGraphSegmentTile
+{
+    TileCoordsXYZ Location;
+    // The directions towards the second and the first end of the segment.
+    Direction Forward;
+    Direction Backward;
+    bool IsQueue;
+};
+
+struct FootpathGraphSegment
+{
+    // The segment runs from Nodes[0] to Nodes[1], leaving each of them in Directions[].
+    // Segments that end in anything but a path have no second node, but a terminal tile.
+    std::array<int32_t, 2> Nodes;
+    std::array<Direction, 2> Directions;
+    std::vector<FootpathGraphSegmentTile> Tiles;
+    TileCoordsXYZ Terminal;
+    bool Used;
+};
+
+enum class FootpathGraphOwnerType : uint8_t
+{
+    Node,
+    Corridor,
+    Terminal,
+};
+
+struct FootpathGraphTileOwner
+{
+    int32_t Z;
+    FootpathGraphOwnerType Type;
+    int32_t Id;
+};
+
+static std::vector<FootpathGraphNode> _nodes;
+static std::vector<FootpathGraphSegment> _segments;
+static std::vector<int32_t> _freeNodes;
+static std::vector<int32_t> _freeSegments;
+static std::vector<int32_t> _pendingNodes;
+// What the graph has on every tile, indexed by tile x * MAXIMUM_MAP_SIZE_TECHNICAL + tile y.
+static std::vector<std::vector<FootpathGraphTileOwner>> _tileOwners;
+static std::vector<CoordsXY> _dirtyTiles;
+static bool _rebuildNeeded = true;
+
+static bool IsTileInRange(const TileCoordsXY& loc)
+{
+    return loc.x >= 0 && loc.x < MAXIMUM_MAP_SIZE_TECHNICAL && loc.y >= 0 && loc.y < MAXIMUM_MAP_SIZE_TECHNICAL;
+}
+
+static std::vector<FootpathGraphTileOwner>* GetTileOwners(const TileCoordsXY& loc)
+{
+    if (!IsTileInRange(loc))
+        return nullptr;
+    return &_tileOwners[loc.x * MAXIMUM_MAP_SIZE_TECHNICAL + loc.y];
+}
+
+static void AddTileOwner(const TileCoordsXYZ& loc, FootpathGraphOwnerType type, int32_t id)
+{
+    auto owners = GetTileOwners(loc);
+    if (owners != nullptr)
+    {
+        owners->push_back({ loc.z, type, id });
+    }
+}
+
+static void RemoveTileOwner(const TileCoordsXYZ& loc, FootpathGraphOwnerType type, int32_t id)
+{
+    auto owners = GetTileOwners(loc);
+    if (owners == nullptr)
+        return;
+
+    auto it = std::find_if(owners->begin(), owners->end(), [&loc, type, id](const FootpathGraphTileOwner& owner) {
+        return owner.Z == loc.z && owner.Type == type && owner.Id == id;
+    });
+    if (it != owners->end())
+    {
+        owners->erase(it);
+    }
+}
+
+static const FootpathGraphTileOwner* FindPathOwner(const TileCoordsXYZ& loc)
+{
+    auto owners = GetTileOwners(loc);
+    if (owners == nullptr)
+        return nullptr;
+
+    for (const auto& owner : *owners)
+    {
+        if (owner.Z == loc.z && owner.Type != FootpathGraphOwnerType::Terminal)
+            return &owner;
+    }
+    return nullptr;
+}
+
+static PathElement* GetPathAt(const TileCoordsXYZ& loc)
+{
+    auto tileElement = map_get_first_element_at(loc.ToCoordsXY());
+    if (tileElement == nullptr)
+        return nullptr;
+    do
+    {
+        if (tileElement->GetType() != TILE_ELEMENT_TYPE_PATH || tileElement->IsGhost())
+            continue;
+        if (tileElement->base_height == loc.z)
+            return tileElement->AsPath();
+    } while (!(tileElement++)->IsLastForTile());
+    return nullptr;
+}
+
+/**
+ * The edges of the path that guests can use, those blocked by 'no entry' signs are left out.
+ */
+static uint8_t GetPathEdges(PathElement* pathElement)
+{
+    uint8_t edges = pathElement->GetEdges();
+    auto tileElement = reinterpret_cast<TileElement*>(pathElement);
+    while (!tileElement->IsLastForTile())
+    {
+        tileElement++;
+        if (tileElement->GetType() == TILE_ELEMENT_TYPE_PATH)
+            break;
+        if (tileElement->GetType() == TILE_ELEMENT_TYPE_BANNER && !tileElement->IsGhost())
+        {
+            edges &= tileElement->AsBanner()->GetAllowedEdges();
+        }
+    }
+    return edges & 0xF;
+}
+
+/**
+ * Finds the path a guest walking from the path at loc in the given direction steps onto. The location that
+ * was stepped to is returned in nextLoc, with the height at which the step arrives if there is no path there.
+ * Wide paths are not stepped onto, like the heuristic search the graph ends a route where they begin.
+ */
+static PathElement* StepToNextPath(
+    const TileCoordsXYZ& loc, PathElement* pathElement, Direction direction, TileCoordsXYZ& nextLoc)
+{
+    nextLoc = loc;
+    nextLoc += TileDirectionDelta[direction];
+    if (pathElement->IsSloped() && pathElement->GetSlopeDirection() == direction)
+    {
+        nextLoc.z += 2;
+    }
+
+    auto tileElement = map_get_first_element_at(nextLoc.ToCoordsXY());
+    if (tileElement == nullptr)
+        return nullptr;
+    do
+    {
+        if (tileElement->GetType() != TILE_ELEMENT_TYPE_PATH || tileElement->IsGhost())
+            continue;
+        if (!IsValidPathZAndDirection(tileElement, nextLoc.z, direction))
+            continue;
+
+        nextLoc.z = tileElement->base_height;
+        if (tileElement->AsPath()->IsWide())
+            return nullptr;
+        return tileElement->AsPath();
+    } while (!(tileElement++)->IsLastForTile());
+    return nullptr;
+}
+
+static bool IsNodePath(uint8_t edges)
+{
+    return bitcount(edges) != 2;
+}
+
+static int32_t FindNode(const TileCoordsXYZ& loc)
+{
+    auto owner = FindPathOwner(loc);
+    if (owner != nullptr && owner->Type == FootpathGraphOwnerType::Node)
+        return owner->Id;
+    return FOOTPATH_GRAPH_NONE;
+}
+
+static int32_t GetOrCreateNode(const TileCoordsXYZ& loc)
+{
+    auto nodeId = FindNode(loc);
+    if (nodeId != FOOTPATH_GRAPH_NONE)
+        return nodeId;
+
+    if (!_freeNodes.empty())
+    {
+        nodeId = _freeNodes.back();
+        _freeNodes.pop_back();
+    }
+    else
+    {
+        nodeId = static_cast<int32_t>(_nodes.size());
+        _nodes.emplace_back();
+    }
+
+    auto& node = _nodes[nodeId];
+    node.Location = loc;
+    node.Segments.fill(FOOTPATH_GRAPH_NONE);
+    node.Used = true;
+    AddTileOwner(loc, FootpathGraphOwnerType::Node, nodeId);
+    _pendingNodes.push_back(nodeId);
+    return nodeId;
+}
+
+static int32_t CreateSegment()
+{
+    int32_t segmentId;
+    if (!_freeSegments.empty())
+    {
+        segmentId = _freeSegments.back();
+        _freeSegments.pop_back();
+    }
+    else
+    {
+        segmentId = static_cast<int32_t>(_segments.size());
+        _segments.emplace_back();
+    }
+
+    auto& segment = _segments[segmentId];
+    segment.Nodes.fill(FOOTPATH_GRAPH_NONE);
+    segment.Tiles.clear();
+    segment.Used = true;
+    return segmentId;
+}
+
+static void RemoveSegment(int32_t segmentId)
+{
+    auto& segment = _segments[segmentId];
+    if (!segment.Used)
+        return;
+
+    for (int32_t side = 0; side < 2; side++)
+    {
+        auto nodeId = segment.Nodes[side];
+        if (nodeId == FOOTPATH_GRAPH_NONE)
+            continue;
+
+        auto& node = _nodes[nodeId];
+        if (node.Segments[segment.Directions[side]] == segmentId)
+        {
+            node.Segments[segment.Directions[side]] = FOOTPATH_GRAPH_NONE;
+        }
+        // The node has lost a connection, so it needs to be traced again.
+        _pendingNodes.push_back(nodeId);
+    }
+
+    for (const auto& tile : segment.Tiles)
+    {
+        RemoveTileOwner(tile.Location, FootpathGraphOwnerType::Corridor, segmentId);
+    }
+    if (segment.Nodes[1] == FOOTPATH_GRAPH_NONE)
+    {
+        RemoveTileOwner(segment.Terminal, FootpathGraphOwnerType::Terminal, segmentId);
+    }
+
+    segment.Tiles.clear();
+    segment.Used = false;
+    _freeSegments.push_back(segmentId);
+}
+
+static void RemoveNode(int32_t nodeId)
+{
+    auto& node = _nodes[nodeId];
+    if (!node.Used)
+        return;
+
+    for (auto segmentId : node.Segments)
+    {
+        if (segmentId != FOOTPATH_GRAPH_NONE)
+        {
+            RemoveSegment(segmentId);
+        }
+    }
+    RemoveTileOwner(node.Location, FootpathGraphOwnerType::Node, nodeId);
+    node.Used = false;
+    _freeNodes.push_back(nodeId);
+}
+
+/**
+ * Follows the path leaving the node in the given direction until it reaches another node or something other than a path.
+ */
+static void TraceSegment(int32_t nodeId, Direction direction)
+{
+    auto segmentId = CreateSegment();
+    auto& segment = _segments[segmentId];
+    segment.Nodes[0] = nodeId;
+    segment.Directions[0] = direction;
+    _nodes[nodeId].Segments[direction] = segmentId;
+
+    auto loc = _nodes[nodeId].Location;
+    auto pathElement = GetPathAt(loc);
+    while (pathElement != nullptr)
+    {
+        TileCoordsXYZ nextLoc;
+        auto nextPathElement = StepToNextPath(loc, pathElement, direction, nextLoc);
+        if (nextPathElement == nullptr)
+        {
+            segment.Terminal = nextLoc;
+            AddTileOwner(nextLoc, FootpathGraphOwnerType::Terminal, segmentId);
+            return;
+        }
+
+        auto backDirection = direction_reverse(direction);
+        auto edges = GetPathEdges(nextPathElement);
+        auto nextOwner = FindPathOwner(nextLoc);
+        if (nextOwner != nullptr && nextOwner->Type == FootpathGraphOwnerType::Corridor)
+        {
+            // Only paths connected in one direction lead into the middle of another segment, stop here.
+            segment.Terminal = nextLoc;
+            AddTileOwner(nextLoc, FootpathGraphOwnerType::Terminal, segmentId);
+            return;
+        }
+        if (IsNodePath(edges) || !(edges & (1 << backDirection)) || nextOwner != nullptr)
+        {
+            // Node ids can be reused, so look the node up again after the one at the end may have been added.
+            auto endNodeId = GetOrCreateNode(nextLoc);
+            auto& endNode = _nodes[endNodeId];
+            segment.Nodes[1] = endNodeId;
+            segment.Directions[1] = backDirection;
+            if ((edges & (1 << backDirection)) && endNode.Segments[backDirection] == FOOTPATH_GRAPH_NONE)
+            {
+                endNode.Segments[backDirection] = segmentId;
+            }
+            return;
+        }
+
+        auto nextDirection = static_cast<Direction>(bitscanforward(edges & ~(1 << backDirection)));
+        segment.Tiles.push_back({ nextLoc, nextDirection, backDirection, nextPathElement->IsQueue() });
+        AddTileOwner(nextLoc, FootpathGraphOwnerType::Corridor, segmentId);
+
+        loc = nextLoc;
+        pathElement = nextPathElement;
+        direction = nextDirection;
+    }
+
+    // The node is not on a path any more, it will be removed with its tile.
+    segment.Terminal = loc;
+    AddTileOwner(loc, FootpathGraphOwnerType::Terminal, segmentId);
+}
+
+static void AddNodesOnTile(const TileCoordsXY& loc)
+{
+    auto tileElement = map_get_first_element_at(loc.ToCoordsXY());
+    if (tileElement == nullptr)
+        return;
+    do
+    {
+        if (tileElement->GetType() != TILE_ELEMENT_TYPE_PATH || tileElement->IsGhost() || tileElement->AsPath()->IsWide())
+            continue;
+        if (IsNodePath(GetPathEdges(tileElement->AsPath())))
+        {
+            GetOrCreateNode({ loc, tileElement->base_height });
+        }
+    } while (!(tileElement++)->IsLastForTile());
+}
+
+static void TracePendingNodes()
+{
+    while (!_pendingNodes.empty())
+    {
+        auto nodeId = _pendingNodes.back();
+        _pendingNodes.pop_back();
+        if (!_nodes[nodeId].Used)
+            continue;
+
+        auto pathElement = GetPathAt(_nodes[nodeId].Location);
+        if (pathElement == nullptr)
+            continue;
+
+        auto edges = GetPathEdges(pathElement);
+        for (Direction direction = 0; direction < NumOrthogonalDirections; direction++)
+        {
+            if ((edges & (1 << direction)) && _nodes[nodeId].Segments[direction] == FOOTPATH_GRAPH_NONE)
+            {
+                TraceSegment(nodeId, direction);
+            }
+        }
+    }
+}
+
+static void RebuildGraph()
+{
+    _nodes.clear();
+    _segments.clear();
+    _freeNodes.clear();
+    _freeSegments.clear();
+    _pendingNodes.clear();
+    _tileOwners.assign(MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL, {});
+
+    for (int32_t y = 0; y < gMapSize; y++)
+    {
+        for (int32_t x = 0; x < gMapSize; x++)
+        {
+            AddNodesOnTile({ x, y });
+        }
+    }
+    TracePendingNodes();
+}
+
+/**
+ * Drops everything the graph has on the dirty tiles and their neighbours, whose edges may have changed
+ * with them, and traces the paths there again from the nodes that were connected to them.
+ */
+static void UpdateDirtyTiles()
+{
+    std::vector<TileCoordsXY> area;
+    for (const auto& dirtyTile : _dirtyTiles)
+    {
+        auto loc = TileCoordsXY(dirtyTile);
+        area.push_back(loc);
+        for (Direction direction = 0; direction < NumOrthogonalDirections; direction++)
+        {
+            area.push_back(loc + TileDirectionDelta[direction]);
+        }
+    }
+    _dirtyTiles.clear();
+
+    for (const auto& loc : area)
+    {
+        auto owners = GetTileOwners(loc);
+        while (owners != nullptr && !owners->empty())
+        {
+            auto owner = owners->back();
+            auto numOwners = owners->size();
+            if (owner.Type == FootpathGraphOwnerType::Node)
+            {
+                RemoveNode(owner.Id);
+            }
+            else
+            {
+                RemoveSegment(owner.Id);
+            }
+            if (owners->size() == numOwners)
+            {
+                owners->pop_back();
+            }
+        }
+    }
+
+    for (const auto& loc : area)
+    {
+        if (IsTileInRange(loc))
+        {
+            AddNodesOnTile(loc);
+        }
+    }
+    TracePendingNodes();
+}
+
+static void UpdateGraph()
+{
+    if (_rebuildNeeded)
+    {
+        _rebuildNeeded = false;
+        _dirtyTiles.clear();
+        RebuildGraph();
+    }
+    else if (!_dirtyTiles.empty())
+    {
+        UpdateDirtyTiles();
+    }
+}
+
+void FootpathGraphInvalidateTile(const CoordsXY& loc)
+{
+    if (!_rebuildNeeded)
+    {
+        _dirtyTiles.push_back(loc);
+    }
+}
+
+void FootpathGraphInvalidateAll()
+{
+    _rebuildNeeded = true;
+}
+
+static bool IsForeignQueue(const FootpathGraphSegmentTile& tile, ride_id_t queueRideIndex, bool ignoreForeignQueues)
+{
+    if (!tile.IsQueue || !ignoreForeignQueues)
+        return false;
+
+    // Queues are chained to rides without changing the graph, so the ride is looked up on the map.
+    auto pathElement = GetPathAt(tile.Location);
+    if (pathElement == nullptr)
+        return false;
+
+    auto rideIndex = pathElement->GetRideIndex();
+    return rideIndex != queueRideIndex && rideIndex != RIDE_ID_NULL;
+}
+
+struct FootpathGraphWalk
+{
+    // The node reached at the end of the segment, or FOOTPATH_GRAPH_NONE if it was not reached.
+    int32_t Node = FOOTPATH_GRAPH_NONE;
+    uint32_t Length = 0;
+    bool ReachedGoal = false;
+};
+
+/**
+ * Walks along a segment from one of its ends, beginning with the tile at firstTile steps in.
+ * Walking from the second end always leads to a node, only the second end can be a terminal.
+ */
+static FootpathGraphWalk WalkSegment(
+    const FootpathGraphSegment& segment, int32_t side, int32_t firstTile, const TileCoordsXYZ& goal,
+    ride_id_t queueRideIndex, bool ignoreForeignQueues)
+{
+    FootpathGraphWalk walk;
+    auto numTiles = static_cast<int32_t>(segment.Tiles.size());
+    for (int32_t i = firstTile; i < numTiles; i++)
+    {
+        const auto& tile = segment.Tiles[side == 0 ? i : numTiles - 1 - i];
+        walk.Length++;
+        if (tile.Location == goal)
+        {
+            walk.ReachedGoal = true;
+            return walk;
+        }
+        if (IsForeignQueue(tile, queueRideIndex, ignoreForeignQueues))
+            return walk;
+    }
+
+    walk.Length++;
+    auto endNodeId = segment.Nodes[1 - side];
+    if (endNodeId == FOOTPATH_GRAPH_NONE)
+    {
+        walk.ReachedGoal = segment.Terminal == goal;
+    }
+    else
+    {
+        walk.ReachedGoal = _nodes[endNodeId].Location == goal;
+        walk.Node = endNodeId;
+    }
+    return walk;
+}
+
+static int32_t GetSegmentSide(const FootpathGraphSegment& segment, int32_t nodeId, Direction direction)
+{
+    return (segment.Nodes[0] == nodeId && segment.Directions[0] == direction) ? 0 : 1;
+}
+
+static uint32_t GetDistanceEstimate(const TileCoordsXYZ& loc, const TileCoordsXYZ& goal)
+{
+    return abs(loc.x - goal.x) + abs(loc.y - goal.y);
+}
+
+/**
+ * A* search over the nodes, starting at a node that is already startLength tiles along the route.
+ */
+static std::optional<uint32_t> FindRouteFromNode(
+    int32_t startNodeId, uint32_t startLength, const TileCoordsXYZ& goal, ride_id_t queueRideIndex, bool ignoreForeignQueues)
+{
+    using QueueEntry = std::pair<uint32_t, int32_t>;
+    std::priority_queue<QueueEntry, std::vector<QueueEntry>, std::greater<QueueEntry>> openNodes;
+    std::vector<uint32_t> lengths(_nodes.size(), UINT32_MAX);
+
+    std::optional<uint32_t> bestLength;
+    lengths[startNodeId] = startLength;
+    openNodes.push({ startLength + GetDistanceEstimate(_nodes[startNodeId].Location, goal), startNodeId });
+    while (!openNodes.empty())
+    {
+        auto [estimate, nodeId] = openNodes.top();
+        openNodes.pop();
+        if (bestLength.has_value() && estimate >= *bestLength)
+            break;
+
+        auto length = lengths[nodeId];
+        if (estimate != length + GetDistanceEstimate(_nodes[nodeId].Location, goal))
+            continue;
+
+        const auto& node = _nodes[nodeId];
+        for (Direction direction = 0; direction < NumOrthogonalDirections; direction++)
+        {
+            auto segmentId = node.Segments[direction];
+            if (segmentId == FOOTPATH_GRAPH_NONE)
+                continue;
+
+            const auto& segment = _segments[segmentId];
+            auto walk = WalkSegment(
+                segment, GetSegmentSide(segment, nodeId, direction), 0, goal, queueRideIndex, ignoreForeignQueues);
+            if (walk.ReachedGoal)
+            {
+                if (!bestLength.has_value() || length + walk.Length < *bestLength)
+                {
+                    bestLength = length + walk.Length;
+                }
+            }
+            else if (walk.Node != FOOTPATH_GRAPH_NONE && length + walk.Length < lengths[walk.Node])
+            {
+                lengths[walk.Node] = length + walk.Length;
+                openNodes.push({ lengths[walk.Node] + GetDistanceEstimate(_nodes[walk.Node].Location, goal), walk.Node });
+            }
+        }
+    }
+    return bestLength;
+}
+
+std::optional<uint32_t> FootpathGraphGetRouteLength(
+    const TileCoordsXYZ& start, Direction direction, const TileCoordsXYZ& goal, ride_id_t queueRideIndex,
+    bool ignoreForeignQueues)
+{
+    UpdateGraph();
+
+    auto owner = FindPathOwner(start);
+    if (owner == nullptr || !direction_valid(direction))
+        return std::nullopt;
+
+    FootpathGraphWalk walk;
+    if (owner->Type == FootpathGraphOwnerType::Node)
+    {
+        auto segmentId = _nodes[owner->Id].Segments[direction];
+        if (segmentId == FOOTPATH_GRAPH_NONE)
+            return std::nullopt;
+
+        const auto& segment = _segments[segmentId];
+        walk = WalkSegment(
+            segment, GetSegmentSide(segment, owner->Id, direction), 0, goal, queueRideIndex, ignoreForeignQueues);
+    }
+    else
+    {
+        // Starting halfway along a segment, towards one of its ends.
+        const auto& segment = _segments[owner->Id];
+        auto numTiles = static_cast<int32_t>(segment.Tiles.size());
+        auto index = static_cast<int32_t>(std::distance(
+            segment.Tiles.begin(),
+            std::find_if(segment.Tiles.begin(), segment.Tiles.end(), [&start](const FootpathGraphSegmentTile& tile) {
+                return tile.Location == start;
+            })));
+        if (index == numTiles)
+            return std::nullopt;
+
+        if (segment.Tiles[index].Forward == direction)
+        {
+            walk = WalkSegment(segment, 0, index + 1, goal, queueRideIndex, ignoreForeignQueues);
+        }
+        else if (segment.Tiles[index].Backward == direction)
+        {
+            walk = WalkSegment(segment, 1, numTiles - index, goal, queueRideIndex, ignoreForeignQueues);
+        }
+        else
+        {
+            return std::nullopt;
+        }
+    }
+
+    if (walk.ReachedGoal)
+        return walk.Length;
+    if (walk.Node == FOOTPATH_GRAPH_NONE)
+        return std::nullopt;
+    return FindRouteFromNode(walk.Node, walk.Length, goal, queueRideIndex, ignoreForeignQueues);
+}
+
+Direction FootpathGraphChooseDirection(
+    const TileCoordsXYZ& start, uint8_t edges, const TileCoordsXYZ& goal, ride_id_t queueRideIndex, bool ignoreForeignQueues)
+{
+    // Each direction is searched on its own, so the choice does not depend on the order of the nodes in the graph.
+    Direction bestDirection = INVALID_DIRECTION;
+    uint32_t bestLength = UINT32_MAX;
+    for (Direction direction = 0; direction < NumOrthogonalDirections; direction++)
+    {
+        if (!(edges & (1 << direction)))
+            continue;
+
+        auto length = FootpathGraphGetRouteLength(start, direction, goal, queueRideIndex, ignoreForeignQueues);
+        if (length.has_value() && *length < bestLength)
+        {
+            bestLength = *length;
+            bestDirection = direction;
+        }
+    }
+    return bestDirection;
+}
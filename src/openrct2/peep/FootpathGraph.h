@@ -0,0 +1,44 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "../ride/RideTypes.h"
+#include "../world/Location.hpp"
+
+#include <optional>
+
+// The footpath graph is a compact view of the paths guests can walk on. Its nodes are the path
+// tiles that do not simply continue a path: junctions, dead ends and paths next to entrances.
+// The runs of path between them are stored as segments with their length, so routes over the
+// whole park can be found without walking every tile element.
+//
+// Ghost elements are left out and wide paths end a route, as in the heuristic search of the guests.
+// The graph is built the first time it is used and then kept up to date from the invalidation calls.
+//
+// Guests do not route over the graph. Any change to the directions they choose changes the simulation and
+// recorded replays would no longer verify, so the guest update does not use it.
+
+// Needs to be called when a path on (or next to) the tile at loc is added, removed, reconnected or made (not) wide.
+void FootpathGraphInvalidateTile(const CoordsXY& loc);
+
+// Needs to be called when any other element a guest could walk to may have changed, or the map is replaced.
+void FootpathGraphInvalidateAll();
+
+// Returns the number of tiles on the shortest route from the path at start to goal that leaves start
+// in the given direction. Guests never walk over queues of other rides if ignoreForeignQueues is set.
+std::optional<uint32_t> FootpathGraphGetRouteLength(
+    const TileCoordsXYZ& start, Direction direction, const TileCoordsXYZ& goal, ride_id_t queueRideIndex,
+    bool ignoreForeignQueues);
+
+// Returns the direction out of edges that starts the shortest route from start to goal, or INVALID_DIRECTION
+// if goal cannot be reached. Routes of the same length are resolved in favour of the lowest direction.
+Direction FootpathGraphChooseDirection(
+    const TileCoordsXYZ& start, uint8_t edges, const TileCoordsXYZ& goal, ride_id_t queueRideIndex, bool ignoreForeignQueues);
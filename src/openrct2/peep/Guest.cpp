@@ -22,6 +22,7 @@
 #include "../rct2/RCT2.h"
 #include "../ride/Ride.h"
 #include "../ride/RideData.h"
+#include "../ride/RideVisibility.h"
 #include "../ride/ShopItem.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
@@ -1931,30 +1932,7 @@ std::bitset<MAX_RIDES> Guest::FindRidesToGoOn()
     else
     {
         // Take nearby rides into consideration
-        constexpr auto radius = 10 * 32;
-        int32_t cx = floor2(x, 32);
-        int32_t cy = floor2(y, 32);
-        for (int32_t tileX = cx - radius; tileX <= cx + radius; tileX += COORDS_XY_STEP)
-        {
-            for (int32_t tileY = cy - radius; tileY <= cy + radius; tileY += COORDS_XY_STEP)
-            {
-                if (map_is_location_valid({ tileX, tileY }))
-                {
-                    auto tileElement = map_get_first_element_at({ tileX, tileY });
-                    if (tileElement != nullptr)
-                    {
-                        do
-                        {
-                            if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK)
-                            {
-                                auto rideIndex = tileElement->AsTrack()->GetRideIndex();
-                                rideConsideration[rideIndex] = true;
-                            }
-                        } while (!(tileElement++)->IsLastForTile());
-                    }
-                }
-            }
-        }
+        rideConsideration = GetNearbyRides();
 
         // Always take the tall rides into consideration (realistic as you can usually see them from anywhere in the park)
         for (auto& ride : GetRideManager())
@@ -1969,6 +1947,24 @@ std::bitset<MAX_RIDES> Guest::FindRidesToGoOn()
     return rideConsideration;
 }
 
+/**
+ * Returns the rides with track close enough to the guest for them to notice.
+ */
+std::bitset<MAX_RIDES> Guest::GetNearbyRides() const
+{
+    auto plan = GetPeepUpdatePlan(sprite_index);
+    if (plan != nullptr && plan->HasNearbyRides && plan->NearbyRidesTile == CoordsXY{ x, y }.ToTileStart())
+    {
+#ifdef DEBUG
+        openrct2_assert(
+            plan->NearbyRides == RideVisibilityGetRidesNear({ x, y }), "Planned nearby rides of guest %u are out of date",
+            sprite_index);
+#endif
+        return plan->NearbyRides;
+    }
+    return RideVisibilityGetRidesNear({ x, y });
+}
+
 /**
  * This function is called whenever a peep is deciding whether or not they want
  * to go on a ride or visit a shop. They may be physically present at the
@@ -3183,32 +3179,12 @@ template<typename T> static void peep_head_for_nearest_ride(Guest* peep, bool co
     else
     {
         // Take nearby rides into consideration
-        constexpr auto searchRadius = 10 * 32;
-        int32_t cx = floor2(peep->x, 32);
-        int32_t cy = floor2(peep->y, 32);
-        for (auto x = cx - searchRadius; x <= cx + searchRadius; x += COORDS_XY_STEP)
+        auto nearbyRides = peep->GetNearbyRides();
+        for (const auto& ride : GetRideManager())
         {
-            for (auto y = cy - searchRadius; y <= cy + searchRadius; y += COORDS_XY_STEP)
+            if (nearbyRides[ride.id] && predicate(ride))
             {
-                if (map_is_location_valid({ x, y }))
-                {
-                    auto tileElement = map_get_first_element_at({ x, y });
-                    if (tileElement != nullptr)
-                    {
-                        do
-                        {
-                            if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK)
-                            {
-                                auto rideIndex = tileElement->AsTrack()->GetRideIndex();
-                                auto ride = get_ride(rideIndex);
-                                if (ride != nullptr && predicate(*ride))
-                                {
-                                    rideConsideration[rideIndex] = true;
-                                }
-                            }
-                        } while (!(tileElement++)->IsLastForTile());
-                    }
-                }
+                rideConsideration[ride.id] = true;
             }
         }
     }
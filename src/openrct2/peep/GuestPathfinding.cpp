@@ -21,6 +21,7 @@
 #include "Staff.h"
 
 #include <cstring>
+#include <unordered_map>
 
 static bool _peepPathFindIsStaff;
 static int8_t _peepPathFindNumJunctions;
@@ -68,6 +69,65 @@ enum
     PATH_SEARCH_FAILED
 };
 
+/* Cache of the directions chosen by the heuristic search of guests.
+ * The search result only depends on the map and on the parameters in the key,
+ * so for as long as the map does not change the same key gives the same direction.
+ * The peep PathfindHistory is part of the key as the search avoids the junctions
+ * remembered there. Staff are not cached, their search also depends on their
+ * patrol area. */
+struct PathfindingCacheKey
+{
+    TileCoordsXYZ Location;
+    TileCoordsXYZ Goal;
+    rct12_xyzd8 History[4];
+    ride_id_t QueueRideIndex;
+    uint8_t Edges;
+    uint8_t MaxJunctions;
+    bool IgnoreForeignQueues;
+
+    bool operator==(const PathfindingCacheKey& other) const
+    {
+        if (Location != other.Location || Goal != other.Goal || QueueRideIndex != other.QueueRideIndex
+            || Edges != other.Edges || MaxJunctions != other.MaxJunctions || IgnoreForeignQueues != other.IgnoreForeignQueues)
+        {
+            return false;
+        }
+        return std::memcmp(History, other.History, sizeof(History)) == 0;
+    }
+};
+
+struct PathfindingCacheKeyHash
+{
+    size_t operator()(const PathfindingCacheKey& key) const
+    {
+        size_t hash = 0;
+        auto combine = [&hash](size_t value) { hash ^= value + 0x9E3779B9 + (hash << 6) + (hash >> 2); };
+        combine((key.Location.x << 16) | (key.Location.y << 8) | (key.Location.z & 0xFF));
+        combine((key.Goal.x << 16) | (key.Goal.y << 8) | (key.Goal.z & 0xFF));
+        for (const auto& history : key.History)
+        {
+            combine((history.x << 24) | (history.y << 16) | (history.z << 8) | history.direction);
+        }
+        combine((key.QueueRideIndex << 16) | (key.Edges << 8) | (key.MaxJunctions << 1) | (key.IgnoreForeignQueues ? 1 : 0));
+        return hash;
+    }
+};
+
+// Rather than evicting single entries, the whole cache is dropped when it grows past this size.
+static constexpr const size_t PATHFINDING_CACHE_MAX_ENTRIES = 65536;
+
+static std::unordered_map<PathfindingCacheKey, Direction, PathfindingCacheKeyHash> _pathfindingCache;
+static PathfindingCacheStats _pathfindingCacheStats;
+
+static void pathfinding_cache_store(const PathfindingCacheKey& key, Direction direction)
+{
+    if (_pathfindingCache.size() >= PATHFINDING_CACHE_MAX_ENTRIES)
+    {
+        _pathfindingCache.clear();
+    }
+    _pathfindingCache[key] = direction;
+}
+
 static TileElement* get_banner_on_path(TileElement* path_element)
 {
     // This is an improved version of original.
@@ -1391,8 +1451,43 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
 
     int32_t chosen_edge = bitscanforward(edges);
 
+    /* Guests with multiple edges still to try reuse the result of an
+     * identical earlier search if the map has not changed since. */
+    bool useCache = peep->AssignedPeepType == PeepType::Guest && (edges & ~(1 << chosen_edge));
+#if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+    // Keep logging the whole search for the peep being debugged.
+    useCache = useCache && !gPathFindDebug;
+#endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+
+    PathfindingCacheKey cacheKey{};
+    bool cacheHit = false;
+    if (useCache)
+    {
+        cacheKey.Location = loc;
+        cacheKey.Goal = goal;
+        std::memcpy(cacheKey.History, peep->PathfindHistory, sizeof(cacheKey.History));
+        cacheKey.QueueRideIndex = gPeepPathFindQueueRideIndex;
+        cacheKey.Edges = edges;
+        cacheKey.MaxJunctions = _peepPathFindMaxJunctions;
+        cacheKey.IgnoreForeignQueues = gPeepPathFindIgnoreForeignQueues;
+
+        auto it = _pathfindingCache.find(cacheKey);
+        if (it != _pathfindingCache.end())
+        {
+            _pathfindingCacheStats.Hits++;
+            if (it->second == INVALID_DIRECTION)
+                return INVALID_DIRECTION;
+            chosen_edge = it->second;
+            cacheHit = true;
+        }
+        else
+        {
+            _pathfindingCacheStats.Misses++;
+        }
+    }
+
     // Peep has multiple edges still to try.
-    if (edges & ~(1 << chosen_edge))
+    if (!cacheHit && (edges & ~(1 << chosen_edge)))
     {
         uint16_t best_score = 0xFFFF;
         uint8_t best_sub = 0xFF;
@@ -1530,8 +1625,16 @@ Direction peep_pathfind_choose_direction(const TileCoordsXYZ& loc, Peep* peep)
                 log_verbose("Pathfind heuristic search failed.");
             }
 #endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+            if (useCache)
+            {
+                pathfinding_cache_store(cacheKey, INVALID_DIRECTION);
+            }
             return INVALID_DIRECTION;
         }
+        else if (useCache)
+        {
+            pathfinding_cache_store(cacheKey, chosen_edge);
+        }
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
         if (gPathFindDebug)
         {
@@ -2314,3 +2417,29 @@ void PathfindLoggingDisable()
 #    endif // defined(PATHFIND_DEBUG) && PATHFIND_DEBUG
 }
 #endif // defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
+
+/**
+ * Forgets all cached pathfinding results. Needs to be called whenever anything the
+ * heuristic search looks at changes: paths (including their wide flags), banners,
+ * track, entrances or rides.
+ */
+void PathfindingCacheInvalidate()
+{
+    if (!_pathfindingCache.empty())
+    {
+        _pathfindingCache.clear();
+        _pathfindingCacheStats.Invalidations++;
+    }
+}
+
+PathfindingCacheStats PathfindingCacheGetStats()
+{
+    auto stats = _pathfindingCacheStats;
+    stats.Entries = _pathfindingCache.size();
+    return stats;
+}
+
+void PathfindingCacheResetStats()
+{
+    _pathfindingCacheStats = {};
+}
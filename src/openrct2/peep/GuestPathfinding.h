@@ -51,6 +51,20 @@ bool IsValidPathZAndDirection(TileElement* tileElement, int32_t currentZ, int32_
 // Returns 0 if the guest has successfully had a new destination set up, nonzero otherwise.
 int32_t guest_path_finding(Guest* peep);
 
+// The heuristic search of guests is cached per junction, goal and search parameters until
+// PathfindingCacheInvalidate is called. These counters show how well that works.
+struct PathfindingCacheStats
+{
+    uint64_t Hits;
+    uint64_t Misses;
+    uint64_t Invalidations;
+    size_t Entries;
+};
+
+void PathfindingCacheInvalidate();
+PathfindingCacheStats PathfindingCacheGetStats();
+void PathfindingCacheResetStats();
+
 #if defined(DEBUG_LEVEL_1) && DEBUG_LEVEL_1
 #    define PATHFIND_DEBUG                                                                                                     \
         0 // Set to 0 to disable pathfinding debugging;
@@ -19,6 +19,7 @@
 #include "../audio/audio.h"
 #include "../config/Config.h"
 #include "../core/Guard.hpp"
+#include "../core/TaskScheduler.h"
 #include "../interface/Window.h"
 #include "../localisation/Localisation.h"
 #include "../management/Finance.h"
@@ -27,6 +28,7 @@
 #include "../network/network.h"
 #include "../ride/Ride.h"
 #include "../ride/RideData.h"
+#include "../ride/RideVisibility.h"
 #include "../ride/ShopItem.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
@@ -378,6 +380,65 @@ int32_t peep_get_staff_count()
     return count;
 }
 
+// Planning is only worth the synchronisation once there are enough peeps to spread over the threads.
+static constexpr const size_t PEEP_PLAN_MIN_PEEPS = 512;
+static constexpr const size_t PEEP_PLAN_BATCH_SIZE = 128;
+
+static std::vector<PeepUpdatePlan> _peepUpdatePlans;
+static bool _peepUpdatePlansActive;
+
+const PeepUpdatePlan* GetPeepUpdatePlan(uint16_t spriteIndex)
+{
+    if (!_peepUpdatePlansActive || spriteIndex >= _peepUpdatePlans.size())
+        return nullptr;
+
+    const auto* plan = &_peepUpdatePlans[spriteIndex];
+    return plan->Tick == gCurrentTicks ? plan : nullptr;
+}
+
+static bool peep_plan_has_nearby_rides(const Peep* peep, bool isThinking)
+{
+    return isThinking && peep->AssignedPeepType == PeepType::Guest && peep->x != LOCATION_NULL;
+}
+
+/**
+ * Computes the update plan of every peep on the task scheduler. Peep updates do write to the map (vandalism, emptying
+ * bins, mowing, watering), so a plan may only read what they leave alone: the peep itself, the type and base height of
+ * tile elements and the cached ride visibility spans. Those spans are brought up to date here first, as filling them
+ * writes to the cache.
+ */
+static bool peep_plan_all()
+{
+    const auto& ids = GetEntityList(EntityListId::Peep);
+    if (!gConfigGeneral.multithreading || ids.size() < PEEP_PLAN_MIN_PEEPS)
+    {
+        return false;
+    }
+    _peepUpdatePlans.resize(GetEntityPoolSize());
+
+    const auto numPeeps = ids.size();
+    const auto thinkingTick = gCurrentTicks & 0x7F;
+    for (size_t i = thinkingTick; i < numPeeps; i += 0x80)
+    {
+        auto* peep = GetEntity<Peep>(ids[numPeeps - 1 - i]);
+        if (peep != nullptr && peep_plan_has_nearby_rides(peep, true))
+        {
+            RideVisibilityUpdateRidesNear({ peep->x, peep->y });
+        }
+    }
+
+    GetTaskScheduler().ParallelFor(0, numPeeps, PEEP_PLAN_BATCH_SIZE, [&ids, numPeeps, thinkingTick](size_t j) {
+        auto* peep = GetEntity<Peep>(ids[j]);
+        if (peep == nullptr)
+            return;
+
+        // The list head is at the back of the ids, so this is the peep that peep_update_all visits at index i.
+        auto i = numPeeps - 1 - j;
+        peep->Plan(_peepUpdatePlans[peep->sprite_index], (i & 0x7F) == thinkingTick);
+    });
+    return true;
+}
+
 /**
  *
  *  rct2: 0x0068F0A9
@@ -387,10 +448,15 @@ void peep_update_all()
     if (gScreenFlags & SCREEN_FLAGS_EDITOR)
         return;
 
+    _peepUpdatePlansActive = peep_plan_all();
+
     int32_t i = 0;
     // Warning this loop can delete peeps
     for (auto peep : EntityList<Peep>(EntityListId::Peep))
     {
+        // Besides its own state a peep's update also changes the vehicles it boards, which are marked by their update.
+        MarkEntityChecksumDirty(peep->sprite_index);
+
         if (static_cast<uint32_t>(i & 0x7F) != (gCurrentTicks & 0x7F))
         {
             peep->Update();
@@ -406,6 +472,8 @@ void peep_update_all()
 
         i++;
     }
+
+    _peepUpdatePlansActive = false;
 }
 
 /**
@@ -445,6 +513,33 @@ bool Peep::CheckForPath()
         return true;
     }
 
+    bool hasPath;
+    auto plan = GetPeepUpdatePlan(sprite_index);
+    if (plan != nullptr && plan->HasPathCheck && plan->PathCheckLoc == NextLoc
+        && plan->PathCheckOnSurface == GetNextIsSurface())
+    {
+        hasPath = plan->PathCheckFound;
+#ifdef DEBUG
+        openrct2_assert(hasPath == HasPathAtNextLoc(), "Planned path check of peep %u is out of date", sprite_index);
+#endif
+    }
+    else
+    {
+        hasPath = HasPathAtNextLoc();
+    }
+
+    if (hasPath)
+    {
+        return true;
+    }
+
+    // Found no suitable path
+    SetState(PeepState::Falling);
+    return false;
+}
+
+bool Peep::HasPathAtNextLoc() const
+{
     TileElement* tile_element = map_get_first_element_at(NextLoc);
 
     uint8_t map_type = TILE_ELEMENT_TYPE_PATH;
@@ -466,12 +561,35 @@ bool Peep::CheckForPath()
             }
         }
     } while (!(tile_element++)->IsLastForTile());
-
-    // Found no suitable path
-    SetState(PeepState::Falling);
     return false;
 }
 
+/**
+ * Computes the read-only parts of this peep's next update, called from several threads at once.
+ * @param isThinking whether the peep gets its 128 tick update this tick.
+ */
+void Peep::Plan(PeepUpdatePlan& plan, bool isThinking) const
+{
+    plan.Tick = gCurrentTicks;
+
+    // CheckForPath only looks at the map on every 16th call.
+    plan.HasPathCheck = ((PathCheckOptimisation + 1) & 0xF) == (sprite_index & 0xF);
+    if (plan.HasPathCheck)
+    {
+        plan.PathCheckLoc = NextLoc;
+        plan.PathCheckOnSurface = GetNextIsSurface();
+        plan.PathCheckFound = HasPathAtNextLoc();
+    }
+
+    // Thinking guests look for rides to go on.
+    plan.HasNearbyRides = peep_plan_has_nearby_rides(this, isThinking);
+    if (plan.HasNearbyRides)
+    {
+        plan.NearbyRidesTile = CoordsXY{ x, y }.ToTileStart();
+        plan.NearbyRides = RideVisibilityScanRidesNear({ x, y });
+    }
+}
+
 PeepActionSpriteType Peep::GetActionSpriteType()
 {
     if (Action >= PeepActionType::None1)
@@ -555,6 +555,26 @@ struct rct_peep_thought
 struct Guest;
 struct Staff;
 
+/**
+ * Results of the read-only parts of a peep update, computed for all peeps in parallel before they are updated one by
+ * one (see peep_update_all). Each result keeps the input it was computed from and is only used if the peep still has
+ * that input when it is updated, so a tick has the same outcome whether or not it was planned. Debug builds check every
+ * result that is used against the unplanned lookup.
+ */
+struct PeepUpdatePlan
+{
+    uint32_t Tick;
+
+    bool HasPathCheck;
+    CoordsXYZ PathCheckLoc;
+    bool PathCheckOnSurface;
+    bool PathCheckFound;
+
+    bool HasNearbyRides;
+    CoordsXY NearbyRidesTile;
+    std::bitset<MAX_RIDES> NearbyRides;
+};
+
 struct IntensityRange
 {
 private:
@@ -812,6 +832,7 @@ public: // Peep
     // TODO: Make these private again when done refactoring
 public: // Peep
     bool CheckForPath();
+    void Plan(PeepUpdatePlan& plan, bool isThinking) const;
     void PerformNextAction(uint8_t& pathing_result);
     void PerformNextAction(uint8_t& pathing_result, TileElement*& tile_result);
     int32_t GetZOnSlope(int32_t tile_x, int32_t tile_y);
@@ -819,6 +840,7 @@ public: // Peep
     PeepActionSpriteType GetActionSpriteType();
 
 private:
+    bool HasPathAtNextLoc() const;
     void UpdateFalling();
     void Update1();
     void UpdatePicked();
@@ -843,6 +865,7 @@ public:
     void PickRideToGoOn();
     void ReadMap();
     bool ShouldGoOnRide(Ride* ride, int32_t entranceNum, bool atQueue, bool thinking);
+    std::bitset<MAX_RIDES> GetNearbyRides() const;
     bool ShouldGoToShop(Ride* ride, bool peepAtShop);
     bool ShouldFindBench();
     bool UpdateWalkingFindBench();
@@ -1057,6 +1080,7 @@ Peep* try_get_guest(uint16_t spriteIndex);
 int32_t peep_get_staff_count();
 bool peep_can_be_picked_up(Peep* peep);
 void peep_update_all();
+const PeepUpdatePlan* GetPeepUpdatePlan(uint16_t spriteIndex);
 void peep_problem_warnings_update();
 void peep_stop_crowd_noise();
 void peep_update_crowd_noise();
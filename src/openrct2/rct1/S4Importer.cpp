@@ -32,9 +32,12 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../object/ObjectRepository.h"
+#include "../peep/FootpathGraph.h"
+#include "../peep/GuestPathfinding.h"
 #include "../peep/Peep.h"
 #include "../peep/Staff.h"
 #include "../ride/RideData.h"
+#include "../ride/RideVisibility.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
 #include "../scenario/Scenario.h"
@@ -1350,7 +1353,7 @@ private:
                 ImportPeep(peep, srcPeep);
             }
         }
-        for (size_t i = 0; i < MAX_SPRITES; i++)
+        for (size_t i = 0; i < GetEntityPoolSize(); i++)
         {
             auto vehicle = GetEntity<Vehicle>(i);
             if (vehicle != nullptr)
@@ -2745,18 +2748,22 @@ private:
 
     void ClearExtraTileEntries()
     {
+        RideVisibilityInvalidateAll();
+        PathfindingCacheInvalidate();
+        FootpathGraphInvalidateAll();
+
         // Reset the map tile pointers
         std::fill(std::begin(gTileElementTilePointers), std::end(gTileElementTilePointers), nullptr);
 
         // Get the first free map element
-        TileElement* nextFreeTileElement = gTileElements;
+        TileElement* nextFreeTileElement = gTileElements.data();
         for (size_t i = 0; i < RCT1_MAX_MAP_SIZE * RCT1_MAX_MAP_SIZE; i++)
         {
             while (!(nextFreeTileElement++)->IsLastForTile())
                 ;
         }
 
-        TileElement* tileElement = gTileElements;
+        TileElement* tileElement = gTileElements.data();
         TileElement** tilePointer = gTileElementTilePointers;
 
         // 128 rows of map data from RCT1 map
@@ -2798,6 +2805,7 @@ private:
         }
 
         gNextFreeTileElement = nextFreeTileElement;
+        MapResetFreeTileElements();
     }
 
     void FixWalls()
@@ -2816,7 +2824,7 @@ private:
                     if (tileElement->GetType() == TILE_ELEMENT_TYPE_WALL)
                     {
                         wallsOnTile.push_back(*tileElement);
-                        tile_element_remove(tileElement);
+                        tile_element_remove(TileCoordsXY{ x, y }.ToCoordsXY(), tileElement);
                         tileElement--;
                     }
                 } while (!(tileElement++)->IsLastForTile());
@@ -52,6 +52,8 @@
 #include <functional>
 #include <iterator>
 #include <optional>
+#include <stdexcept>
+#include <string>
 
 S6Exporter::S6Exporter()
 {
@@ -408,7 +410,14 @@ void S6Exporter::Export()
 
         dst->Type = static_cast<uint8_t>(src->Type);
         dst->Flags = src->Flags;
-        dst->Assoc = src->Assoc;
+        if (src->Type == News::ItemType::Peep || src->Type == News::ItemType::PeepOnRide)
+        {
+            dst->Assoc = ExportEntityId(src->Assoc);
+        }
+        else
+        {
+            dst->Assoc = src->Assoc;
+        }
         dst->Ticks = src->Ticks;
         dst->MonthYear = src->MonthYear;
         dst->Day = src->Day;
@@ -583,7 +592,7 @@ void S6Exporter::ExportRide(rct2_ride* dst, const Ride* src)
         else
             dst->exits[i] = { static_cast<uint8_t>(exit.x), static_cast<uint8_t>(exit.y) };
 
-        dst->last_peep_in_queue[i] = src->stations[i].LastPeepInQueue;
+        dst->last_peep_in_queue[i] = ExportEntityId(src->stations[i].LastPeepInQueue);
 
         dst->length[i] = src->stations[i].SegmentLength;
         dst->time[i] = src->stations[i].SegmentTime;
@@ -595,7 +604,7 @@ void S6Exporter::ExportRide(rct2_ride* dst, const Ride* src)
 
     for (uint8_t i = 0; i <= RCT2_MAX_VEHICLES_PER_RIDE; i++)
     {
-        dst->vehicles[i] = src->vehicles[i];
+        dst->vehicles[i] = ExportEntityId(src->vehicles[i]);
     }
 
     dst->depart_flags = src->depart_flags;
@@ -706,13 +715,13 @@ void S6Exporter::ExportRide(rct2_ride* dst, const Ride* src)
     // pad_177[0x9];
     dst->build_date = static_cast<int16_t>(src->build_date);
     dst->upkeep_cost = src->upkeep_cost;
-    dst->race_winner = src->race_winner;
+    dst->race_winner = ExportEntityId(src->race_winner);
     // pad_186[0x02];
     dst->music_position = src->music_position;
 
     dst->breakdown_reason_pending = src->breakdown_reason_pending;
     dst->mechanic_status = src->mechanic_status;
-    dst->mechanic = src->mechanic;
+    dst->mechanic = ExportEntityId(src->mechanic);
     dst->inspection_station = src->inspection_station;
     dst->broken_vehicle = src->broken_vehicle;
     dst->broken_car = src->broken_car;
@@ -769,7 +778,7 @@ void S6Exporter::ExportRide(rct2_ride* dst, const Ride* src)
     dst->cable_lift_y = static_cast<int16_t>(src->CableLiftLoc.y);
     dst->cable_lift_z = static_cast<int16_t>(src->CableLiftLoc.z / COORDS_Z_STEP);
     // pad_1FD;
-    dst->cable_lift = src->cable_lift;
+    dst->cable_lift = ExportEntityId(src->cable_lift);
 
     // pad_208[0x58];
 }
@@ -947,6 +956,14 @@ void S6Exporter::ExportSprites()
     // compression ratios. Especially useful for multiplayer servers that
     // use zlib on the sent stream.
     sprite_clear_all_unused();
+
+    _entityIdMap.clear();
+    if (GetEntityPoolSize() > RCT2_MAX_SPRITES)
+    {
+        ExportSpritesDownConverted();
+        return;
+    }
+
     for (int32_t i = 0; i < RCT2_MAX_SPRITES; i++)
     {
         ExportSprite(&_s6.sprites[i], reinterpret_cast<const rct_sprite*>(GetEntity(i)));
@@ -959,6 +976,153 @@ void S6Exporter::ExportSprites()
     }
 }
 
+/**
+ * The entity pool has grown beyond the RCT2_MAX_SPRITES slots of an S6 save. The entities in use are renumbered into
+ * the slots below the limit, every entity id that gets exported (lists, trains, ride vehicles, queues, news) is
+ * translated through _entityIdMap. When there are more entities in use than slots, misc entities and then litter are
+ * left out, oldest first. Nothing refers to those by id. Guests, staff and vehicles are never left out, a park with
+ * more of those than an S6 save can hold can not be saved.
+ */
+void S6Exporter::ExportSpritesDownConverted()
+{
+    const auto poolSize = GetEntityPoolSize();
+    _entityIdMap.assign(poolSize, SPRITE_INDEX_NULL);
+
+    std::vector<bool> inUse(poolSize);
+    size_t numInUse = 0;
+    for (size_t i = 0; i < poolSize; i++)
+    {
+        inUse[i] = GetEntity(i)->sprite_identifier != SPRITE_IDENTIFIER_NULL;
+        numInUse += inUse[i] ? 1 : 0;
+    }
+
+    for (auto listId : { EntityListId::Misc, EntityListId::Litter })
+    {
+        // The tail of the list, the oldest entity, is at the front.
+        for (auto spriteIndex : GetEntityList(listId))
+        {
+            if (numInUse <= RCT2_MAX_SPRITES)
+            {
+                break;
+            }
+            inUse[spriteIndex] = false;
+            numInUse--;
+        }
+    }
+    if (numInUse > RCT2_MAX_SPRITES)
+    {
+        throw std::runtime_error(
+            "Park has " + std::to_string(numInUse) + " guests, staff and vehicles, an S6 save can only hold "
+            + std::to_string(RCT2_MAX_SPRITES) + ".");
+    }
+
+    // Entities below the limit keep their id, the ones above take the lowest free slots.
+    std::vector<uint16_t> freeSlots;
+    for (uint16_t i = 0; i < RCT2_MAX_SPRITES; i++)
+    {
+        if (inUse[i])
+        {
+            _entityIdMap[i] = i;
+        }
+        else
+        {
+            freeSlots.push_back(i);
+        }
+    }
+    auto nextFreeSlot = freeSlots.begin();
+    for (size_t i = RCT2_MAX_SPRITES; i < poolSize; i++)
+    {
+        if (inUse[i])
+        {
+            _entityIdMap[i] = *nextFreeSlot++;
+        }
+    }
+
+    for (size_t i = 0; i < poolSize; i++)
+    {
+        if (_entityIdMap[i] != SPRITE_INDEX_NULL)
+        {
+            ExportSprite(&_s6.sprites[_entityIdMap[i]], reinterpret_cast<const rct_sprite*>(GetEntity(i)));
+        }
+    }
+    std::vector<uint16_t> freeList(nextFreeSlot, freeSlots.end());
+    for (auto slot : freeList)
+    {
+        // Either free in the pool as well or a left out entity, both are exported as a cleared slot.
+        auto* dst = &_s6.sprites[slot].unknown;
+        std::memset(&_s6.sprites[slot], 0, sizeof(RCT2Sprite));
+        dst->sprite_identifier = SPRITE_IDENTIFIER_NULL;
+        dst->sprite_index = slot;
+        dst->next_in_quadrant = SPRITE_INDEX_NULL;
+        dst->linked_list_type_offset = static_cast<uint8_t>(EntityListId::Free) * 2;
+    }
+
+    for (int32_t i = 0; i < static_cast<uint8_t>(EntityListId::Count); i++)
+    {
+        const auto listId = static_cast<EntityListId>(i);
+        std::vector<uint16_t> exportedIds;
+        if (listId == EntityListId::Free)
+        {
+            exportedIds = freeList;
+        }
+        else
+        {
+            // Walk in linked list order, the head is stored at the back.
+            const auto& ids = GetEntityList(listId);
+            for (auto it = ids.rbegin(); it != ids.rend(); it++)
+            {
+                if (_entityIdMap[*it] != SPRITE_INDEX_NULL)
+                {
+                    exportedIds.push_back(_entityIdMap[*it]);
+                }
+            }
+        }
+
+        uint16_t previous = SPRITE_INDEX_NULL;
+        for (auto spriteIndex : exportedIds)
+        {
+            auto* dst = &_s6.sprites[spriteIndex].unknown;
+            dst->previous = previous;
+            dst->next = SPRITE_INDEX_NULL;
+            if (previous != SPRITE_INDEX_NULL)
+            {
+                _s6.sprites[previous].unknown.next = spriteIndex;
+            }
+            previous = spriteIndex;
+        }
+        _s6.sprite_lists_head[i] = exportedIds.empty() ? SPRITE_INDEX_NULL : exportedIds.front();
+        _s6.sprite_lists_count[i] = static_cast<uint16_t>(exportedIds.size());
+    }
+
+    // Quadrant chains skip the entities that were left out.
+    for (size_t i = 0; i < poolSize; i++)
+    {
+        if (_entityIdMap[i] == SPRITE_INDEX_NULL)
+        {
+            continue;
+        }
+        uint16_t nextInQuadrant = GetEntity(i)->next_in_quadrant;
+        while (nextInQuadrant != SPRITE_INDEX_NULL && ExportEntityId(nextInQuadrant) == SPRITE_INDEX_NULL)
+        {
+            auto* next = GetEntity(nextInQuadrant);
+            nextInQuadrant = next != nullptr ? next->next_in_quadrant : SPRITE_INDEX_NULL;
+        }
+        _s6.sprites[_entityIdMap[i]].unknown.next_in_quadrant = ExportEntityId(nextInQuadrant);
+    }
+}
+
+/**
+ * The id an entity has in the exported save, see ExportSpritesDownConverted.
+ */
+uint16_t S6Exporter::ExportEntityId(uint16_t spriteIndex) const
+{
+    if (spriteIndex >= _entityIdMap.size())
+    {
+        return spriteIndex;
+    }
+    return _entityIdMap[spriteIndex];
+}
+
 void S6Exporter::ExportSprite(RCT2Sprite* dst, const rct_sprite* src)
 {
     std::memset(dst, 0, sizeof(rct_sprite));
@@ -990,12 +1154,12 @@ void S6Exporter::ExportSpriteCommonProperties(RCT12SpriteBase* dst, const Sprite
 {
     dst->sprite_identifier = src->sprite_identifier;
     dst->type = src->type;
-    dst->next_in_quadrant = src->next_in_quadrant;
-    dst->next = src->next;
-    dst->previous = src->previous;
+    dst->next_in_quadrant = ExportEntityId(src->next_in_quadrant);
+    dst->next = ExportEntityId(src->next);
+    dst->previous = ExportEntityId(src->previous);
     dst->linked_list_type_offset = static_cast<uint8_t>(src->linked_list_index) * 2;
     dst->sprite_height_negative = src->sprite_height_negative;
-    dst->sprite_index = src->sprite_index;
+    dst->sprite_index = ExportEntityId(src->sprite_index);
     dst->flags = src->flags;
     dst->x = src->x;
     dst->y = src->y;
@@ -1044,9 +1208,9 @@ void S6Exporter::ExportSpriteVehicle(RCT2SpriteVehicle* dst, const Vehicle* src)
     dst->track_x = src->TrackLocation.x;
     dst->track_y = src->TrackLocation.y;
     dst->track_z = src->TrackLocation.z;
-    dst->next_vehicle_on_train = src->next_vehicle_on_train;
-    dst->prev_vehicle_on_ride = src->prev_vehicle_on_ride;
-    dst->next_vehicle_on_ride = src->next_vehicle_on_ride;
+    dst->next_vehicle_on_train = ExportEntityId(src->next_vehicle_on_train);
+    dst->prev_vehicle_on_ride = ExportEntityId(src->prev_vehicle_on_ride);
+    dst->next_vehicle_on_ride = ExportEntityId(src->next_vehicle_on_ride);
     dst->var_44 = src->var_44;
     dst->mass = src->mass;
     dst->update_flags = src->update_flags;
@@ -1058,7 +1222,7 @@ void S6Exporter::ExportSpriteVehicle(RCT2SpriteVehicle* dst, const Vehicle* src)
     dst->sub_state = src->sub_state;
     for (size_t i = 0; i < std::size(src->peep); i++)
     {
-        dst->peep[i] = src->peep[i];
+        dst->peep[i] = ExportEntityId(src->peep[i]);
         dst->peep_tshirt_colours[i] = src->peep_tshirt_colours[i];
     }
     dst->num_seats = src->num_seats;
@@ -1073,7 +1237,15 @@ void S6Exporter::ExportSpriteVehicle(RCT2SpriteVehicle* dst, const Vehicle* src)
     dst->sound2_id = static_cast<uint8_t>(src->sound2_id);
     dst->sound2_volume = src->sound2_volume;
     dst->sound_vector_factor = src->sound_vector_factor;
-    dst->time_waiting = src->time_waiting;
+    // The cable lift uses a ride entry index of NULL, this field holds the train it pulls.
+    if (src->ride_subtype == RIDE_ENTRY_INDEX_NULL)
+    {
+        dst->cable_lift_target = ExportEntityId(src->cable_lift_target);
+    }
+    else
+    {
+        dst->time_waiting = src->time_waiting;
+    }
     dst->speed = src->speed;
     dst->powered_acceleration = src->powered_acceleration;
     dst->dodgems_collision_direction = src->dodgems_collision_direction;
@@ -1187,7 +1359,14 @@ void S6Exporter::ExportSpritePeep(RCT2SpritePeep* dst, const Peep* src)
     dst->action = static_cast<uint8_t>(src->Action);
     dst->action_frame = src->ActionFrame;
     dst->step_progress = src->StepProgress;
-    dst->next_in_queue = src->GuestNextInQueue;
+    if (src->AssignedPeepType == PeepType::Guest)
+    {
+        dst->next_in_queue = ExportEntityId(src->GuestNextInQueue);
+    }
+    else
+    {
+        dst->next_in_queue = src->GuestNextInQueue;
+    }
     dst->direction = src->PeepDirection;
     dst->interaction_ride_index = src->InteractionRideIndex;
     dst->time_in_queue = src->TimeInQueue;
@@ -1413,6 +1592,15 @@ void S6Exporter::ExportMapAnimations()
 
 void S6Exporter::ExportTileElements()
 {
+    // The tile element heap can grow past what fits in an .sv6 file, which is only checked here.
+    const auto numElements = static_cast<size_t>(gNextFreeTileElement - gTileElements.data());
+    if (numElements > RCT2_MAX_TILE_ELEMENTS)
+    {
+        throw std::runtime_error(
+            "Park has " + std::to_string(numElements) + " tile elements, only " + std::to_string(RCT2_MAX_TILE_ELEMENTS)
+            + " can be saved.");
+    }
+
     for (uint32_t index = 0; index < RCT2_MAX_TILE_ELEMENTS; index++)
     {
         auto src = &gTileElements[index];
@@ -43,10 +43,18 @@ public:
     void SaveScenario(const utf8* path);
     void SaveScenario(OpenRCT2::IStream* stream);
     void Export();
+
+    // The exported data, as SaveGame writes it.
+    rct_s6_data& GetData()
+    {
+        return _s6;
+    }
+
     void ExportParkName();
     void ExportRides();
     void ExportRide(rct2_ride* dst, const Ride* src);
     void ExportSprites();
+    void ExportSpritesDownConverted();
     void ExportSprite(RCT2Sprite* dst, const rct_sprite* src);
     void ExportSpriteCommonProperties(RCT12SpriteBase* dst, const SpriteBase* src);
     void ExportSpriteVehicle(RCT2SpriteVehicle* dst, const Vehicle* src);
@@ -57,6 +65,8 @@ public:
 private:
     rct_s6_data _s6{};
     std::vector<std::string> _userStrings;
+    // Id in the save of each entity in the pool, only filled when the pool has grown past the S6 limit.
+    std::vector<uint16_t> _entityIdMap;
 
     void Save(OpenRCT2::IStream* stream, bool isScenario);
     static uint32_t GetLoanHash(money32 initialCash, money32 bankLoan, uint32_t maxBankLoan);
@@ -72,6 +82,7 @@ private:
     void ExportBanners();
     void ExportBanner(RCT12Banner& dst, const Banner& src);
     void ExportMapAnimations();
+    uint16_t ExportEntityId(uint16_t spriteIndex) const;
 
     void ExportTileElements();
     void ExportTileElement(RCT12TileElement* dst, TileElement* src);
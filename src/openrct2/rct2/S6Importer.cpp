@@ -1292,6 +1292,9 @@ public:
 
     void ImportSprites()
     {
+        // Shrink the entity pool back to its initial size, it may have grown in the previous park.
+        reset_sprite_list();
+        static_assert(ENTITY_POOL_INITIAL_SIZE >= RCT2_MAX_SPRITES);
         for (int32_t i = 0; i < RCT2_MAX_SPRITES; i++)
         {
             auto src = &_s6.sprites[i];
@@ -1305,7 +1308,9 @@ public:
             gSpriteListCount[i] = _s6.sprite_lists_count[i];
         }
         // This list contains the number of free slots. Increase it according to our own sprite limit.
-        gSpriteListCount[static_cast<uint8_t>(EntityListId::Free)] += (MAX_SPRITES - RCT2_MAX_SPRITES);
+        gSpriteListCount[static_cast<uint8_t>(EntityListId::Free)] += static_cast<uint16_t>(
+            GetEntityPoolSize() - RCT2_MAX_SPRITES);
+        RebuildEntityLists();
     }
 
     void ImportSprite(rct_sprite* dst, const RCT2Sprite* src)
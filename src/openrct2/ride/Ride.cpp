@@ -7035,7 +7035,7 @@ void sub_6CB945(Ride* ride)
                 footpath_remove_edges_at(location, tileElement);
                 footpath_update_queue_chains();
                 map_invalidate_tile_full(location);
-                tile_element_remove(tileElement);
+                tile_element_remove(location, tileElement);
                 tileElement--;
             }
         } while (!(tileElement++)->IsLastForTile());
@@ -7576,7 +7576,7 @@ void ride_clear_leftover_entrances(Ride* ride)
             && it.element->AsEntrance()->GetEntranceType() != ENTRANCE_TYPE_PARK_ENTRANCE
             && it.element->AsEntrance()->GetRideIndex() == ride->id)
         {
-            tile_element_remove(it.element);
+            tile_element_remove(TileCoordsXY{ it.x, it.y }.ToCoordsXY(), it.element);
             tile_element_iterator_restart_for_tile(&it);
         }
     }
@@ -0,0 +1,178 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "RideVisibility.h"
+
+#include "../core/Guard.hpp"
+#include "../world/Map.h"
+#include "Track.h"
+
+#include <vector>
+
+// For every tile (x, y), the rides with track on tiles x - RIDE_VISIBILITY_RADIUS to x + RIDE_VISIBILITY_RADIUS of row y.
+// The rides near a tile are the union of the spans of the rows around it, and placing or removing track only affects
+// the spans of its own row. Spans are (re)computed lazily the first time they are needed after being invalidated.
+static std::vector<std::bitset<MAX_RIDES>> _rowSpans;
+static std::vector<bool> _rowSpanDirty;
+
+static size_t GetRowSpanIndex(int32_t tileX, int32_t tileY)
+{
+    return tileX * MAXIMUM_MAP_SIZE_TECHNICAL + tileY;
+}
+
+static bool IsTileInRange(int32_t tile)
+{
+    return tile >= 0 && tile < MAXIMUM_MAP_SIZE_TECHNICAL;
+}
+
+static void AddRidesOnTile(const CoordsXY& loc, std::bitset<MAX_RIDES>& rides)
+{
+    if (!map_is_location_valid(loc))
+        return;
+
+    auto tileElement = map_get_first_element_at(loc);
+    if (tileElement == nullptr)
+        return;
+    do
+    {
+        if (tileElement->GetType() == TILE_ELEMENT_TYPE_TRACK)
+        {
+            auto rideIndex = tileElement->AsTrack()->GetRideIndex();
+            if (rideIndex < MAX_RIDES)
+            {
+                rides[rideIndex] = true;
+            }
+        }
+    } while (!(tileElement++)->IsLastForTile());
+}
+
+static std::bitset<MAX_RIDES> ScanRowSpan(int32_t tileX, int32_t tileY)
+{
+    std::bitset<MAX_RIDES> rides;
+    for (auto x = tileX - RIDE_VISIBILITY_RADIUS; x <= tileX + RIDE_VISIBILITY_RADIUS; x++)
+    {
+        AddRidesOnTile(TileCoordsXY{ x, tileY }.ToCoordsXY(), rides);
+    }
+    return rides;
+}
+
+static const std::bitset<MAX_RIDES>& GetRowSpan(int32_t tileX, int32_t tileY)
+{
+    if (_rowSpans.empty())
+    {
+        _rowSpans.resize(MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL);
+        _rowSpanDirty.assign(MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL, true);
+    }
+
+    auto index = GetRowSpanIndex(tileX, tileY);
+    if (_rowSpanDirty[index])
+    {
+        _rowSpans[index] = ScanRowSpan(tileX, tileY);
+        _rowSpanDirty[index] = false;
+    }
+    return _rowSpans[index];
+}
+
+static std::bitset<MAX_RIDES> GetRidesNear(const CoordsXY& loc, bool updateSpans)
+{
+    std::bitset<MAX_RIDES> rides;
+    int32_t centreX = floor2(loc.x, COORDS_XY_STEP) / COORDS_XY_STEP;
+    int32_t centreY = floor2(loc.y, COORDS_XY_STEP) / COORDS_XY_STEP;
+    for (auto y = centreY - RIDE_VISIBILITY_RADIUS; y <= centreY + RIDE_VISIBILITY_RADIUS; y++)
+    {
+        if (!IsTileInRange(y))
+            continue;
+
+        // Spans are only kept for tiles on the map, a location off the map is rare enough to scan.
+        if (!IsTileInRange(centreX))
+        {
+            rides |= ScanRowSpan(centreX, y);
+        }
+        else if (updateSpans)
+        {
+            rides |= GetRowSpan(centreX, y);
+        }
+        else if (!_rowSpans.empty() && !_rowSpanDirty[GetRowSpanIndex(centreX, y)])
+        {
+            rides |= _rowSpans[GetRowSpanIndex(centreX, y)];
+        }
+        else
+        {
+            openrct2_assert(false, "Ride visibility span %d, %d was not updated before reading it", centreX, y);
+            rides |= ScanRowSpan(centreX, y);
+        }
+    }
+    return rides;
+}
+
+/**
+ * Returns the rides that have track within RIDE_VISIBILITY_RADIUS tiles of the tile containing loc.
+ */
+std::bitset<MAX_RIDES> RideVisibilityGetRidesNear(const CoordsXY& loc)
+{
+    return GetRidesNear(loc, true);
+}
+
+/**
+ * Same as RideVisibilityGetRidesNear, but only reads the cached spans, which have to be brought up to date with
+ * RideVisibilityUpdateRidesNear first. Several threads can call this at once as long as the track on the map and
+ * the cache are not modified in the meantime.
+ */
+std::bitset<MAX_RIDES> RideVisibilityScanRidesNear(const CoordsXY& loc)
+{
+    return GetRidesNear(loc, false);
+}
+
+/**
+ * Recomputes the invalidated spans RideVisibilityScanRidesNear reads for loc.
+ */
+void RideVisibilityUpdateRidesNear(const CoordsXY& loc)
+{
+    int32_t centreX = floor2(loc.x, COORDS_XY_STEP) / COORDS_XY_STEP;
+    int32_t centreY = floor2(loc.y, COORDS_XY_STEP) / COORDS_XY_STEP;
+    if (!IsTileInRange(centreX))
+        return;
+
+    for (auto y = centreY - RIDE_VISIBILITY_RADIUS; y <= centreY + RIDE_VISIBILITY_RADIUS; y++)
+    {
+        if (IsTileInRange(y))
+        {
+            GetRowSpan(centreX, y);
+        }
+    }
+}
+
+/**
+ * Needs to be called whenever track is added to or removed from the tile at loc, or its ride changes.
+ */
+void RideVisibilityInvalidateTile(const CoordsXY& loc)
+{
+    if (_rowSpans.empty())
+        return;
+
+    auto tileLoc = TileCoordsXY(loc);
+    if (!IsTileInRange(tileLoc.y))
+        return;
+
+    for (auto x = tileLoc.x - RIDE_VISIBILITY_RADIUS; x <= tileLoc.x + RIDE_VISIBILITY_RADIUS; x++)
+    {
+        if (IsTileInRange(x))
+        {
+            _rowSpanDirty[GetRowSpanIndex(x, tileLoc.y)] = true;
+        }
+    }
+}
+
+/**
+ * Needs to be called whenever the map is replaced or track is removed without knowing where it was.
+ */
+void RideVisibilityInvalidateAll()
+{
+    std::fill(_rowSpanDirty.begin(), _rowSpanDirty.end(), true);
+}
@@ -0,0 +1,26 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "Ride.h"
+
+#include <bitset>
+
+struct CoordsXY;
+
+// Guests notice rides with track within this many tiles (on both axes) of the tile they are on.
+constexpr const int32_t RIDE_VISIBILITY_RADIUS = 10;
+
+std::bitset<MAX_RIDES> RideVisibilityGetRidesNear(const CoordsXY& loc);
+std::bitset<MAX_RIDES> RideVisibilityScanRidesNear(const CoordsXY& loc);
+void RideVisibilityUpdateRidesNear(const CoordsXY& loc);
+void RideVisibilityInvalidateTile(const CoordsXY& loc);
+void RideVisibilityInvalidateAll();
@@ -41,6 +41,8 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../object/ObjectRepository.h"
+#include "../peep/FootpathGraph.h"
+#include "../peep/GuestPathfinding.h"
 #include "../rct1/RCT1.h"
 #include "../rct1/Tables.h"
 #include "../util/SawyerCoding.h"
@@ -53,6 +55,7 @@
 #include "../world/Wall.h"
 #include "Ride.h"
 #include "RideData.h"
+#include "RideVisibility.h"
 #include "Track.h"
 #include "TrackData.h"
 #include "TrackDesignRepository.h"
@@ -66,7 +69,9 @@ using namespace OpenRCT2::Drawing;
 
 struct map_backup
 {
-    TileElement tile_elements[MAX_TILE_ELEMENTS];
+    std::vector<TileElement> tile_elements;
+    // Pointers into the elements as they were, the heap may be reallocated before they are restored.
+    TileElement* tile_elements_base;
     TileElement* tile_pointers[MAX_TILE_TILE_ELEMENT_POINTERS];
     TileElement* next_free_tile_element;
     uint16_t map_size_units;
@@ -2100,7 +2105,8 @@ static std::unique_ptr<map_backup> track_design_preview_backup_map()
     auto backup = std::make_unique<map_backup>();
     if (backup != nullptr)
     {
-        std::memcpy(backup->tile_elements, gTileElements, sizeof(backup->tile_elements));
+        backup->tile_elements = gTileElements;
+        backup->tile_elements_base = gTileElements.data();
         std::memcpy(backup->tile_pointers, gTileElementTilePointers, sizeof(backup->tile_pointers));
         backup->next_free_tile_element = gNextFreeTileElement;
         backup->map_size_units = gMapSizeUnits;
@@ -2117,13 +2123,23 @@ static std::unique_ptr<map_backup> track_design_preview_backup_map()
  */
 static void track_design_preview_restore_map(map_backup* backup)
 {
-    std::memcpy(gTileElements, backup->tile_elements, sizeof(backup->tile_elements));
-    std::memcpy(gTileElementTilePointers, backup->tile_pointers, sizeof(backup->tile_pointers));
-    gNextFreeTileElement = backup->next_free_tile_element;
+    gTileElements = backup->tile_elements;
+    auto rebase = [backup](TileElement* tileElement) -> TileElement* {
+        return tileElement == nullptr ? nullptr : gTileElements.data() + (tileElement - backup->tile_elements_base);
+    };
+    for (size_t i = 0; i < std::size(gTileElementTilePointers); i++)
+    {
+        gTileElementTilePointers[i] = rebase(backup->tile_pointers[i]);
+    }
+    gNextFreeTileElement = rebase(backup->next_free_tile_element);
+    MapResetFreeTileElements();
     gMapSizeUnits = backup->map_size_units;
     gMapSizeMinus2 = backup->map_size_units_minus_2;
     gMapSize = backup->map_size;
     gCurrentRotation = backup->current_rotation;
+    RideVisibilityInvalidateAll();
+    PathfindingCacheInvalidate();
+    FootpathGraphInvalidateAll();
 }
 
 /**
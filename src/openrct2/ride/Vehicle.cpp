@@ -1361,6 +1361,10 @@ void vehicle_update_all()
 
     for (auto vehicle : EntityList<Vehicle>(EntityListId::TrainHead))
     {
+        for (auto car = vehicle; car != nullptr; car = GetEntity<Vehicle>(car->next_vehicle_on_train))
+        {
+            MarkEntityChecksumDirty(car->sprite_index);
+        }
         vehicle->Update();
     }
 }
@@ -50,7 +50,7 @@ namespace OpenRCT2::Scripting
 
         int32_t numEntities_get() const
         {
-            return MAX_SPRITES;
+            return static_cast<int32_t>(GetEntityPoolSize());
         }
 
         std::vector<std::shared_ptr<ScRide>> rides_get() const
@@ -83,7 +83,7 @@ namespace OpenRCT2::Scripting
 
         DukValue getEntity(int32_t id) const
         {
-            if (id >= 0 && id < MAX_SPRITES)
+            if (id >= 0 && static_cast<size_t>(id) < GetEntityPoolSize())
             {
                 auto spriteId = static_cast<uint16_t>(id);
                 auto sprite = GetEntity(spriteId);
@@ -14,6 +14,9 @@
 #    include "../Context.h"
 #    include "../common.h"
 #    include "../core/Guard.hpp"
+#    include "../peep/FootpathGraph.h"
+#    include "../peep/GuestPathfinding.h"
+#    include "../ride/RideVisibility.h"
 #    include "../world/Footpath.h"
 #    include "../world/Scenery.h"
 #    include "../world/Sprite.h"
@@ -590,7 +593,7 @@ namespace OpenRCT2::Scripting
             {
                 TileElement* const elementToRemove = _element - 1;
                 Guard::Assert(elementToRemove->GetType() == TILE_ELEMENT_TYPE_CORRUPT);
-                tile_element_remove(elementToRemove);
+                tile_element_remove(_coords, elementToRemove);
                 _element--;
             }
 
@@ -993,6 +996,10 @@ namespace OpenRCT2::Scripting
         void Invalidate()
         {
             map_invalidate_tile_full(_coords);
+            RideVisibilityInvalidateTile(_coords);
+            PathfindingCacheInvalidate();
+            FootpathGraphInvalidateTile(_coords);
+            MapInvalidateTileElementSummaries();
         }
 
     public:
@@ -1176,6 +1183,10 @@ namespace OpenRCT2::Scripting
                     }
                 }
                 map_invalidate_tile_full(_coords);
+                RideVisibilityInvalidateTile(_coords);
+                PathfindingCacheInvalidate();
+                FootpathGraphInvalidateTile(_coords);
+                MapInvalidateTileElementSummaries();
             }
         }
 
@@ -1245,8 +1256,12 @@ namespace OpenRCT2::Scripting
             auto first = GetFirstElement();
             if (index < GetNumElements(first))
             {
-                tile_element_remove(&first[index]);
+                tile_element_remove(_coords, &first[index]);
                 map_invalidate_tile_full(_coords);
+                RideVisibilityInvalidateTile(_coords);
+                PathfindingCacheInvalidate();
+                FootpathGraphInvalidateTile(_coords);
+                MapInvalidateTileElementSummaries();
             }
         }
 
@@ -23,6 +23,8 @@
 #include "../object/ObjectList.h"
 #include "../object/ObjectManager.h"
 #include "../paint/VirtualFloor.h"
+#include "../peep/FootpathGraph.h"
+#include "../peep/GuestPathfinding.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
@@ -35,6 +37,7 @@
 
 #include <algorithm>
 #include <iterator>
+#include <optional>
 
 void footpath_update_queue_entrance_banner(const CoordsXY& footpathPos, TileElement* tileElement);
 
@@ -1645,6 +1648,28 @@ static void footpath_clear_wide(const CoordsXY& footpathPos)
     } while (!(tileElement++)->IsLastForTile());
 }
 
+/**
+ * Returns one bit per element at the location, set for the paths that are wide.
+ * Tiles with more elements than there are bits are reported as std::nullopt.
+ */
+static std::optional<uint64_t> footpath_get_wide_flags(const CoordsXY& footpathPos)
+{
+    uint64_t wideFlags = 0;
+    TileElement* tileElement = map_get_first_element_at(footpathPos);
+    if (tileElement == nullptr)
+        return wideFlags;
+    int32_t index = 0;
+    do
+    {
+        if (index >= 64)
+            return std::nullopt;
+        if (tileElement->GetType() == TILE_ELEMENT_TYPE_PATH && tileElement->AsPath()->IsWide())
+            wideFlags |= 1ULL << index;
+        index++;
+    } while (!(tileElement++)->IsLastForTile());
+    return wideFlags;
+}
+
 /**
  *
  *  rct2: 0x006A8ACF
@@ -1681,6 +1706,7 @@ void footpath_update_path_wide_flags(const CoordsXY& footpathPos)
     if (map_is_location_at_edge(footpathPos))
         return;
 
+    auto oldWideFlags = footpath_get_wide_flags(footpathPos);
     footpath_clear_wide(footpathPos);
     /* Rather than clearing the wide flag of the following tiles and
      * checking the state of them later, leave them intact and assume
@@ -1859,6 +1885,14 @@ void footpath_update_path_wide_flags(const CoordsXY& footpathPos)
                 tileElement->AsPath()->SetWide(true);
         }
     } while (!(tileElement++)->IsLastForTile());
+
+    // Wide paths are walked differently, so cached pathfinding results are only valid while the flags stay the same.
+    auto newWideFlags = footpath_get_wide_flags(footpathPos);
+    if (!oldWideFlags.has_value() || !newWideFlags.has_value() || *oldWideFlags != *newWideFlags)
+    {
+        PathfindingCacheInvalidate();
+        FootpathGraphInvalidateTile(footpathPos);
+    }
 }
 
 bool footpath_is_blocked_by_vehicle(const TileCoordsXYZ& position)
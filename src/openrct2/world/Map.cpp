@@ -37,6 +37,9 @@
 #include "../object/ObjectManager.h"
 #include "../object/TerrainSurfaceObject.h"
 #include "../ride/RideData.h"
+#include "../peep/FootpathGraph.h"
+#include "../peep/GuestPathfinding.h"
+#include "../ride/RideVisibility.h"
 #include "../ride/Track.h"
 #include "../ride/TrackData.h"
 #include "../ride/TrackDesign.h"
@@ -48,6 +51,7 @@
 #include "Footpath.h"
 #include "LargeScenery.h"
 #include "MapAnimation.h"
+#include "MapChangeJournal.h"
 #include "Park.h"
 #include "Scenery.h"
 #include "SmallScenery.h"
@@ -56,6 +60,9 @@
 #include "Wall.h"
 
 #include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstring>
 #include <iterator>
 #include <memory>
 
@@ -99,7 +106,9 @@ int16_t gMapSize;
 int16_t gMapSizeMaxXY;
 int16_t gMapBaseZ;
 
-TileElement gTileElements[MAX_TILE_ELEMENTS_WITH_SPARE_ROOM];
+std::vector<TileElement> gTileElements(TILE_ELEMENT_HEAP_INITIAL_SIZE);
+// Part of the game state, a network client takes the limit of the server.
+static size_t _tileElementLimit = TILE_ELEMENT_HEAP_INITIAL_SIZE;
 TileElement* gTileElementTilePointers[MAX_TILE_TILE_ELEMENT_POINTERS];
 std::vector<CoordsXY> gMapSelectionTiles;
 std::vector<PeepSpawn> gPeepSpawns;
@@ -107,6 +116,24 @@ std::vector<PeepSpawn> gPeepSpawns;
 TileElement* gNextFreeTileElement;
 uint32_t gNextFreeTileElementPointerIndex;
 
+// The number of elements reserved for each tile. A tile that has to be moved to grow gets room for twice as many
+// elements, later inserts fill that room in place and removals hand it back to the tile.
+static uint32_t _tileElementCapacities[MAX_TILE_TILE_ELEMENT_POINTERS];
+
+// Runs of elements left behind when a tile was moved, indexed by their length. They are handed out again before
+// gNextFreeTileElement is advanced, so building keeps reusing the same part of the element array and
+// map_reorganise_elements only has to run when it is really full. Longer runs wait for the next reorganisation.
+static constexpr const size_t TILE_ELEMENT_FREE_RUN_MAX_LENGTH = 64;
+static std::array<std::vector<TileElement*>, TILE_ELEMENT_FREE_RUN_MAX_LENGTH + 1> _freeTileElementRuns;
+
+// Tile element summaries packed into one word each: the generation they were made in (lowest 24 bits), the type mask,
+// the surface index and the lowest and highest base height. The threads that paint or plan peep updates can then
+// read and fill them without locks. Only the main thread changes the generation, while no other thread is running.
+static constexpr const uint32_t TILE_ELEMENT_SUMMARY_GENERATION_MASK = 0xFFFFFF;
+static std::atomic<uint64_t> _tileElementSummaries[MAX_TILE_TILE_ELEMENT_POINTERS];
+static uint32_t _tileElementSummaryGeneration = 1;
+static int32_t _tileElementSummarySuspendCount;
+
 bool gLandMountainMode;
 bool gLandPaintMode;
 bool gClearSmallScenery;
@@ -119,6 +146,9 @@ uint16_t gLandRemainingConstructionSales;
 bool gMapLandRightsUpdateSuccess;
 
 static void clear_elements_at(const CoordsXY& loc);
+static uint32_t tile_element_count(const TileElement* tileElement);
+static void MapInvalidateTileElementSummary(const TileCoordsXY& tilePos);
+static void map_invalidate_tile_under_zoom(int32_t x, int32_t y, int32_t z0, int32_t z1, int32_t maxZoom);
 static ScreenCoordsXY translate_3d_to_2d(int32_t rotation, const CoordsXY& pos);
 
 void tile_element_iterator_begin(tile_element_iterator* it)
@@ -211,6 +241,87 @@ void map_set_tile_element(const TileCoordsXY& tilePos, TileElement* elements)
         return;
     }
     gTileElementTilePointers[tilePos.x + tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL] = elements;
+    _tileElementCapacities[tilePos.x + tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL] = tile_element_count(elements);
+    MapInvalidateTileElementSummary(tilePos);
+    MapChangeJournalMarkTile(tilePos.ToCoordsXY());
+}
+
+std::optional<TileElementSummary> MapGetTileElementSummary(const CoordsXY& loc)
+{
+    if (_tileElementSummarySuspendCount != 0 || !map_is_location_valid(loc))
+        return std::nullopt;
+
+    const auto tilePos = TileCoordsXY{ loc };
+    auto& packedSummary = _tileElementSummaries[tilePos.x + tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL];
+    uint64_t packed = packedSummary.load(std::memory_order_relaxed);
+    if ((packed & TILE_ELEMENT_SUMMARY_GENERATION_MASK) != _tileElementSummaryGeneration)
+    {
+        const TileElement* tileElement = gTileElementTilePointers[tilePos.x + tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL];
+        if (tileElement == nullptr)
+            return std::nullopt;
+
+        TileElementSummary summary{ 0, TILE_ELEMENT_SUMMARY_NO_SURFACE_INDEX, 0xFF, 0 };
+        uint32_t index = 0;
+        do
+        {
+            const auto type = tileElement->GetType();
+            if (type == TILE_ELEMENT_TYPE_SURFACE && !summary.HasType(TILE_ELEMENT_TYPE_SURFACE)
+                && index < TILE_ELEMENT_SUMMARY_NO_SURFACE_INDEX)
+            {
+                summary.SurfaceIndex = static_cast<uint8_t>(index);
+            }
+            summary.TypeMask |= 1 << (type >> 2);
+            summary.MinBaseHeight = std::min(summary.MinBaseHeight, tileElement->base_height);
+            summary.MaxBaseHeight = std::max(summary.MaxBaseHeight, tileElement->base_height);
+            index++;
+        } while (!(tileElement++)->IsLastForTile());
+
+        packed = _tileElementSummaryGeneration | (static_cast<uint64_t>(summary.TypeMask) << 24)
+            | (static_cast<uint64_t>(summary.SurfaceIndex) << 40) | (static_cast<uint64_t>(summary.MinBaseHeight) << 48)
+            | (static_cast<uint64_t>(summary.MaxBaseHeight) << 56);
+        packedSummary.store(packed, std::memory_order_relaxed);
+        return summary;
+    }
+
+    return TileElementSummary{ static_cast<uint16_t>(packed >> 24), static_cast<uint8_t>(packed >> 40),
+                               static_cast<uint8_t>(packed >> 48), static_cast<uint8_t>(packed >> 56) };
+}
+
+void MapInvalidateTileElementSummaries()
+{
+    _tileElementSummaryGeneration++;
+    if (_tileElementSummaryGeneration > TILE_ELEMENT_SUMMARY_GENERATION_MASK)
+    {
+        // Old summaries could look current again after the generation wraps around.
+        for (auto& packedSummary : _tileElementSummaries)
+        {
+            packedSummary.store(0, std::memory_order_relaxed);
+        }
+        _tileElementSummaryGeneration = 1;
+    }
+}
+
+/**
+ * Clears the summary of a single tile, it is made again the next time it is asked for. Summaries never have
+ * generation 0, so a cleared one is never current.
+ */
+static void MapInvalidateTileElementSummary(const TileCoordsXY& tilePos)
+{
+    if (tilePos.x < 0 || tilePos.y < 0 || tilePos.x >= MAXIMUM_MAP_SIZE_TECHNICAL || tilePos.y >= MAXIMUM_MAP_SIZE_TECHNICAL)
+        return;
+
+    _tileElementSummaries[tilePos.x + tilePos.y * MAXIMUM_MAP_SIZE_TECHNICAL].store(0, std::memory_order_relaxed);
+}
+
+void MapSuspendTileElementSummaries()
+{
+    _tileElementSummarySuspendCount++;
+}
+
+void MapResumeTileElementSummaries()
+{
+    _tileElementSummarySuspendCount--;
+    MapInvalidateTileElementSummaries();
 }
 
 SurfaceElement* map_get_surface_element_at(const CoordsXY& coords)
@@ -220,6 +331,15 @@ SurfaceElement* map_get_surface_element_at(const CoordsXY& coords)
     if (tileElement == nullptr)
         return nullptr;
 
+    auto summary = MapGetTileElementSummary(coords);
+    if (summary.has_value())
+    {
+        if (!summary->HasType(TILE_ELEMENT_TYPE_SURFACE))
+            return nullptr;
+        if (summary->SurfaceIndex != TILE_ELEMENT_SUMMARY_NO_SURFACE_INDEX)
+            return tileElement[summary->SurfaceIndex].AsSurface();
+    }
+
     // Find the first surface element
     while (tileElement->GetType() != TILE_ELEMENT_TYPE_SURFACE)
     {
@@ -239,6 +359,10 @@ PathElement* map_get_path_element_at(const TileCoordsXYZ& loc)
     if (tileElement == nullptr)
         return nullptr;
 
+    auto summary = MapGetTileElementSummary(loc.ToCoordsXY());
+    if (summary.has_value() && (!summary->HasType(TILE_ELEMENT_TYPE_PATH) || !summary->HasBaseHeight(loc.z)))
+        return nullptr;
+
     // Find the path element at known z
     do
     {
@@ -390,7 +514,7 @@ void map_update_tile_pointers()
         gTileElementTilePointers[i] = TILE_UNDEFINED_TILE_ELEMENT;
     }
 
-    TileElement* tileElement = gTileElements;
+    TileElement* tileElement = gTileElements.data();
     TileElement** tile = gTileElementTilePointers;
     for (y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
     {
@@ -403,6 +527,12 @@ void map_update_tile_pointers()
     }
 
     gNextFreeTileElement = tileElement;
+    MapResetFreeTileElements();
+
+    // Whatever was loaded or cleared, the rides around each tile have to be looked up again.
+    RideVisibilityInvalidateAll();
+    PathfindingCacheInvalidate();
+    FootpathGraphInvalidateAll();
 }
 
 /**
@@ -941,7 +1071,7 @@ bool map_is_location_at_edge(const CoordsXY& loc)
  *
  *  rct2: 0x0068B280
  */
-void tile_element_remove(TileElement* tileElement)
+void tile_element_remove(const CoordsXY& loc, TileElement* tileElement)
 {
     // Replace Nth element by (N+1)th element.
     // This loop will make tileElement point to the old last element position,
@@ -956,12 +1086,11 @@ void tile_element_remove(TileElement* tileElement)
 
     // Mark the latest element with the last element flag.
     (tileElement - 1)->SetLastForTile(true);
+    // The slot stays reserved for the tile.
     tileElement->base_height = MAX_ELEMENT_HEIGHT;
 
-    if ((tileElement + 1) == gNextFreeTileElement)
-    {
-        gNextFreeTileElement--;
-    }
+    MapInvalidateTileElementSummary(TileCoordsXY{ loc });
+    MapChangeJournalMarkTile(loc);
 }
 
 /**
@@ -991,11 +1120,15 @@ void map_remove_all_rides()
             case TILE_ELEMENT_TYPE_TRACK:
                 footpath_queue_chain_reset();
                 footpath_remove_edges_at(TileCoordsXY{ it.x, it.y }.ToCoordsXY(), it.element);
-                tile_element_remove(it.element);
+                tile_element_remove(TileCoordsXY{ it.x, it.y }.ToCoordsXY(), it.element);
                 tile_element_iterator_restart_for_tile(&it);
                 break;
         }
     } while (tile_element_iterator_next(&it));
+    MapChangeJournalMarkAll();
+    RideVisibilityInvalidateAll();
+    PathfindingCacheInvalidate();
+    FootpathGraphInvalidateAll();
 }
 
 /**
@@ -1007,8 +1140,9 @@ void map_invalidate_map_selection_tiles()
     if (!(gMapSelectFlags & MAP_SELECT_FLAG_ENABLE_CONSTRUCT))
         return;
 
+    // Only redraws the tiles, the map itself has not changed.
     for (const auto& position : gMapSelectionTiles)
-        map_invalidate_tile_full(position);
+        map_invalidate_tile_under_zoom(position.x, position.y, 0, 2080, -1);
 }
 
 static void map_get_bounding_box(const MapRange& _range, int32_t* left, int32_t* top, int32_t* right, int32_t* bottom)
@@ -1077,14 +1211,8 @@ void map_reorganise_elements()
 {
     context_setcurrentcursor(CURSOR_ZZZ);
 
-    auto newTileElements = std::make_unique<TileElement[]>(MAX_TILE_ELEMENTS_WITH_SPARE_ROOM);
-    TileElement* newElementsPtr = newTileElements.get();
-
-    if (newTileElements == nullptr)
-    {
-        log_fatal("Unable to allocate memory for map elements.");
-        return;
-    }
+    std::vector<TileElement> newTileElements(gTileElements.size());
+    TileElement* newElementsPtr = newTileElements.data();
 
     for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
     {
@@ -1103,13 +1231,71 @@ void map_reorganise_elements()
         }
     }
 
-    const auto numElements = static_cast<uint32_t>(newElementsPtr - newTileElements.get());
-    std::memcpy(gTileElements, newTileElements.get(), numElements * sizeof(TileElement));
-    std::memset(gTileElements + numElements, 0, (MAX_TILE_ELEMENTS_WITH_SPARE_ROOM - numElements) * sizeof(TileElement));
+    // Copy back instead of swapping the buffers, the heap must stay where it is (see MapSetTileElementLimit).
+    const auto numElements = static_cast<size_t>(newElementsPtr - newTileElements.data());
+    std::memcpy(gTileElements.data(), newTileElements.data(), numElements * sizeof(TileElement));
+    std::memset(gTileElements.data() + numElements, 0, (gTileElements.size() - numElements) * sizeof(TileElement));
 
     map_update_tile_pointers();
 }
 
+size_t MapGetTileElementLimit()
+{
+    return _tileElementLimit;
+}
+
+/**
+ * Sets how far the tile element heap may grow. Room for that many elements is reserved right away so growing never
+ * moves the heap, elements can be held on to across inserts. Only called while a park is set up (the player's
+ * max_tile_elements setting) or received from a server, moving the heap here rebases the tile pointers.
+ */
+void MapSetTileElementLimit(size_t limit)
+{
+    _tileElementLimit = std::max<size_t>(limit, TILE_ELEMENT_HEAP_INITIAL_SIZE);
+    if (gTileElements.capacity() >= _tileElementLimit)
+    {
+        return;
+    }
+
+    const auto* oldBase = gTileElements.data();
+    gTileElements.reserve(_tileElementLimit);
+    auto rebase = [oldBase](TileElement* tileElement) -> TileElement* {
+        return tileElement == nullptr ? nullptr : gTileElements.data() + (tileElement - oldBase);
+    };
+    for (auto& tilePointer : gTileElementTilePointers)
+    {
+        tilePointer = rebase(tilePointer);
+    }
+    gNextFreeTileElement = rebase(gNextFreeTileElement);
+    MapResetFreeTileElements();
+}
+
+static TileElement* tile_element_heap_end()
+{
+    return gTileElements.data() + gTileElements.size();
+}
+
+/**
+ * Doubles the size of the tile element heap, up to the limit of the park. That room is already reserved so the
+ * elements stay where they are. They have to be in order (see map_reorganise_elements) as the tile pointers are
+ * looked up again afterwards.
+ */
+static bool tile_element_heap_grow()
+{
+    const auto limit = MapGetTileElementLimit();
+    if (gTileElements.size() >= limit)
+    {
+        return false;
+    }
+
+    const auto newSize = std::min(gTileElements.size() * 2, limit);
+    log_verbose("Growing the tile element heap to %zu elements", newSize);
+    Guard::Assert(newSize <= gTileElements.capacity(), "Tile element heap would move");
+    gTileElements.resize(newSize);
+    map_update_tile_pointers();
+    return true;
+}
+
 /**
  *
  *  rct2: 0x0068B044
@@ -1120,28 +1306,105 @@ bool map_check_free_elements_and_reorganise(int32_t numElements)
 {
     if (numElements != 0)
     {
-        auto tileElementEnd = &gTileElements[MAX_TILE_ELEMENTS];
-
         // Check if is there is room for the required number of elements
-        auto newTileElementEnd = gNextFreeTileElement + numElements;
-        if (newTileElementEnd > tileElementEnd)
+        auto hasRoom = [numElements]() {
+            return gNextFreeTileElement + numElements <= tile_element_heap_end() - TILE_ELEMENT_HEAP_SPARE_ROOM;
+        };
+        if (!hasRoom())
         {
             // Defragment the map element list
             map_reorganise_elements();
 
-            // Check if there is any room again
-            newTileElementEnd = gNextFreeTileElement + numElements;
-            if (newTileElementEnd > tileElementEnd)
+            // Make the heap larger if that was not enough
+            while (!hasRoom())
             {
-                // Not enough spare elements left :'(
-                gGameCommandErrorText = STR_ERR_LANDSCAPE_DATA_AREA_FULL;
-                return false;
+                if (!tile_element_heap_grow())
+                {
+                    // Not enough spare elements left :'(
+                    gGameCommandErrorText = STR_ERR_LANDSCAPE_DATA_AREA_FULL;
+                    return false;
+                }
             }
         }
     }
     return true;
 }
 
+/**
+ * Marks the elements of a run as unused and keeps the run for tile_element_allocate_run.
+ */
+static void tile_element_free_run(TileElement* start, size_t length)
+{
+    for (size_t i = 0; i < length; i++)
+    {
+        start[i].base_height = MAX_ELEMENT_HEIGHT;
+    }
+
+    if (start + length == gNextFreeTileElement)
+    {
+        gNextFreeTileElement = start;
+    }
+    else if (length <= TILE_ELEMENT_FREE_RUN_MAX_LENGTH)
+    {
+        _freeTileElementRuns[length].push_back(start);
+    }
+}
+
+/**
+ * Returns room for length consecutive elements, preferring freed runs of the same or the nearest larger length
+ * over the end of the used part of the element array.
+ */
+static TileElement* tile_element_allocate_run(size_t length)
+{
+    for (size_t runLength = length; runLength <= TILE_ELEMENT_FREE_RUN_MAX_LENGTH; runLength++)
+    {
+        auto& runs = _freeTileElementRuns[runLength];
+        if (!runs.empty())
+        {
+            auto start = runs.back();
+            runs.pop_back();
+            if (runLength > length)
+            {
+                _freeTileElementRuns[runLength - length].push_back(start + length);
+            }
+            return start;
+        }
+    }
+
+    if (gNextFreeTileElement + length > tile_element_heap_end())
+    {
+        return nullptr;
+    }
+    auto start = gNextFreeTileElement;
+    gNextFreeTileElement += length;
+    return start;
+}
+
+static uint32_t tile_element_count(const TileElement* tileElement)
+{
+    uint32_t numElements = 0;
+    if (tileElement != nullptr)
+    {
+        while (!tileElement[numElements++].IsLastForTile())
+            ;
+    }
+    return numElements;
+}
+
+void MapResetFreeTileElements()
+{
+    MapInvalidateTileElementSummaries();
+    MapChangeJournalMarkAll();
+    for (auto& runs : _freeTileElementRuns)
+    {
+        runs.clear();
+    }
+    for (int32_t i = 0; i < MAX_TILE_TILE_ELEMENT_POINTERS; i++)
+    {
+        _tileElementCapacities[i] = tile_element_count(gTileElementTilePointers[i]);
+    }
+}
+
 /**
  *
  *  rct2: 0x0068B1F6
@@ -1149,72 +1412,97 @@ bool map_check_free_elements_and_reorganise(int32_t numElements)
 TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants)
 {
     const auto& tileLoc = TileCoordsXYZ(loc);
-    TileElement *originalTileElement, *newTileElement, *insertedElement;
-    bool isLastForTile = false;
+    const auto tileIndex = tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x;
+    auto& tilePointer = gTileElementTilePointers[tileIndex];
+    auto& capacity = _tileElementCapacities[tileIndex];
 
     if (!map_check_free_elements_and_reorganise(1))
     {
         log_error("Cannot insert new element");
         return nullptr;
     }
+    MapInvalidateTileElementSummary(tileLoc);
+    MapChangeJournalMarkTile(loc);
 
-    newTileElement = gNextFreeTileElement;
-    originalTileElement = gTileElementTilePointers[tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x];
+    TileElement* originalTileElement = tilePointer;
+    const size_t numElements = tile_element_count(originalTileElement);
 
-    // Set tile index pointer to point to new element block
-    gTileElementTilePointers[tileLoc.y * MAXIMUM_MAP_SIZE_TECHNICAL + tileLoc.x] = newTileElement;
+    // Elements are kept in order of their base height, the new one goes after those at or below it.
+    size_t insertIndex = 0;
+    while (insertIndex < numElements && loc.z >= originalTileElement[insertIndex].GetBaseZ())
+    {
+        insertIndex++;
+    }
 
-    if (originalTileElement == nullptr)
+    TileElement* newTileElement;
+    if (originalTileElement != nullptr && originalTileElement + capacity == gNextFreeTileElement
+        && numElements == capacity && gNextFreeTileElement < tile_element_heap_end())
     {
-        isLastForTile = true;
+        // The tile is at the end of the used elements, so its room can be extended.
+        gNextFreeTileElement++;
+        capacity++;
+    }
+    if (numElements < capacity)
+    {
+        // Grow the tile into the room it has left.
+        newTileElement = originalTileElement;
+        std::memmove(
+            &newTileElement[insertIndex + 1], &newTileElement[insertIndex], (numElements - insertIndex) * sizeof(TileElement));
     }
     else
     {
-        // Copy all elements that are below the insert height
-        while (loc.z >= originalTileElement->GetBaseZ())
+        uint32_t newCapacity = 2;
+        while (newCapacity < numElements + 1)
         {
-            // Copy over map element
-            *newTileElement = *originalTileElement;
-            originalTileElement->base_height = MAX_ELEMENT_HEIGHT;
-            originalTileElement++;
-            newTileElement++;
-
-            if ((newTileElement - 1)->IsLastForTile())
-            {
-                // No more elements above the insert element
-                (newTileElement - 1)->SetLastForTile(false);
-                isLastForTile = true;
-                break;
-            }
+            newCapacity *= 2;
+        }
+        newTileElement = tile_element_allocate_run(newCapacity);
+        if (newTileElement == nullptr)
+        {
+            // Nearly full, do without the spare room.
+            newCapacity = static_cast<uint32_t>(numElements + 1);
+            newTileElement = tile_element_allocate_run(newCapacity);
         }
+        if (newTileElement == nullptr)
+        {
+            log_error("Cannot insert new element");
+            return nullptr;
+        }
+        for (uint32_t i = numElements + 1; i < newCapacity; i++)
+        {
+            newTileElement[i].base_height = MAX_ELEMENT_HEIGHT;
+        }
+        if (originalTileElement != nullptr)
+        {
+            std::memcpy(newTileElement, originalTileElement, insertIndex * sizeof(TileElement));
+            std::memcpy(
+                &newTileElement[insertIndex + 1], &originalTileElement[insertIndex],
+                (numElements - insertIndex) * sizeof(TileElement));
+            tile_element_free_run(originalTileElement, capacity);
+        }
+        capacity = newCapacity;
     }
 
-    // Insert new map element
-    insertedElement = newTileElement;
-    newTileElement->type = 0;
-    newTileElement->SetBaseZ(loc.z);
-    newTileElement->Flags = 0;
-    newTileElement->SetLastForTile(isLastForTile);
-    newTileElement->SetOccupiedQuadrants(occupiedQuadrants);
-    newTileElement->SetClearanceZ(loc.z);
-    std::memset(&newTileElement->pad_04, 0, sizeof(newTileElement->pad_04));
-    std::memset(&newTileElement->pad_08, 0, sizeof(newTileElement->pad_08));
-    newTileElement++;
-
-    // Insert rest of map elements above insert height
-    if (!isLastForTile)
+    // Set tile index pointer to point to new element block
+    tilePointer = newTileElement;
+
+    bool isLastForTile = insertIndex == numElements;
+    if (isLastForTile && insertIndex > 0)
     {
-        do
-        {
-            // Copy over map element
-            *newTileElement = *originalTileElement;
-            originalTileElement->base_height = MAX_ELEMENT_HEIGHT;
-            originalTileElement++;
-            newTileElement++;
-        } while (!((newTileElement - 1)->IsLastForTile()));
+        // No more elements above the insert element
+        newTileElement[insertIndex - 1].SetLastForTile(false);
     }
 
-    gNextFreeTileElement = newTileElement;
+    // Insert new map element
+    TileElement* insertedElement = &newTileElement[insertIndex];
+    insertedElement->type = 0;
+    insertedElement->SetBaseZ(loc.z);
+    insertedElement->Flags = 0;
+    insertedElement->SetLastForTile(isLastForTile);
+    insertedElement->SetOccupiedQuadrants(occupiedQuadrants);
+    insertedElement->SetClearanceZ(loc.z);
+    std::memset(&insertedElement->pad_04, 0, sizeof(insertedElement->pad_04));
+    std::memset(&insertedElement->pad_08, 0, sizeof(insertedElement->pad_08));
     return insertedElement;
 }
 
@@ -1708,6 +1996,7 @@ void map_extend_boundary_surface()
 static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
 {
     TileElement* element = *elementPtr;
+    MapChangeJournalMarkTile(loc);
     switch (element->GetType())
     {
         case TILE_ELEMENT_TYPE_SURFACE:
@@ -1763,7 +2052,13 @@ static void clear_element_at(const CoordsXY& loc, TileElement** elementPtr)
             break;
         }
         default:
-            tile_element_remove(element);
+            if (element->GetType() == TILE_ELEMENT_TYPE_TRACK)
+            {
+                RideVisibilityInvalidateTile(loc);
+            }
+            PathfindingCacheInvalidate();
+            FootpathGraphInvalidateTile(loc);
+            tile_element_remove(loc, element);
             break;
     }
 }
@@ -2014,6 +2309,9 @@ ScreenCoordsXY translate_3d_to_2d_with_z(int32_t rotation, const CoordsXYZ& pos)
 
 static void map_invalidate_tile_under_zoom(int32_t x, int32_t y, int32_t z0, int32_t z1, int32_t maxZoom)
 {
+    // Cached paint structs of the tile are out of date even when nothing is drawn
+    MapChangeJournalMarkTileRedraw({ x, y });
+
     if (gOpenRCT2Headless)
         return;
 
@@ -2044,6 +2342,7 @@ static void map_invalidate_tile_under_zoom(int32_t x, int32_t y, int32_t z0, int
  */
 void map_invalidate_tile(const CoordsXYRangedZ& tilePos)
 {
+    MapChangeJournalMarkTile(tilePos);
     map_invalidate_tile_under_zoom(tilePos.x, tilePos.y, tilePos.baseZ, tilePos.clearanceZ, -1);
 }
 
@@ -2083,6 +2382,8 @@ void map_invalidate_region(const CoordsXY& mins, const CoordsXY& maxs)
 {
     int32_t x0, y0, x1, y1, left, right, top, bottom;
 
+    MapChangeJournalMarkRange({ mins, maxs });
+
     x0 = mins.x + 16;
     y0 = mins.y + 16;
 
@@ -2188,11 +2489,22 @@ void map_clear_all_elements()
  * @param y y units, not tiles.
  * @param z Base height.
  */
+/**
+ * Returns false if the summary of the tile at loc shows that it has no track element at baseHeight.
+ */
+static bool map_tile_may_have_track_at(const CoordsXY& loc, int32_t baseHeight)
+{
+    auto summary = MapGetTileElementSummary(loc);
+    return !summary.has_value() || (summary->HasType(TILE_ELEMENT_TYPE_TRACK) && summary->HasBaseHeight(baseHeight));
+}
+
 TrackElement* map_get_track_element_at(const CoordsXYZ& trackPos)
 {
     TileElement* tileElement = map_get_first_element_at(trackPos);
     if (tileElement == nullptr)
         return nullptr;
+    if (!map_tile_may_have_track_at(trackPos, trackPos.z / COORDS_Z_STEP))
+        return nullptr;
     do
     {
         if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
@@ -2218,6 +2530,8 @@ TileElement* map_get_track_element_at_of_type(const CoordsXYZ& trackPos, int32_t
     if (tileElement == nullptr)
         return nullptr;
     auto trackTilePos = TileCoordsXYZ{ trackPos };
+    if (!map_tile_may_have_track_at(trackPos, trackTilePos.z))
+        return nullptr;
     do
     {
         if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
@@ -2243,6 +2557,8 @@ TileElement* map_get_track_element_at_of_type_seq(const CoordsXYZ& trackPos, int
 {
     TileElement* tileElement = map_get_first_element_at(trackPos);
     auto trackTilePos = TileCoordsXYZ{ trackPos };
+    if (!map_tile_may_have_track_at(trackPos, trackTilePos.z))
+        return nullptr;
     do
     {
         if (tileElement == nullptr)
@@ -2265,6 +2581,8 @@ TileElement* map_get_track_element_at_of_type_seq(const CoordsXYZ& trackPos, int
 TrackElement* map_get_track_element_at_of_type(const CoordsXYZD& location, int32_t trackType)
 {
     auto tileElement = map_get_first_element_at(location);
+    if (!map_tile_may_have_track_at(location, location.z / COORDS_Z_STEP))
+        return nullptr;
     if (tileElement != nullptr)
     {
         do
@@ -2288,6 +2606,8 @@ TrackElement* map_get_track_element_at_of_type(const CoordsXYZD& location, int32
 TrackElement* map_get_track_element_at_of_type_seq(const CoordsXYZD& location, int32_t trackType, int32_t sequence)
 {
     auto tileElement = map_get_first_element_at(location);
+    if (!map_tile_may_have_track_at(location, location.z / COORDS_Z_STEP))
+        return nullptr;
     if (tileElement != nullptr)
     {
         do
@@ -2322,6 +2642,8 @@ TileElement* map_get_track_element_at_of_type_from_ride(const CoordsXYZ& trackPo
     if (tileElement == nullptr)
         return nullptr;
     auto trackTilePos = TileCoordsXYZ{ trackPos };
+    if (!map_tile_may_have_track_at(trackPos, trackTilePos.z))
+        return nullptr;
     do
     {
         if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
@@ -2351,6 +2673,8 @@ TileElement* map_get_track_element_at_from_ride(const CoordsXYZ& trackPos, ride_
     if (tileElement == nullptr)
         return nullptr;
     auto trackTilePos = TileCoordsXYZ{ trackPos };
+    if (!map_tile_may_have_track_at(trackPos, trackTilePos.z))
+        return nullptr;
     do
     {
         if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
@@ -2379,6 +2703,8 @@ TileElement* map_get_track_element_at_with_direction_from_ride(const CoordsXYZD&
     if (tileElement == nullptr)
         return nullptr;
     auto trackTilePos = TileCoordsXYZ{ trackPos };
+    if (!map_tile_may_have_track_at(trackPos, trackTilePos.z))
+        return nullptr;
     do
     {
         if (tileElement->GetType() != TILE_ELEMENT_TYPE_TRACK)
@@ -15,6 +15,7 @@
 #include "TileElement.h"
 
 #include <initializer_list>
+#include <optional>
 #include <vector>
 
 #define MINIMUM_LAND_HEIGHT 2
@@ -33,8 +34,11 @@ constexpr const int32_t MINIMUM_LAND_HEIGHT_BIG = MINIMUM_LAND_HEIGHT * COORDS_Z
 
 #define MAP_MINIMUM_X_Y (-MAXIMUM_MAP_SIZE_TECHNICAL)
 
-constexpr const uint32_t MAX_TILE_ELEMENTS_WITH_SPARE_ROOM = 0x30000;
-constexpr const uint32_t MAX_TILE_ELEMENTS = MAX_TILE_ELEMENTS_WITH_SPARE_ROOM - 512;
+// The tile element heap starts at the size of the RCT2 element array and grows when it is full, up to the limit
+// of the park (see MapSetTileElementLimit). Parks that use more elements than the RCT2 array can not be saved as .sv6.
+constexpr const uint32_t TILE_ELEMENT_HEAP_INITIAL_SIZE = 0x30000;
+// Elements kept free at the end of the heap for inserts that were not checked for room beforehand.
+constexpr const uint32_t TILE_ELEMENT_HEAP_SPARE_ROOM = 512;
 #define MAX_TILE_TILE_ELEMENT_POINTERS (MAXIMUM_MAP_SIZE_TECHNICAL * MAXIMUM_MAP_SIZE_TECHNICAL)
 #define MAX_PEEP_SPAWNS 2
 
@@ -117,7 +121,7 @@ extern uint8_t gMapSelectArrowDirection;
 
 extern uint8_t gMapGroundFlags;
 
-extern TileElement gTileElements[MAX_TILE_ELEMENTS_WITH_SPARE_ROOM];
+extern std::vector<TileElement> gTileElements;
 extern TileElement* gTileElementTilePointers[MAX_TILE_TILE_ELEMENT_POINTERS];
 
 extern std::vector<CoordsXY> gMapSelectionTiles;
@@ -152,6 +156,38 @@ void map_update_tile_pointers();
 TileElement* map_get_first_element_at(const CoordsXY& elementPos);
 TileElement* map_get_nth_element_at(const CoordsXY& coords, int32_t n);
 void map_set_tile_element(const TileCoordsXY& tilePos, TileElement* elements);
+
+constexpr const uint8_t TILE_ELEMENT_SUMMARY_NO_SURFACE_INDEX = 0xFF;
+
+// What a tile holds, so lookups can skip tiles that can not have the element they look for.
+struct TileElementSummary
+{
+    // Bit (type >> 2) is set for every element type on the tile.
+    uint16_t TypeMask;
+    // Position of the first surface element, TILE_ELEMENT_SUMMARY_NO_SURFACE_INDEX if there is none or it is too far in.
+    uint8_t SurfaceIndex;
+    uint8_t MinBaseHeight;
+    uint8_t MaxBaseHeight;
+
+    bool HasType(uint8_t type) const
+    {
+        return (TypeMask & (1 << (type >> 2))) != 0;
+    }
+
+    bool HasBaseHeight(int32_t baseHeight) const
+    {
+        return baseHeight >= MinBaseHeight && baseHeight <= MaxBaseHeight;
+    }
+};
+
+// Summaries are worked out the first time a tile is looked at and kept until the map is modified. They are not
+// available (std::nullopt) for tiles without elements and while a game action modifies the map.
+std::optional<TileElementSummary> MapGetTileElementSummary(const CoordsXY& loc);
+// Needs to be called when elements change their type or height outside of a game action. Adding and removing elements
+// only clears the summary of their own tile.
+void MapInvalidateTileElementSummaries();
+void MapSuspendTileElementSummaries();
+void MapResumeTileElementSummaries();
 int32_t map_height_from_slope(const CoordsXY& coords, int32_t slopeDirection, bool isSloped);
 BannerElement* map_get_banner_element_at(const CoordsXYZ& bannerPos, uint8_t direction);
 SurfaceElement* map_get_surface_element_at(const CoordsXY& coords);
@@ -177,12 +213,17 @@ bool map_is_location_owned(const CoordsXYZ& loc);
 bool map_is_location_in_park(const CoordsXY& coords);
 bool map_is_location_owned_or_has_rights(const CoordsXY& loc);
 bool map_surface_is_blocked(const CoordsXY& mapCoords);
-void tile_element_remove(TileElement* tileElement);
+void tile_element_remove(const CoordsXY& loc, TileElement* tileElement);
 void map_remove_all_rides();
 void map_invalidate_map_selection_tiles();
 void map_invalidate_selection_rect();
 void map_reorganise_elements();
 bool map_check_free_elements_and_reorganise(int32_t num_elements);
+// Forgets the free tile element runs and the room reserved for each tile. Needed when the elements or tile
+// pointers are replaced without map_update_tile_pointers.
+void MapResetFreeTileElements();
+size_t MapGetTileElementLimit();
+void MapSetTileElementLimit(size_t limit);
 TileElement* tile_element_insert(const CoordsXYZ& loc, int32_t occupiedQuadrants);
 
 class GameActionResult;
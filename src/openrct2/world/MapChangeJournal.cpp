@@ -0,0 +1,109 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "MapChangeJournal.h"
+
+#include <algorithm>
+
+static uint64_t _mapChangeVersion;
+static uint64_t _chunkVersions[MAP_CHUNKS_PER_SIDE][MAP_CHUNKS_PER_SIDE];
+static uint64_t _tileVersions[MAXIMUM_MAP_SIZE_TECHNICAL][MAXIMUM_MAP_SIZE_TECHNICAL];
+// The version of the last change that affected every tile, so marking the whole map does not have to touch each tile.
+static uint64_t _allTilesVersion;
+
+static bool map_change_journal_is_valid_tile(const TileCoordsXY& tilePos)
+{
+    return tilePos.x >= 0 && tilePos.y >= 0 && tilePos.x < MAXIMUM_MAP_SIZE_TECHNICAL
+        && tilePos.y < MAXIMUM_MAP_SIZE_TECHNICAL;
+}
+
+static void map_change_journal_mark_chunks(int32_t chunkX1, int32_t chunkY1, int32_t chunkX2, int32_t chunkY2)
+{
+    chunkX1 = std::clamp(chunkX1, 0, MAP_CHUNKS_PER_SIDE - 1);
+    chunkY1 = std::clamp(chunkY1, 0, MAP_CHUNKS_PER_SIDE - 1);
+    chunkX2 = std::clamp(chunkX2, 0, MAP_CHUNKS_PER_SIDE - 1);
+    chunkY2 = std::clamp(chunkY2, 0, MAP_CHUNKS_PER_SIDE - 1);
+
+    _mapChangeVersion++;
+    for (int32_t chunkY = chunkY1; chunkY <= chunkY2; chunkY++)
+    {
+        for (int32_t chunkX = chunkX1; chunkX <= chunkX2; chunkX++)
+        {
+            _chunkVersions[chunkY][chunkX] = _mapChangeVersion;
+        }
+    }
+}
+
+void MapChangeJournalMarkTile(const CoordsXY& loc)
+{
+    const auto tilePos = TileCoordsXY{ loc };
+    if (!map_change_journal_is_valid_tile(tilePos))
+        return;
+
+    // Always a new version, a consumer may already have seen the current one for this chunk
+    const auto chunkX = tilePos.x / MAP_CHUNK_SIZE;
+    const auto chunkY = tilePos.y / MAP_CHUNK_SIZE;
+    map_change_journal_mark_chunks(chunkX, chunkY, chunkX, chunkY);
+    _tileVersions[tilePos.y][tilePos.x] = _mapChangeVersion;
+}
+
+void MapChangeJournalMarkTileRedraw(const CoordsXY& loc)
+{
+    const auto tilePos = TileCoordsXY{ loc };
+    if (!map_change_journal_is_valid_tile(tilePos))
+        return;
+
+    _mapChangeVersion++;
+    _tileVersions[tilePos.y][tilePos.x] = _mapChangeVersion;
+}
+
+void MapChangeJournalMarkRange(const MapRange& range)
+{
+    const auto normalisedRange = range.Normalise();
+    const auto tileLeftTop = TileCoordsXY{ CoordsXY{ normalisedRange.GetLeft(), normalisedRange.GetTop() } };
+    const auto tileRightBottom = TileCoordsXY{ CoordsXY{ normalisedRange.GetRight(), normalisedRange.GetBottom() } };
+    map_change_journal_mark_chunks(
+        tileLeftTop.x / MAP_CHUNK_SIZE, tileLeftTop.y / MAP_CHUNK_SIZE, tileRightBottom.x / MAP_CHUNK_SIZE,
+        tileRightBottom.y / MAP_CHUNK_SIZE);
+
+    const auto tileX1 = std::clamp(tileLeftTop.x, 0, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+    const auto tileY1 = std::clamp(tileLeftTop.y, 0, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+    const auto tileX2 = std::clamp(tileRightBottom.x, 0, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+    const auto tileY2 = std::clamp(tileRightBottom.y, 0, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+    for (int32_t tileY = tileY1; tileY <= tileY2; tileY++)
+    {
+        for (int32_t tileX = tileX1; tileX <= tileX2; tileX++)
+        {
+            _tileVersions[tileY][tileX] = _mapChangeVersion;
+        }
+    }
+}
+
+void MapChangeJournalMarkAll()
+{
+    map_change_journal_mark_chunks(0, 0, MAP_CHUNKS_PER_SIDE - 1, MAP_CHUNKS_PER_SIDE - 1);
+    _allTilesVersion = _mapChangeVersion;
+}
+
+uint64_t MapChangeJournalGetVersion()
+{
+    return _mapChangeVersion;
+}
+
+uint64_t MapChangeJournalGetChunkVersion(int32_t chunkX, int32_t chunkY)
+{
+    return _chunkVersions[chunkY][chunkX];
+}
+
+uint64_t MapChangeJournalGetTileVersion(const TileCoordsXY& tilePos)
+{
+    if (!map_change_journal_is_valid_tile(tilePos))
+        return _allTilesVersion;
+    return std::max(_tileVersions[tilePos.y][tilePos.x], _allTilesVersion);
+}
@@ -0,0 +1,79 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#pragma once
+
+#include "../common.h"
+#include "Map.h"
+
+// The map change journal divides the map into chunks of 8×8 tiles and gives each chunk the version of the last
+// change made to it. Versions only ever increase, so a consumer that remembers the version it last looked at only
+// has to recompute the chunks that have a newer one. It is not part of the game state and only records changes made
+// from the main thread.
+//
+// Each tile also has the version of its last change, which includes changes that only alter how the tile is drawn,
+// such as the frame of an animation. Those are marked with MapChangeJournalMarkTileRedraw and do not change the
+// version of the chunk.
+
+constexpr const int32_t MAP_CHUNK_SIZE = 8;
+constexpr const int32_t MAP_CHUNKS_PER_SIDE = MAXIMUM_MAP_SIZE_TECHNICAL / MAP_CHUNK_SIZE;
+
+void MapChangeJournalMarkTile(const CoordsXY& loc);
+void MapChangeJournalMarkTileRedraw(const CoordsXY& loc);
+void MapChangeJournalMarkRange(const MapRange& range);
+void MapChangeJournalMarkAll();
+
+// The version of the latest change anywhere on the map.
+uint64_t MapChangeJournalGetVersion();
+uint64_t MapChangeJournalGetChunkVersion(int32_t chunkX, int32_t chunkY);
+uint64_t MapChangeJournalGetTileVersion(const TileCoordsXY& tilePos);
+
+/**
+ * The position of one consumer in the map change journal. A new subscription sees every chunk as changed.
+ */
+class MapChangeSubscription
+{
+private:
+    uint64_t _version = 0;
+    bool _seenAll = false;
+
+public:
+    bool HasChanges() const
+    {
+        return !_seenAll || MapChangeJournalGetVersion() > _version;
+    }
+
+    /**
+     * Calls fn with the first tile of each chunk that changed since the last call, and catches up with the journal.
+     */
+    template<typename TFn> void ForEachChangedChunk(TFn&& fn)
+    {
+        if (!HasChanges())
+            return;
+
+        for (int32_t chunkY = 0; chunkY < MAP_CHUNKS_PER_SIDE; chunkY++)
+        {
+            for (int32_t chunkX = 0; chunkX < MAP_CHUNKS_PER_SIDE; chunkX++)
+            {
+                if (!_seenAll || MapChangeJournalGetChunkVersion(chunkX, chunkY) > _version)
+                {
+                    fn(TileCoordsXY{ chunkX * MAP_CHUNK_SIZE, chunkY * MAP_CHUNK_SIZE });
+                }
+            }
+        }
+        _version = MapChangeJournalGetVersion();
+        _seenAll = true;
+    }
+
+    // Makes the next ForEachChangedChunk report every chunk again.
+    void Reset()
+    {
+        _seenAll = false;
+    }
+};
@@ -18,6 +18,7 @@
 #include "../interface/Viewport.h"
 #include "../localisation/Date.h"
 #include "../localisation/Localisation.h"
+#include "../network/network.h"
 #include "../scenario/Scenario.h"
 #include "Fountain.h"
 
@@ -27,9 +28,19 @@
 
 uint16_t gSpriteListHead[static_cast<uint8_t>(EntityListId::Count)];
 uint16_t gSpriteListCount[static_cast<uint8_t>(EntityListId::Count)];
-static rct_sprite _spriteList[MAX_SPRITES];
-
-static bool _spriteFlashingList[MAX_SPRITES];
+// Entities are stored in fixed size chunks so growing the pool never moves existing entities.
+static std::vector<std::unique_ptr<rct_sprite[]>> _spriteChunks;
+static size_t _spritePoolSize;
+// Entity ids of each list, the head of the linked list is stored at the back. Removing an entity leaves
+// SPRITE_INDEX_NULL at its position so the order of the others is kept, the gaps are closed by CompactEntityList.
+static std::array<std::vector<uint16_t>, static_cast<uint8_t>(EntityListId::Count)> _entityLists;
+static std::array<size_t, static_cast<uint8_t>(EntityListId::Count)> _entityListGaps;
+// Position of each entity in the ids of its list.
+static std::vector<uint32_t> _entityListPositions;
+// The number of EntityLists that are being iterated, the ids may not move until they are done.
+static int32_t _entityListIterations;
+
+static std::vector<bool> _spriteFlashingList;
 
 uint16_t gSpriteSpatialIndex[SPATIAL_INDEX_SIZE];
 
@@ -46,11 +57,29 @@ const rct_string_id litterNames[12] = { STR_LITTER_VOMIT,
                                         STR_SHOP_ITEM_SINGULAR_EMPTY_JUICE_CUP,
                                         STR_SHOP_ITEM_SINGULAR_EMPTY_BOWL_BLUE };
 
-static CoordsXYZ _spritelocations1[MAX_SPRITES];
-static CoordsXYZ _spritelocations2[MAX_SPRITES];
+static std::vector<CoordsXYZ> _spritelocations1;
+static std::vector<CoordsXYZ> _spritelocations2;
+
+// Per entity checksums, combined with a wrapping sum and xor so single entities can be replaced.
+static std::vector<uint64_t> _entityChecksums;
+static std::vector<bool> _entityChecksumDirty;
+static std::vector<uint16_t> _entityChecksumDirtyList;
+static uint64_t _entityChecksumSum;
+static uint64_t _entityChecksumXor;
+
+// Litter is additionally bucketed by blocks of tiles so handymen can find nearby litter without walking the whole list.
+constexpr const int32_t LITTER_INDEX_BLOCK_SIZE = 8;
+constexpr const int32_t LITTER_INDEX_BLOCKS = MAXIMUM_MAP_SIZE_TECHNICAL / LITTER_INDEX_BLOCK_SIZE;
+constexpr const size_t LITTER_INDEX_LOCATION_NULL = LITTER_INDEX_BLOCKS * LITTER_INDEX_BLOCKS;
+static std::array<std::vector<uint16_t>, LITTER_INDEX_BLOCKS * LITTER_INDEX_BLOCKS> _litterIndex;
+// When each litter joined the litter list. It is added at the head, so newer litter comes first in the list.
+static std::vector<uint64_t> _litterSequence;
+static uint64_t _nextLitterSequence;
 
 static size_t GetSpatialIndexOffset(int32_t x, int32_t y);
 static void move_sprite_to_list(SpriteBase* sprite, EntityListId newListIndex);
+static void MarkAllEntityChecksumsDirty();
+static void RebuildLitterIndex();
 
 // Required for GetEntity to return a default
 template<> bool SpriteBase::Is<SpriteBase>() const
@@ -83,6 +112,116 @@ uint16_t GetEntityListCount(EntityListId list)
     return gSpriteListCount[static_cast<uint8_t>(list)];
 }
 
+static void EntityListUpdatePositions(EntityListId list)
+{
+    const auto& ids = _entityLists[static_cast<uint8_t>(list)];
+    for (size_t i = 0; i < ids.size(); i++)
+    {
+        if (ids[i] != SPRITE_INDEX_NULL)
+        {
+            _entityListPositions[ids[i]] = static_cast<uint32_t>(i);
+        }
+    }
+}
+
+/**
+ * Closes the gaps left by removed entities, unless a list is being iterated.
+ */
+static void CompactEntityList(EntityListId list)
+{
+    auto& gaps = _entityListGaps[static_cast<uint8_t>(list)];
+    if (gaps == 0 || _entityListIterations != 0)
+        return;
+
+    auto& ids = _entityLists[static_cast<uint8_t>(list)];
+    ids.erase(std::remove(ids.begin(), ids.end(), SPRITE_INDEX_NULL), ids.end());
+    gaps = 0;
+    EntityListUpdatePositions(list);
+}
+
+const std::vector<uint16_t>& GetEntityList(EntityListId list)
+{
+    CompactEntityList(list);
+    return _entityLists[static_cast<uint8_t>(list)];
+}
+
+void EntityListIterationBegin()
+{
+    _entityListIterations++;
+}
+
+void EntityListIterationEnd()
+{
+    _entityListIterations--;
+}
+
+/**
+ * Rebuilds the contiguous entity id lists from the linked lists, required after the
+ * linked lists have been written directly (e.g. when importing a save).
+ */
+void RebuildEntityLists()
+{
+    for (int32_t i = 0; i < static_cast<uint8_t>(EntityListId::Count); i++)
+    {
+        auto& ids = _entityLists[i];
+        ids.clear();
+
+        // Bound the walk so a corrupted (cyclic) list can not hang the game.
+        for (uint16_t spriteIndex = gSpriteListHead[i];
+             spriteIndex != SPRITE_INDEX_NULL && ids.size() < _spritePoolSize;)
+        {
+            auto* entity = try_get_sprite(spriteIndex);
+            if (entity == nullptr)
+            {
+                log_error("Broken Entity list");
+                break;
+            }
+            ids.push_back(spriteIndex);
+            spriteIndex = entity->next;
+        }
+        std::reverse(ids.begin(), ids.end());
+        _entityListGaps[i] = 0;
+        EntityListUpdatePositions(static_cast<EntityListId>(i));
+    }
+
+    // The litter at the head of the list, at the back of the ids, is the newest.
+    for (auto spriteIndex : _entityLists[static_cast<uint8_t>(EntityListId::Litter)])
+    {
+        _litterSequence[spriteIndex] = _nextLitterSequence++;
+    }
+
+    // The entities have most likely been written directly as well.
+    MarkAllEntityChecksumsDirty();
+    RebuildLitterIndex();
+}
+
+static void EntityListAdd(EntityListId list, uint16_t spriteIndex)
+{
+    auto& ids = _entityLists[static_cast<uint8_t>(list)];
+    _entityListPositions[spriteIndex] = static_cast<uint32_t>(ids.size());
+    ids.push_back(spriteIndex);
+}
+
+static void EntityListRemove(EntityListId list, uint16_t spriteIndex)
+{
+    auto& ids = _entityLists[static_cast<uint8_t>(list)];
+    auto position = _entityListPositions[spriteIndex];
+    if (position >= ids.size() || ids[position] != spriteIndex)
+    {
+        log_error("Entity %u is not in its entity list", spriteIndex);
+        return;
+    }
+
+    ids[position] = SPRITE_INDEX_NULL;
+    _entityListGaps[static_cast<uint8_t>(list)]++;
+    // Entities are most often removed shortly after being added, which leaves the gap at the back.
+    while (!ids.empty() && ids.back() == SPRITE_INDEX_NULL)
+    {
+        ids.pop_back();
+        _entityListGaps[static_cast<uint8_t>(list)]--;
+    }
+}
+
 std::string rct_sprite_checksum::ToString() const
 {
     std::string result;
@@ -100,7 +239,41 @@ std::string rct_sprite_checksum::ToString() const
 
 SpriteBase* try_get_sprite(size_t spriteIndex)
 {
-    return spriteIndex >= MAX_SPRITES ? nullptr : &_spriteList[spriteIndex].generic;
+    if (spriteIndex >= _spritePoolSize)
+    {
+        return nullptr;
+    }
+    return &_spriteChunks[spriteIndex / ENTITY_POOL_CHUNK_SIZE][spriteIndex % ENTITY_POOL_CHUNK_SIZE].generic;
+}
+
+size_t GetEntityPoolSize()
+{
+    return _spritePoolSize;
+}
+
+/**
+ * Sets the number of usable entity slots, allocating or releasing chunks as required. New slots are
+ * zeroed but not linked into any list.
+ */
+static void SetEntityPoolSize(size_t newSize)
+{
+    size_t numChunks = (newSize + ENTITY_POOL_CHUNK_SIZE - 1) / ENTITY_POOL_CHUNK_SIZE;
+    _spriteChunks.resize(numChunks);
+    for (auto& chunk : _spriteChunks)
+    {
+        if (chunk == nullptr)
+        {
+            chunk = std::make_unique<rct_sprite[]>(ENTITY_POOL_CHUNK_SIZE);
+        }
+    }
+    _spritePoolSize = newSize;
+    _spriteFlashingList.resize(newSize);
+    _spritelocations1.resize(newSize);
+    _spritelocations2.resize(newSize);
+    _entityChecksums.resize(newSize);
+    _entityChecksumDirty.resize(newSize);
+    _entityListPositions.resize(newSize);
+    _litterSequence.resize(newSize);
 }
 
 SpriteBase* get_sprite(size_t spriteIndex)
@@ -167,18 +340,31 @@ void SpriteBase::Invalidate2()
 void reset_sprite_list()
 {
     gSavedAge = 0;
-    std::memset(static_cast<void*>(_spriteList), 0, sizeof(_spriteList));
+    SetEntityPoolSize(ENTITY_POOL_INITIAL_SIZE);
+    for (auto& chunk : _spriteChunks)
+    {
+        std::memset(static_cast<void*>(chunk.get()), 0, sizeof(rct_sprite) * ENTITY_POOL_CHUNK_SIZE);
+    }
+
+    // No entity contributes to the checksum any more.
+    std::fill(_entityChecksums.begin(), _entityChecksums.end(), 0);
+    std::fill(_entityChecksumDirty.begin(), _entityChecksumDirty.end(), false);
+    _entityChecksumDirtyList.clear();
+    _entityChecksumSum = 0;
+    _entityChecksumXor = 0;
 
     for (int32_t i = 0; i < static_cast<uint8_t>(EntityListId::Count); i++)
     {
         gSpriteListHead[i] = SPRITE_INDEX_NULL;
         gSpriteListCount[i] = 0;
         _spriteFlashingList[i] = false;
+        _entityLists[i].clear();
+        _entityListGaps[i] = 0;
     }
 
     SpriteBase* previous_spr = nullptr;
 
-    for (int32_t i = 0; i < MAX_SPRITES; ++i)
+    for (size_t i = 0; i < _spritePoolSize; ++i)
     {
         auto* spr = GetEntity(i);
         if (spr == nullptr)
@@ -205,7 +391,16 @@ void reset_sprite_list()
         previous_spr = spr;
     }
 
-    gSpriteListCount[static_cast<uint8_t>(EntityListId::Free)] = MAX_SPRITES;
+    gSpriteListCount[static_cast<uint8_t>(EntityListId::Free)] = static_cast<uint16_t>(_spritePoolSize);
+
+    // The free list starts at sprite 0, which has to be at the back.
+    auto& freeList = _entityLists[static_cast<uint8_t>(EntityListId::Free)];
+    freeList.resize(_spritePoolSize);
+    for (size_t i = 0; i < _spritePoolSize; i++)
+    {
+        freeList[i] = static_cast<uint16_t>(_spritePoolSize - 1 - i);
+    }
+    EntityListUpdatePositions(EntityListId::Free);
 
     reset_sprite_spatial_index();
 }
@@ -219,7 +414,7 @@ void reset_sprite_list()
 void reset_sprite_spatial_index()
 {
     std::fill_n(gSpriteSpatialIndex, std::size(gSpriteSpatialIndex), SPRITE_INDEX_NULL);
-    for (size_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < _spritePoolSize; i++)
     {
         auto* spr = GetEntity(i);
         if (spr != nullptr && spr->sprite_identifier != SPRITE_IDENTIFIER_NULL)
@@ -230,6 +425,7 @@ void reset_sprite_spatial_index()
             spr->next_in_quadrant = nextSpriteId;
         }
     }
+    RebuildLitterIndex();
 }
 
 static size_t GetSpatialIndexOffset(int32_t x, int32_t y)
@@ -252,9 +448,154 @@ static size_t GetSpatialIndexOffset(int32_t x, int32_t y)
     return index;
 }
 
-#ifndef DISABLE_NETWORK
+static uint64_t HashEntityBytes(const uint8_t* data, size_t length, uint64_t seed)
+{
+    // Single lane of MurmurHash3 (x64) over 8 byte words, only needs to be fast and identical on every platform.
+    constexpr uint64_t c1 = 0x87c37b91114253d5ULL;
+    constexpr uint64_t c2 = 0x4cf5ad432745937fULL;
+    auto rotl = [](uint64_t x, int r) { return (x << r) | (x >> (64 - r)); };
+
+    uint64_t hash = seed;
+    size_t i = 0;
+    for (; i + sizeof(uint64_t) <= length; i += sizeof(uint64_t))
+    {
+        uint64_t k;
+        std::memcpy(&k, data + i, sizeof(k));
+        k = rotl(k * c1, 31) * c2;
+        hash = rotl(hash ^ k, 27) * 5 + 0x52dce729;
+    }
+
+    uint64_t tail = 0;
+    std::memcpy(&tail, data + i, length - i);
+    hash ^= rotl(tail * c1, 31) * c2;
+    hash ^= length;
+
+    hash ^= hash >> 33;
+    hash *= 0xff51afd7ed558ccdULL;
+    hash ^= hash >> 33;
+    hash *= 0xc4ceb9fe1a85ec53ULL;
+    hash ^= hash >> 33;
+    return hash;
+}
+
+/**
+ * Hashes the game state of a single entity. Misc sprites are purely visual and are not part of the checksum.
+ */
+static uint64_t ComputeEntityChecksum(const SpriteBase* entity)
+{
+    size_t size = 0;
+    switch (entity->sprite_identifier)
+    {
+        case SPRITE_IDENTIFIER_PEEP:
+            size = sizeof(Peep);
+            break;
+        case SPRITE_IDENTIFIER_VEHICLE:
+            size = sizeof(Vehicle);
+            break;
+        case SPRITE_IDENTIFIER_LITTER:
+            size = sizeof(Litter);
+            break;
+        default:
+            return 0;
+    }
+
+    // Only copy the entity type itself, not the whole rct_sprite slot.
+    alignas(rct_sprite) uint8_t buffer[sizeof(rct_sprite)];
+    std::memcpy(buffer, static_cast<const void*>(entity), size);
+    auto copy = reinterpret_cast<rct_sprite*>(buffer);
+
+    // Only required for rendering/invalidation, has no meaning to the game state.
+    copy->generic.sprite_left = copy->generic.sprite_right = copy->generic.sprite_top = copy->generic.sprite_bottom = 0;
+    copy->generic.sprite_width = copy->generic.sprite_height_negative = copy->generic.sprite_height_positive = 0;
+
+    // The quadrant chains only depend on the position of every entity, which is already part of the checksum.
+    // Leaving them out means an entity does not change when its neighbours move.
+    copy->generic.next_in_quadrant = 0;
+
+    if (copy->generic.sprite_identifier == SPRITE_IDENTIFIER_PEEP)
+    {
+        // Name is pointer and will not be the same across clients
+        copy->peep.Name = {};
+
+        // We set this to 0 because as soon the client selects a guest the window will remove the
+        // invalidation flags causing the sprite checksum to be different than on server, the flag does not affect
+        // game state.
+        copy->peep.WindowInvalidateFlags = 0;
+    }
+
+    return HashEntityBytes(buffer, size, entity->sprite_index);
+}
 
+void MarkEntityChecksumDirty(uint16_t spriteIndex)
+{
+    if (spriteIndex < _spritePoolSize && !_entityChecksumDirty[spriteIndex])
+    {
+        _entityChecksumDirty[spriteIndex] = true;
+        _entityChecksumDirtyList.push_back(spriteIndex);
+    }
+}
+
+static void MarkAllEntityChecksumsDirty()
+{
+    for (size_t i = 0; i < _spritePoolSize; i++)
+    {
+        MarkEntityChecksumDirty(static_cast<uint16_t>(i));
+    }
+}
+
+static void UpdateEntityChecksum(uint16_t spriteIndex)
+{
+    auto* entity = try_get_sprite(spriteIndex);
+    uint64_t oldChecksum = _entityChecksums[spriteIndex];
+    uint64_t newChecksum = entity != nullptr ? ComputeEntityChecksum(entity) : 0;
+    _entityChecksums[spriteIndex] = newChecksum;
+    _entityChecksumSum += newChecksum - oldChecksum;
+    _entityChecksumXor ^= oldChecksum ^ newChecksum;
+    _entityChecksumDirty[spriteIndex] = false;
+}
+
+static rct_sprite_checksum MakeSpriteChecksum(uint64_t sum, uint64_t xorSum)
+{
+    rct_sprite_checksum checksum{};
+    std::memcpy(checksum.raw.data(), &sum, sizeof(sum));
+    std::memcpy(checksum.raw.data() + sizeof(sum), &xorSum, sizeof(xorSum));
+    return checksum;
+}
+
+/**
+ * Combines the checksums of all entities. Each entity has its own checksum which is only recomputed when the
+ * entity was marked dirty by the code that modified it since the last checksum, so the cost of this is
+ * proportional to the entities that changed rather than every slot of the entity pool.
+ */
 rct_sprite_checksum sprite_checksum()
+{
+    for (auto spriteIndex : _entityChecksumDirtyList)
+    {
+        UpdateEntityChecksum(spriteIndex);
+    }
+    _entityChecksumDirtyList.clear();
+
+#if DEBUG_LEVEL_1
+    // Cross verify the combined checksum against hashing every entity from scratch.
+    uint64_t fullSum = 0;
+    uint64_t fullXor = 0;
+    for (size_t i = 0; i < _spritePoolSize; i++)
+    {
+        auto entityChecksum = ComputeEntityChecksum(GetEntity(i));
+        fullSum += entityChecksum;
+        fullXor ^= entityChecksum;
+    }
+    openrct2_assert(
+        fullSum == _entityChecksumSum && fullXor == _entityChecksumXor,
+        "Incremental sprite checksum does not match the full checksum, an entity was modified without being marked dirty");
+#endif
+
+    return MakeSpriteChecksum(_entityChecksumSum, _entityChecksumXor);
+}
+
+#ifndef DISABLE_NETWORK
+
+rct_sprite_checksum sprite_checksum_legacy()
 {
     using namespace Crypt;
 
@@ -272,9 +613,8 @@ rct_sprite_checksum sprite_checksum()
         }
 
         _spriteHashAlg->Clear();
-        for (size_t i = 0; i < MAX_SPRITES; i++)
+        for (size_t i = 0; i < _spritePoolSize; i++)
         {
-            // TODO create a way to copy only the specific type
             auto sprite = GetEntity(i);
             if (sprite != nullptr && sprite->sprite_identifier != SPRITE_IDENTIFIER_NULL
                 && sprite->sprite_identifier != SPRITE_IDENTIFIER_MISC)
@@ -300,9 +640,7 @@ rct_sprite_checksum sprite_checksum()
                     // Name is pointer and will not be the same across clients
                     copy.peep.Name = {};
 
-                    // We set this to 0 because as soon the client selects a guest the window will remove the
-                    // invalidation flags causing the sprite checksum to be different than on server, the flag does not affect
-                    // game state.
+                    // See ComputeEntityChecksum.
                     copy.peep.WindowInvalidateFlags = 0;
                 }
 
@@ -314,18 +652,12 @@ rct_sprite_checksum sprite_checksum()
     }
     catch (std::exception& e)
     {
-        log_error("sprite_checksum failed: %s", e.what());
+        log_error("sprite_checksum_legacy failed: %s", e.what());
         throw;
     }
 
     return checksum;
 }
-#else
-
-rct_sprite_checksum sprite_checksum()
-{
-    return rct_sprite_checksum{};
-}
 
 #endif // DISABLE_NETWORK
 
@@ -375,8 +707,66 @@ static void SpriteSpatialInsert(SpriteBase* sprite, const CoordsXY& newLoc);
 
 static constexpr uint16_t MAX_MISC_SPRITES = 300;
 
+/**
+ * Adds another chunk of slots to the entity pool and appends them to the end of the free list, so the
+ * remaining slots that fit in an S6 save are used first. The S6 exporter renumbers the entities past
+ * RCT2_MAX_SPRITES into free slots when saving. The pool does not grow during network games, the map is sent to
+ * joining clients as an S6 save and they would end up with different entity ids than the server.
+ */
+static bool GrowEntityPool()
+{
+    if (_spritePoolSize >= MAX_SPRITES || network_get_mode() != NETWORK_MODE_NONE)
+    {
+        return false;
+    }
+
+    size_t oldSize = _spritePoolSize;
+    SetEntityPoolSize(std::min<size_t>(oldSize + ENTITY_POOL_CHUNK_SIZE, MAX_SPRITES));
+
+    auto& freeList = _entityLists[static_cast<uint8_t>(EntityListId::Free)];
+    SpriteBase* tail = freeList.empty() ? nullptr : GetEntity(freeList.front());
+    std::vector<uint16_t> newIds;
+    newIds.reserve(_spritePoolSize - oldSize);
+    for (size_t i = oldSize; i < _spritePoolSize; i++)
+    {
+        auto* spr = GetEntity(i);
+        std::memset(static_cast<void*>(spr), 0, sizeof(rct_sprite));
+        spr->sprite_identifier = SPRITE_IDENTIFIER_NULL;
+        spr->sprite_index = static_cast<uint16_t>(i);
+        spr->linked_list_index = EntityListId::Free;
+        spr->next_in_quadrant = SPRITE_INDEX_NULL;
+        spr->next = SPRITE_INDEX_NULL;
+        if (tail != nullptr)
+        {
+            spr->previous = tail->sprite_index;
+            tail->next = spr->sprite_index;
+        }
+        else
+        {
+            spr->previous = SPRITE_INDEX_NULL;
+            gSpriteListHead[static_cast<uint8_t>(EntityListId::Free)] = spr->sprite_index;
+        }
+        _spriteFlashingList[i] = false;
+        tail = spr;
+        newIds.push_back(spr->sprite_index);
+    }
+
+    // The tail of the linked list is at the front of the id list.
+    freeList.insert(freeList.begin(), newIds.rbegin(), newIds.rend());
+    EntityListUpdatePositions(EntityListId::Free);
+    gSpriteListCount[static_cast<uint8_t>(EntityListId::Free)] += static_cast<uint16_t>(newIds.size());
+    log_verbose("Entity pool grown to %zu entities", _spritePoolSize);
+    return true;
+}
+
 rct_sprite* create_sprite(SPRITE_IDENTIFIER spriteIdentifier, EntityListId linkedListIndex)
 {
+    // Grow before the free slots reserved for non misc sprites are used up.
+    if (GetEntityListCount(EntityListId::Free) <= MAX_MISC_SPRITES)
+    {
+        GrowEntityPool();
+    }
+
     if (GetEntityListCount(EntityListId::Free) == 0)
     {
         // No free sprites.
@@ -459,6 +849,12 @@ static void move_sprite_to_list(SpriteBase* sprite, EntityListId newListIndex)
         return;
     }
 
+    // The links of the neighbours change as well.
+    MarkEntityChecksumDirty(sprite->sprite_index);
+    MarkEntityChecksumDirty(sprite->previous);
+    MarkEntityChecksumDirty(sprite->next);
+    MarkEntityChecksumDirty(gSpriteListHead[static_cast<uint8_t>(newListIndex)]);
+
     // If the sprite is currently the head of the list, the
     // sprite following this one becomes the new head of the list.
     if (sprite->previous == SPRITE_INDEX_NULL)
@@ -515,6 +911,13 @@ static void move_sprite_to_list(SpriteBase* sprite, EntityListId newListIndex)
         }
     }
 
+    EntityListRemove(oldListIndex, sprite->sprite_index);
+    EntityListAdd(newListIndex, sprite->sprite_index);
+    if (newListIndex == EntityListId::Litter)
+    {
+        _litterSequence[sprite->sprite_index] = _nextLitterSequence++;
+    }
+
     // These globals are probably counters for each sprite list?
     // Decrement old list counter, increment new list counter.
     gSpriteListCount[static_cast<uint8_t>(oldListIndex)]--;
@@ -712,6 +1115,114 @@ static void SpriteSpatialMove(SpriteBase* sprite, const CoordsXY& newLoc)
     SpriteSpatialInsert(sprite, newLoc);
 }
 
+static size_t GetLitterIndexBlock(const CoordsXY& loc)
+{
+    if (loc.x == LOCATION_NULL)
+        return LITTER_INDEX_LOCATION_NULL;
+
+    auto tileX = std::clamp(loc.x / COORDS_XY_STEP, 0, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+    auto tileY = std::clamp(loc.y / COORDS_XY_STEP, 0, MAXIMUM_MAP_SIZE_TECHNICAL - 1);
+    return (tileX / LITTER_INDEX_BLOCK_SIZE) * LITTER_INDEX_BLOCKS + tileY / LITTER_INDEX_BLOCK_SIZE;
+}
+
+static void LitterIndexInsert(const SpriteBase* litter, const CoordsXY& newLoc)
+{
+    auto block = GetLitterIndexBlock(newLoc);
+    if (block != LITTER_INDEX_LOCATION_NULL)
+    {
+        _litterIndex[block].push_back(litter->sprite_index);
+    }
+}
+
+static void LitterIndexRemove(const SpriteBase* litter)
+{
+    auto block = GetLitterIndexBlock({ litter->x, litter->y });
+    if (block == LITTER_INDEX_LOCATION_NULL)
+        return;
+
+    // Order within a block does not matter, see GetNearestLitter.
+    auto& ids = _litterIndex[block];
+    auto it = std::find(ids.begin(), ids.end(), litter->sprite_index);
+    if (it != ids.end())
+    {
+        *it = ids.back();
+        ids.pop_back();
+    }
+}
+
+static void LitterIndexMove(const SpriteBase* litter, const CoordsXY& newLoc)
+{
+    if (GetLitterIndexBlock(newLoc) == GetLitterIndexBlock({ litter->x, litter->y }))
+        return;
+
+    LitterIndexRemove(litter);
+    LitterIndexInsert(litter, newLoc);
+}
+
+static void RebuildLitterIndex()
+{
+    for (auto& ids : _litterIndex)
+    {
+        ids.clear();
+    }
+    for (size_t i = 0; i < _spritePoolSize; i++)
+    {
+        auto* spr = GetEntity(i);
+        if (spr != nullptr && spr->sprite_identifier != SPRITE_IDENTIFIER_NULL
+            && spr->linked_list_index == EntityListId::Litter)
+        {
+            LitterIndexInsert(spr, { spr->x, spr->y });
+        }
+    }
+}
+
+/**
+ * Returns true if litter a comes before litter b when walking the litter list.
+ */
+static bool LitterListPrecedes(uint16_t a, uint16_t b)
+{
+    return _litterSequence[a] > _litterSequence[b];
+}
+
+/**
+ * Returns the litter closest to loc using the handyman metric (x and y distance plus four times the z distance), or
+ * nullptr if there is none within maxDistance. Ties go to the litter that comes first in the litter list, the same
+ * result a walk of the whole list would give.
+ */
+Litter* GetNearestLitter(const CoordsXYZ& loc, int32_t maxDistance)
+{
+    if (loc.x == LOCATION_NULL)
+        return nullptr;
+
+    auto minBlock = GetLitterIndexBlock({ loc.x - maxDistance, loc.y - maxDistance });
+    auto maxBlock = GetLitterIndexBlock({ loc.x + maxDistance, loc.y + maxDistance });
+
+    Litter* nearest = nullptr;
+    int32_t nearestDistance = maxDistance + 1;
+    for (auto blockX = minBlock / LITTER_INDEX_BLOCKS; blockX <= maxBlock / LITTER_INDEX_BLOCKS; blockX++)
+    {
+        for (auto blockY = minBlock % LITTER_INDEX_BLOCKS; blockY <= maxBlock % LITTER_INDEX_BLOCKS; blockY++)
+        {
+            for (auto spriteIndex : _litterIndex[blockX * LITTER_INDEX_BLOCKS + blockY])
+            {
+                auto* litter = GetEntity<Litter>(spriteIndex);
+                if (litter == nullptr)
+                    continue;
+
+                int32_t distance = abs(litter->x - loc.x) + abs(litter->y - loc.y) + abs(litter->z - loc.z) * 4;
+                if (distance < nearestDistance
+                    || (distance == nearestDistance && nearest != nullptr
+                        && LitterListPrecedes(litter->sprite_index, nearest->sprite_index)))
+                {
+                    nearestDistance = distance;
+                    nearest = litter;
+                }
+            }
+        }
+    }
+    return nearest;
+}
+
 /**
  * Moves a sprite to a new location.
  *  rct2: 0x0069E9D3
@@ -730,6 +1241,11 @@ void SpriteBase::MoveTo(const CoordsXYZ& newLocation)
     }
 
     SpriteSpatialMove(this, loc);
+    if (linked_list_index == EntityListId::Litter)
+    {
+        LitterIndexMove(this, loc);
+    }
+    MarkEntityChecksumDirty(sprite_index);
 
     if (loc.x == LOCATION_NULL)
     {
@@ -768,6 +1284,10 @@ void sprite_remove(SpriteBase* sprite)
     {
         peep->SetName({});
     }
+    if (sprite->linked_list_index == EntityListId::Litter)
+    {
+        LitterIndexRemove(sprite);
+    }
 
     move_sprite_to_list(sprite, EntityListId::Free);
     sprite->sprite_identifier = SPRITE_IDENTIFIER_NULL;
@@ -877,7 +1397,7 @@ void litter_remove_at(const CoordsXYZ& litterPos)
 uint16_t remove_floating_sprites()
 {
     uint16_t removed = 0;
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < _spritePoolSize; i++)
     {
         auto* entity = GetEntity(i);
         if (entity->Is<Balloon>())
@@ -917,16 +1437,21 @@ static bool sprite_should_tween(SpriteBase* sprite)
     return false;
 }
 
-static void store_sprite_locations(CoordsXYZ* sprite_locations)
+static void store_sprite_locations(std::vector<CoordsXYZ>& sprite_locations)
 {
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t chunkIndex = 0; chunkIndex < _spriteChunks.size(); chunkIndex++)
     {
         // skip going through `get_sprite` to not get stalled on assert,
         // this can get very expensive for busy parks with uncap FPS option on
-        const rct_sprite* sprite = &_spriteList[i];
-        sprite_locations[i].x = sprite->generic.x;
-        sprite_locations[i].y = sprite->generic.y;
-        sprite_locations[i].z = sprite->generic.z;
+        const rct_sprite* chunk = _spriteChunks[chunkIndex].get();
+        size_t first = chunkIndex * ENTITY_POOL_CHUNK_SIZE;
+        size_t count = std::min(ENTITY_POOL_CHUNK_SIZE, _spritePoolSize - first);
+        for (size_t i = 0; i < count; i++)
+        {
+            sprite_locations[first + i].x = chunk[i].generic.x;
+            sprite_locations[first + i].y = chunk[i].generic.y;
+            sprite_locations[first + i].z = chunk[i].generic.z;
+        }
     }
 }
 
@@ -944,7 +1469,7 @@ void sprite_position_tween_all(float alpha)
 {
     const float inv = (1.0f - alpha);
 
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < _spritePoolSize; i++)
     {
         auto* sprite = GetEntity(i);
         if (sprite != nullptr && sprite_should_tween(sprite))
@@ -970,7 +1495,7 @@ void sprite_position_tween_all(float alpha)
  */
 void sprite_position_tween_restore()
 {
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < _spritePoolSize; i++)
     {
         auto* sprite = GetEntity(i);
         if (sprite != nullptr && sprite_should_tween(sprite))
@@ -985,7 +1510,7 @@ void sprite_position_tween_restore()
 
 void sprite_position_tween_reset()
 {
-    for (uint16_t i = 0; i < MAX_SPRITES; i++)
+    for (size_t i = 0; i < _spritePoolSize; i++)
     {
         auto* sprite = GetEntity(i);
         if (sprite == nullptr)
@@ -1001,13 +1526,13 @@ void sprite_position_tween_reset()
 
 void sprite_set_flashing(SpriteBase* sprite, bool flashing)
 {
-    assert(sprite->sprite_index < MAX_SPRITES);
+    assert(sprite->sprite_index < _spritePoolSize);
     _spriteFlashingList[sprite->sprite_index] = flashing;
 }
 
 bool sprite_get_flashing(SpriteBase* sprite)
 {
-    assert(sprite->sprite_index < MAX_SPRITES);
+    assert(sprite->sprite_index < _spritePoolSize);
     return _spriteFlashingList[sprite->sprite_index];
 }
 
@@ -1100,6 +1625,7 @@ int32_t check_for_sprite_list_cycles(bool fix)
                     spr->next = SPRITE_INDEX_NULL;
                     cycle_start = spr;
                 }
+                RebuildEntityLists();
             }
             return i;
         }
@@ -1115,12 +1641,11 @@ int32_t check_for_sprite_list_cycles(bool fix)
 int32_t fix_disjoint_sprites()
 {
     // Find reachable sprites
-    bool reachable[MAX_SPRITES] = { false };
+    std::vector<bool> reachable(_spritePoolSize, false);
 
     SpriteBase* null_list_tail = nullptr;
     for (uint16_t sprite_idx = gSpriteListHead[static_cast<uint8_t>(EntityListId::Free)]; sprite_idx != SPRITE_INDEX_NULL;)
     {
-        reachable[sprite_idx] = true;
         // cache the tail, so we don't have to walk the list twice
         null_list_tail = GetEntity(sprite_idx);
         if (null_list_tail == nullptr)
@@ -1129,13 +1654,14 @@ int32_t fix_disjoint_sprites()
             sprite_idx = SPRITE_INDEX_NULL;
             return 0;
         }
+        reachable[sprite_idx] = true;
         sprite_idx = null_list_tail->next;
     }
 
     int32_t count = 0;
 
     // Find all null sprites
-    for (uint16_t sprite_idx = 0; sprite_idx < MAX_SPRITES; sprite_idx++)
+    for (uint16_t sprite_idx = 0; sprite_idx < _spritePoolSize; sprite_idx++)
     {
         auto* spr = GetEntity(sprite_idx);
         if (spr != nullptr && spr->sprite_identifier == SPRITE_IDENTIFIER_NULL)
@@ -1162,5 +1688,9 @@ int32_t fix_disjoint_sprites()
             }
         }
     }
+    if (count > 0)
+    {
+        RebuildEntityLists();
+    }
     return count;
 }
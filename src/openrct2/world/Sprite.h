@@ -16,8 +16,19 @@
 #include "Fountain.h"
 #include "SpriteBase.h"
 
+#include <algorithm>
+#include <limits>
+#include <vector>
+
 #define SPRITE_INDEX_NULL 0xFFFF
-#define MAX_SPRITES 10000
+// Upper limit of the entity pool, every id must stay below SPRITE_INDEX_NULL. Ids stay 16 bit as rides, vehicles, peeps,
+// game actions and the network protocol all store them as uint16_t. Ids from outside the simulation (game actions)
+// are checked against GetEntityPoolSize().
+#define MAX_SPRITES 0xFFFF
+
+// The entity pool starts at the size of the RCT2 sprite array and grows in chunks when it runs out of free slots.
+constexpr const size_t ENTITY_POOL_INITIAL_SIZE = 10000;
+constexpr const size_t ENTITY_POOL_CHUNK_SIZE = 2000;
 
 enum SPRITE_IDENTIFIER
 {
@@ -216,6 +227,11 @@ template<typename T = SpriteBase> T* TryGetEntity(size_t sprite_idx)
 }
 
 uint16_t GetEntityListCount(EntityListId list);
+size_t GetEntityPoolSize();
+const std::vector<uint16_t>& GetEntityList(EntityListId list);
+void EntityListIterationBegin();
+void EntityListIterationEnd();
+void RebuildEntityLists();
 extern uint16_t gSpriteListHead[static_cast<uint8_t>(EntityListId::Count)];
 extern uint16_t gSpriteListCount[static_cast<uint8_t>(EntityListId::Count)];
 
@@ -235,6 +251,7 @@ void sprite_set_coordinates(const CoordsXYZ& spritePos, SpriteBase* sprite);
 void sprite_remove(SpriteBase* sprite);
 void litter_create(const CoordsXYZD& litterPos, int32_t type);
 void litter_remove_at(const CoordsXYZ& litterPos);
+Litter* GetNearestLitter(const CoordsXYZ& loc, int32_t maxDistance);
 uint16_t remove_floating_sprites();
 void sprite_misc_explosion_cloud_create(const CoordsXYZ& cloudPos);
 void sprite_misc_explosion_flare_create(const CoordsXYZ& flarePos);
@@ -265,6 +282,11 @@ void crashed_vehicle_particle_create(rct_vehicle_colour colours, const CoordsXYZ
 void crash_splash_create(const CoordsXYZ& splashPos);
 
 rct_sprite_checksum sprite_checksum();
+// The SHA-1 of every entity slot that was used as the checksum before the per entity checksums, only kept to verify
+// replays recorded with it.
+rct_sprite_checksum sprite_checksum_legacy();
+// Has to be called for every entity whose game state is modified, its checksum is recomputed at the next checksum.
+void MarkEntityChecksumDirty(uint16_t spriteIndex);
 
 void sprite_set_flashing(SpriteBase* sprite, bool flashing);
 bool sprite_get_flashing(SpriteBase* sprite);
@@ -349,25 +371,299 @@ public:
     }
 };
 
+/**
+ * Iterates the entities of type T whose position lies inside a rectangle of map coordinates (inclusive),
+ * optionally limited to a radius around a centre. Only the tiles of the spatial index that overlap the
+ * rectangle are visited.
+ */
+template<typename T = SpriteBase> class EntityRectIterator
+{
+private:
+    MapRange Range = { 0, 0, -1, -1 };
+    int32_t TileX = 0;
+    int32_t TileY = 0;
+    int32_t TileLeft = 0;
+    int32_t TileRight = -1;
+    int32_t TileBottom = -1;
+    uint16_t NextEntityId = SPRITE_INDEX_NULL;
+    CoordsXY Centre;
+    int64_t RadiusSquared = -1;
+    T* Entity = nullptr;
+
+    bool IsInRange(const SpriteBase* entity) const
+    {
+        if (entity->x < Range.GetLeft() || entity->x > Range.GetRight() || entity->y < Range.GetTop()
+            || entity->y > Range.GetBottom())
+        {
+            return false;
+        }
+        if (RadiusSquared >= 0)
+        {
+            int64_t dx = entity->x - Centre.x;
+            int64_t dy = entity->y - Centre.y;
+            return dx * dx + dy * dy <= RadiusSquared;
+        }
+        return true;
+    }
+
+public:
+    EntityRectIterator() = default;
+    EntityRectIterator(const CoordsXY& centre, int32_t radius)
+        : EntityRectIterator({ centre.x - radius, centre.y - radius, centre.x + radius, centre.y + radius }, centre, radius)
+    {
+    }
+    EntityRectIterator(const MapRange& range, const CoordsXY& centre = {}, int32_t radius = -1)
+        : Range(range.Normalise())
+        , Centre(centre)
+        , RadiusSquared(radius >= 0 ? static_cast<int64_t>(radius) * radius : -1)
+    {
+        constexpr int32_t maxTile = MAXIMUM_MAP_SIZE_TECHNICAL - 1;
+        TileLeft = std::clamp(Range.GetLeft() / COORDS_XY_STEP, 0, maxTile);
+        TileRight = std::clamp(Range.GetRight() / COORDS_XY_STEP, 0, maxTile);
+        TileBottom = std::clamp(Range.GetBottom() / COORDS_XY_STEP, 0, maxTile);
+        TileX = TileLeft;
+        TileY = std::clamp(Range.GetTop() / COORDS_XY_STEP, 0, maxTile);
+        if (Range.GetRight() < 0 || Range.GetBottom() < 0)
+        {
+            TileY = TileBottom + 1;
+            return;
+        }
+        NextEntityId = sprite_get_first_in_quadrant(TileCoordsXY{ TileX, TileY }.ToCoordsXY());
+        ++(*this);
+    }
+    EntityRectIterator& operator++()
+    {
+        Entity = nullptr;
+        while (TileY <= TileBottom)
+        {
+            while (NextEntityId != SPRITE_INDEX_NULL)
+            {
+                auto baseEntity = GetEntity(NextEntityId);
+                if (baseEntity == nullptr)
+                {
+                    NextEntityId = SPRITE_INDEX_NULL;
+                    break;
+                }
+                NextEntityId = baseEntity->next_in_quadrant;
+                if (!IsInRange(baseEntity))
+                {
+                    continue;
+                }
+                Entity = baseEntity->template As<T>();
+                if (Entity != nullptr)
+                {
+                    return *this;
+                }
+            }
+
+            if (++TileX > TileRight)
+            {
+                TileX = TileLeft;
+                TileY++;
+            }
+            if (TileY <= TileBottom)
+            {
+                NextEntityId = sprite_get_first_in_quadrant(TileCoordsXY{ TileX, TileY }.ToCoordsXY());
+            }
+        }
+        return *this;
+    }
+
+    EntityRectIterator operator++(int)
+    {
+        EntityRectIterator retval = *this;
+        ++(*this);
+        return retval;
+    }
+    bool operator==(EntityRectIterator other) const
+    {
+        return Entity == other.Entity;
+    }
+    bool operator!=(EntityRectIterator other) const
+    {
+        return !(*this == other);
+    }
+    T* operator*()
+    {
+        return Entity;
+    }
+    // iterator traits
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = const T*;
+    using reference = const T&;
+    using iterator_category = std::forward_iterator_tag;
+};
+
+template<typename T = SpriteBase> class EntityRectList
+{
+private:
+    MapRange Range;
+
+public:
+    EntityRectList(const MapRange& range)
+        : Range(range)
+    {
+    }
+
+    EntityRectIterator<T> begin()
+    {
+        return EntityRectIterator<T>(Range);
+    }
+    EntityRectIterator<T> end()
+    {
+        return EntityRectIterator<T>();
+    }
+};
+
+/**
+ * Iterates the entities of type T within a radius of a map position.
+ */
+template<typename T = SpriteBase> class EntityRadiusList
+{
+private:
+    CoordsXY Centre;
+    int32_t Radius;
+
+public:
+    EntityRadiusList(const CoordsXY& centre, int32_t radius)
+        : Centre(centre)
+        , Radius(radius)
+    {
+    }
+
+    EntityRectIterator<T> begin()
+    {
+        return EntityRectIterator<T>(Centre, Radius);
+    }
+    EntityRectIterator<T> end()
+    {
+        return EntityRectIterator<T>();
+    }
+};
+
+/**
+ * Returns the entity of type T within maxDistance (on both axes) of loc for which distanceFn returns the lowest value,
+ * or nullptr if there is none. When several entities have the same distance, tieBreakFn(a, b) returns true if a should
+ * be preferred over b.
+ */
+template<typename T, typename TDistanceFn, typename TTieBreakFn>
+T* GetNearestEntity(const CoordsXY& loc, int32_t maxDistance, TDistanceFn distanceFn, TTieBreakFn tieBreakFn)
+{
+    T* nearest = nullptr;
+    int32_t nearestDistance = std::numeric_limits<int32_t>::max();
+    for (auto entity : EntityRectList<T>({ loc.x - maxDistance, loc.y - maxDistance, loc.x + maxDistance, loc.y + maxDistance }))
+    {
+        int32_t distance = distanceFn(entity);
+        if (distance < nearestDistance || (distance == nearestDistance && nearest != nullptr && tieBreakFn(entity, nearest)))
+        {
+            nearestDistance = distance;
+            nearest = entity;
+        }
+    }
+    return nearest;
+}
+
+template<typename T> class EntityListIterator
+{
+private:
+    const std::vector<uint16_t>* Ids = nullptr;
+    size_t Index = 0;
+    T* Entity = nullptr;
+
+public:
+    EntityListIterator(const std::vector<uint16_t>* ids)
+        : Ids(ids)
+        , Index(ids != nullptr ? ids->size() : 0)
+    {
+        ++(*this);
+    }
+    EntityListIterator& operator++()
+    {
+        if (Ids == nullptr)
+        {
+            return *this;
+        }
+
+        // The list can be modified while iterating it. Removed entities leave a gap rather than moving the
+        // ones below them, only gaps at the back are dropped.
+        Index = std::min(Index, Ids->size());
+
+        Entity = nullptr;
+        while (Index > 0 && Entity == nullptr)
+        {
+            Index--;
+            if ((*Ids)[Index] == SPRITE_INDEX_NULL)
+            {
+                continue;
+            }
+            auto baseEntity = GetEntity((*Ids)[Index]);
+            if (baseEntity != nullptr)
+            {
+                Entity = baseEntity->template As<T>();
+            }
+        }
+        return *this;
+    }
+
+    EntityListIterator operator++(int)
+    {
+        EntityListIterator retval = *this;
+        ++(*this);
+        return retval;
+    }
+    bool operator==(EntityListIterator other) const
+    {
+        return Entity == other.Entity;
+    }
+    bool operator!=(EntityListIterator other) const
+    {
+        return !(*this == other);
+    }
+    T* operator*()
+    {
+        return Entity;
+    }
+    // iterator traits
+    using difference_type = std::ptrdiff_t;
+    using value_type = T;
+    using pointer = const T*;
+    using reference = const T&;
+    using iterator_category = std::forward_iterator_tag;
+};
+
+/**
+ * Iterates the entities of a list in linked list order. The entity ids of each list are stored
+ * contiguously (see GetEntityList) so walking a list does not chase the next pointer of every entity.
+ * The gaps left by removed entities are only closed while no EntityList exists.
+ */
 template<typename T = SpriteBase> class EntityList
 {
 private:
-    uint16_t FirstEntity = SPRITE_INDEX_NULL;
-    using EntityListIterator = EntityIterator<T, &SpriteBase::next>;
+    const std::vector<uint16_t>& Ids;
 
 public:
     EntityList(EntityListId type)
-        : FirstEntity(gSpriteListHead[static_cast<uint8_t>(type)])
+        : Ids(GetEntityList(type))
     {
+        EntityListIterationBegin();
     }
 
-    EntityListIterator begin()
+    ~EntityList()
+    {
+        EntityListIterationEnd();
+    }
+
+    EntityList(const EntityList&) = delete;
+    EntityList& operator=(const EntityList&) = delete;
+
+    EntityListIterator<T> begin()
     {
-        return EntityListIterator(FirstEntity);
+        return EntityListIterator<T>(&Ids);
     }
-    EntityListIterator end()
+    EntityListIterator<T> end()
     {
-        return EntityListIterator(SPRITE_INDEX_NULL);
+        return EntityListIterator<T>(nullptr);
     }
 };
 
@@ -166,9 +166,9 @@ void TileElement::ClearAs(uint8_t newType)
     std::fill_n(pad_08, sizeof(pad_08), 0x00);
 }
 
-void TileElementBase::Remove()
+void TileElementBase::Remove(const CoordsXY& loc)
 {
-    tile_element_remove(static_cast<TileElement*>(this));
+    tile_element_remove(loc, static_cast<TileElement*>(this));
 }
 
 // Rotate both of the values amount
@@ -72,7 +72,7 @@ struct TileElementBase
     uint8_t base_height;      // 2
     uint8_t clearance_height; // 3
 
-    void Remove();
+    void Remove(const CoordsXY& loc);
 
     uint8_t GetType() const;
     void SetType(uint8_t newType);
@@ -17,6 +17,7 @@
 #include "../interface/Window.h"
 #include "../interface/Window_internal.h"
 #include "../localisation/Localisation.h"
+#include "../ride/RideVisibility.h"
 #include "../ride/Station.h"
 #include "../ride/Track.h"
 #include "../windows/Intent.h"
@@ -217,8 +218,9 @@ GameActionResult::Ptr tile_inspector_remove_element_at(const CoordsXY& loc, int1
             tile_element_remove_banner_entry(tileElement);
         }
 
-        tile_element_remove(tileElement);
+        tile_element_remove(loc, tileElement);
         map_invalidate_tile_full(loc);
+        RideVisibilityInvalidateTile(loc);
 
         // Update the window
         rct_window* const tileInspectorWindow = window_find_by_class(WC_TILE_INSPECTOR);
@@ -389,6 +391,7 @@ GameActionResult::Ptr tile_inspector_paste_element_at(const CoordsXY& loc, TileE
         pastedElement->SetLastForTile(lastForTile);
 
         map_invalidate_tile_full(loc);
+        RideVisibilityInvalidateTile(loc);
 
         rct_window* const tileInspectorWindow = window_find_by_class(WC_TILE_INSPECTOR);
         if (tileInspectorWindow != nullptr && tileLoc == windowTileInspectorTile)
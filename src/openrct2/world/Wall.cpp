@@ -39,7 +39,7 @@ void wall_remove_at(const CoordsXYRangedZ& wallPos)
     {
         tile_element_remove_banner_entry(reinterpret_cast<TileElement*>(wallElement));
         map_invalidate_tile_zoom1({ wallPos, wallElement->GetBaseZ(), wallElement->GetBaseZ() + 72 });
-        tile_element_remove(reinterpret_cast<TileElement*>(wallElement));
+        tile_element_remove(wallPos, reinterpret_cast<TileElement*>(wallElement));
     }
 }
 
@@ -76,7 +76,7 @@ void wall_remove_intersecting_walls(const CoordsXYRangedZ& wallPos, Direction di
 
         tile_element_remove_banner_entry(tileElement);
         map_invalidate_tile_zoom1({ wallPos, tileElement->GetBaseZ(), tileElement->GetBaseZ() + 72 });
-        tile_element_remove(tileElement);
+        tile_element_remove(wallPos, tileElement);
         tileElement--;
     } while (!(tileElement++)->IsLastForTile());
 }
@@ -0,0 +1,330 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include "TestData.h"
+
+#include <gtest/gtest.h>
+#include <openrct2/Context.h>
+#include <openrct2/Game.h>
+#include <openrct2/Intro.h>
+#include <openrct2/OpenRCT2.h>
+#include <openrct2/drawing/Drawing.h>
+#include <openrct2/interface/Viewport.h>
+#include <openrct2/paint/Paint.h>
+#include <openrct2/platform/platform.h>
+#include <openrct2/world/Map.h>
+#include <openrct2/world/Sprite.h>
+#include <cstdlib>
+#include <vector>
+
+using namespace OpenRCT2;
+
+// The arrange as it was before the paint structs were copied into a flat buffer, to check that the order is the same.
+template<uint8_t>
+static bool old_check_bounding_box(const paint_struct_bound_box& initialBBox, const paint_struct_bound_box& currentBBox)
+{
+    return false;
+}
+
+template<> bool old_check_bounding_box<0>(const paint_struct_bound_box& initialBBox, const paint_struct_bound_box& currentBBox)
+{
+    if (initialBBox.z_end >= currentBBox.z && initialBBox.y_end >= currentBBox.y && initialBBox.x_end >= currentBBox.x
+        && !(initialBBox.z < currentBBox.z_end && initialBBox.y < currentBBox.y_end && initialBBox.x < currentBBox.x_end))
+    {
+        return true;
+    }
+    return false;
+}
+
+template<> bool old_check_bounding_box<1>(const paint_struct_bound_box& initialBBox, const paint_struct_bound_box& currentBBox)
+{
+    if (initialBBox.z_end >= currentBBox.z && initialBBox.y_end >= currentBBox.y && initialBBox.x_end < currentBBox.x
+        && !(initialBBox.z < currentBBox.z_end && initialBBox.y < currentBBox.y_end && initialBBox.x >= currentBBox.x_end))
+    {
+        return true;
+    }
+    return false;
+}
+
+template<> bool old_check_bounding_box<2>(const paint_struct_bound_box& initialBBox, const paint_struct_bound_box& currentBBox)
+{
+    if (initialBBox.z_end >= currentBBox.z && initialBBox.y_end < currentBBox.y && initialBBox.x_end < currentBBox.x
+        && !(initialBBox.z < currentBBox.z_end && initialBBox.y >= currentBBox.y_end && initialBBox.x >= currentBBox.x_end))
+    {
+        return true;
+    }
+    return false;
+}
+
+template<> bool old_check_bounding_box<3>(const paint_struct_bound_box& initialBBox, const paint_struct_bound_box& currentBBox)
+{
+    if (initialBBox.z_end >= currentBBox.z && initialBBox.y_end < currentBBox.y && initialBBox.x_end >= currentBBox.x
+        && !(initialBBox.z < currentBBox.z_end && initialBBox.y >= currentBBox.y_end && initialBBox.x < currentBBox.x_end))
+    {
+        return true;
+    }
+    return false;
+}
+
+template<uint8_t _TRotation>
+static paint_struct* old_arrange_structs_helper_rotation(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag)
+{
+    paint_struct* ps;
+    paint_struct* ps_temp;
+    do
+    {
+        ps = ps_next;
+        ps_next = ps_next->next_quadrant_ps;
+        if (ps_next == nullptr)
+            return ps;
+    } while (quadrantIndex > ps_next->quadrant_index);
+
+    // Cache the last visited node so we don't have to walk the whole list again
+    paint_struct* ps_cache = ps;
+
+    ps_temp = ps;
+    do
+    {
+        ps = ps->next_quadrant_ps;
+        if (ps == nullptr)
+            break;
+
+        if (ps->quadrant_index > quadrantIndex + 1)
+        {
+            ps->quadrant_flags = PAINT_QUADRANT_FLAG_BIGGER;
+        }
+        else if (ps->quadrant_index == quadrantIndex + 1)
+        {
+            ps->quadrant_flags = PAINT_QUADRANT_FLAG_NEXT | PAINT_QUADRANT_FLAG_IDENTICAL;
+        }
+        else if (ps->quadrant_index == quadrantIndex)
+        {
+            ps->quadrant_flags = flag | PAINT_QUADRANT_FLAG_IDENTICAL;
+        }
+    } while (ps->quadrant_index <= quadrantIndex + 1);
+    ps = ps_temp;
+
+    while (true)
+    {
+        while (true)
+        {
+            ps_next = ps->next_quadrant_ps;
+            if (ps_next == nullptr)
+                return ps_cache;
+            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
+                return ps_cache;
+            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_IDENTICAL)
+                break;
+            ps = ps_next;
+        }
+
+        ps_next->quadrant_flags &= ~PAINT_QUADRANT_FLAG_IDENTICAL;
+        ps_temp = ps;
+
+        const paint_struct_bound_box& initialBBox = ps_next->bounds;
+
+        while (true)
+        {
+            ps = ps_next;
+            ps_next = ps_next->next_quadrant_ps;
+            if (ps_next == nullptr)
+                break;
+            if (ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_BIGGER)
+                break;
+            if (!(ps_next->quadrant_flags & PAINT_QUADRANT_FLAG_NEXT))
+                continue;
+
+            const paint_struct_bound_box& currentBBox = ps_next->bounds;
+
+            const bool compareResult = old_check_bounding_box<_TRotation>(initialBBox, currentBBox);
+
+            if (compareResult)
+            {
+                ps->next_quadrant_ps = ps_next->next_quadrant_ps;
+                paint_struct* ps_temp2 = ps_temp->next_quadrant_ps;
+                ps_temp->next_quadrant_ps = ps_next;
+                ps_next->next_quadrant_ps = ps_temp2;
+                ps_next = ps;
+            }
+        }
+
+        ps = ps_temp;
+    }
+}
+
+static paint_struct* old_arrange_structs_helper(paint_struct* ps_next, uint16_t quadrantIndex, uint8_t flag, uint8_t rotation)
+{
+    switch (rotation)
+    {
+        case 0:
+            return old_arrange_structs_helper_rotation<0>(ps_next, quadrantIndex, flag);
+        case 1:
+            return old_arrange_structs_helper_rotation<1>(ps_next, quadrantIndex, flag);
+        case 2:
+            return old_arrange_structs_helper_rotation<2>(ps_next, quadrantIndex, flag);
+        case 3:
+            return old_arrange_structs_helper_rotation<3>(ps_next, quadrantIndex, flag);
+    }
+    return nullptr;
+}
+
+static void old_session_arrange(paint_session* session)
+{
+    paint_struct* psHead = &session->PaintHead;
+
+    paint_struct* ps = psHead;
+    ps->next_quadrant_ps = nullptr;
+
+    uint32_t quadrantIndex = session->QuadrantBackIndex;
+    if (quadrantIndex != UINT32_MAX)
+    {
+        do
+        {
+            paint_struct* ps_next = session->Quadrants[quadrantIndex];
+            if (ps_next != nullptr)
+            {
+                ps->next_quadrant_ps = ps_next;
+                do
+                {
+                    ps = ps_next;
+                    ps_next = ps_next->next_quadrant_ps;
+
+                } while (ps_next != nullptr);
+            }
+        } while (++quadrantIndex <= session->QuadrantFrontIndex);
+
+        paint_struct* ps_cache = old_arrange_structs_helper(
+            psHead, session->QuadrantBackIndex & 0xFFFF, PAINT_QUADRANT_FLAG_NEXT, session->CurrentRotation);
+
+        quadrantIndex = session->QuadrantBackIndex;
+        while (++quadrantIndex < session->QuadrantFrontIndex)
+        {
+            ps_cache = old_arrange_structs_helper(ps_cache, quadrantIndex & 0xFFFF, 0, session->CurrentRotation);
+        }
+    }
+}
+
+static paint_struct* FixupPointer(paint_struct* index, std::vector<paint_entry>& entries)
+{
+    auto entryIndex = reinterpret_cast<uintptr_t>(index);
+    return entryIndex == 0 ? nullptr : &entries[entryIndex - 1].basic;
+}
+
+// Recorded sessions point to their entries by index, see record_session.
+static void FixupPointers(RecordedPaintSession& recorded)
+{
+    for (auto& entry : recorded.Entries)
+    {
+        entry.basic.next_quadrant_ps = FixupPointer(entry.basic.next_quadrant_ps, recorded.Entries);
+    }
+    for (auto& quadrant : recorded.Session.Quadrants)
+    {
+        quadrant = FixupPointer(quadrant, recorded.Entries);
+    }
+}
+
+struct ArrangedStruct
+{
+    size_t EntryIndex;
+    uint8_t QuadrantFlags;
+
+    bool operator==(const ArrangedStruct& other) const
+    {
+        return EntryIndex == other.EntryIndex && QuadrantFlags == other.QuadrantFlags;
+    }
+};
+
+static void PrintTo(const ArrangedStruct& arranged, std::ostream* os)
+{
+    *os << arranged.EntryIndex << " (flags " << static_cast<int32_t>(arranged.QuadrantFlags) << ")";
+}
+
+static std::vector<ArrangedStruct> GetArrangedOrder(const RecordedPaintSession& recorded)
+{
+    std::vector<ArrangedStruct> order;
+    for (auto ps = recorded.Session.PaintHead.next_quadrant_ps; ps != nullptr; ps = ps->next_quadrant_ps)
+    {
+        auto entryIndex = reinterpret_cast<const paint_entry*>(ps) - recorded.Entries.data();
+        order.push_back({ static_cast<size_t>(entryIndex), ps->quadrant_flags });
+    }
+    return order;
+}
+
+static std::vector<RecordedPaintSession> RecordPaintSessions(const std::string& parkPath, uint8_t rotation)
+{
+    std::vector<RecordedPaintSession> sessions;
+
+    auto context = CreateContext();
+    if (!context->Initialise())
+        return sessions;
+
+    drawing_engine_init();
+    if (context->LoadParkFromFile(parkPath))
+    {
+        gIntroState = IntroState::None;
+        gScreenFlags = SCREEN_FLAGS_PLAYING;
+
+        rct_viewport viewport{};
+        viewport.width = 1024;
+        viewport.height = 512;
+        viewport.view_width = viewport.width;
+        viewport.view_height = viewport.height;
+
+        auto centre = CoordsXY{ (gMapSize / 2) * 32 + 16, (gMapSize / 2) * 32 + 16 };
+        auto z = tile_element_height(centre);
+        viewport.viewPos = { centre.y - centre.x - (viewport.view_width / 2),
+                             ((centre.x + centre.y) / 2) - z - (viewport.view_height / 2) };
+        gCurrentRotation = rotation;
+
+        // Ensure sprites appear regardless of rotation
+        reset_all_sprite_quadrant_placements();
+
+        rct_drawpixelinfo dpi{};
+        dpi.width = viewport.width;
+        dpi.height = viewport.height;
+        dpi.bits = static_cast<uint8_t*>(malloc(dpi.width * dpi.height));
+        viewport_render(&dpi, &viewport, 0, 0, viewport.width, viewport.height, &sessions);
+        free(dpi.bits);
+    }
+    drawing_engine_dispose();
+    return sessions;
+}
+
+class PaintArrangeTests : public testing::TestWithParam<uint8_t>
+{
+};
+
+TEST_P(PaintArrangeTests, SameOrderAsOldArrange)
+{
+    gOpenRCT2Headless = true;
+    core_init();
+
+    auto rotation = GetParam();
+    auto sessions = RecordPaintSessions(TestData::GetParkPath("BigMapTest.sv6"), rotation);
+    ASSERT_FALSE(sessions.empty());
+
+    size_t numArranged = 0;
+    for (const auto& recorded : sessions)
+    {
+        auto old = recorded;
+        FixupPointers(old);
+        old_session_arrange(&old.Session);
+
+        auto arranged = recorded;
+        FixupPointers(arranged);
+        paint_session_arrange(&arranged.Session);
+
+        auto oldOrder = GetArrangedOrder(old);
+        ASSERT_EQ(oldOrder, GetArrangedOrder(arranged)) << "Rotation " << static_cast<int32_t>(rotation);
+        numArranged += oldOrder.size();
+    }
+    EXPECT_GT(numArranged, 0U);
+}
+
+INSTANTIATE_TEST_CASE_P(Rotation, PaintArrangeTests, testing::Values(0, 1, 2, 3));
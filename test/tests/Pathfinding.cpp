@@ -1,5 +1,6 @@
 #include "TestData.h"
 #include "openrct2/core/StringReader.hpp"
+#include "openrct2/peep/FootpathGraph.h"
 #include "openrct2/peep/GuestPathfinding.h"
 #include "openrct2/peep/Peep.h"
 #include "openrct2/ride/Station.h"
@@ -171,11 +172,18 @@ struct SimplePathfindingScenario
     const char* name;
     TileCoordsXYZ start;
     uint32_t steps;
+    // The direction the footpath graph leaves start in and the number of tiles on its route to the goal.
+    Direction direction;
+    uint32_t routeLength;
 
-    SimplePathfindingScenario(const char* _name, const TileCoordsXYZ& _start, int _steps)
+    SimplePathfindingScenario(
+        const char* _name, const TileCoordsXYZ& _start, int _steps, Direction _direction = INVALID_DIRECTION,
+        uint32_t _routeLength = 0)
         : name(_name)
         , start(_start)
         , steps(_steps)
+        , direction(_direction)
+        , routeLength(_routeLength)
     {
     }
 
@@ -212,16 +220,38 @@ TEST_P(SimplePathfindingTest, CanFindPathFromStartToGoal)
     EXPECT_TRUE(succeeded);
 }
 
+TEST_P(SimplePathfindingTest, FootpathGraphFindsRouteToGoal)
+{
+    const SimplePathfindingScenario& scenario = GetParam();
+
+    auto ride = FindRideByName(scenario.name);
+    ASSERT_NE(ride, nullptr);
+
+    auto entrancePos = ride_get_entrance_location(ride, 0);
+    TileCoordsXYZ goal = TileCoordsXYZ(
+        entrancePos.x - TileDirectionDelta[entrancePos.direction].x,
+        entrancePos.y - TileDirectionDelta[entrancePos.direction].y, entrancePos.z);
+
+    const Direction direction = FootpathGraphChooseDirection(scenario.start, 0xF, goal, ride->id, true);
+    EXPECT_EQ(direction, scenario.direction);
+
+    auto length = FootpathGraphGetRouteLength(scenario.start, scenario.direction, goal, ride->id, true);
+    ASSERT_TRUE(length.has_value());
+    EXPECT_EQ(*length, scenario.routeLength);
+}
+
 INSTANTIATE_TEST_CASE_P(
     ForScenario, SimplePathfindingTest,
     ::testing::Values(
-        SimplePathfindingScenario("StraightFlat", { 19, 15, 14 }, 24), SimplePathfindingScenario("SBend", { 15, 12, 14 }, 88),
-        SimplePathfindingScenario("UBend", { 17, 9, 14 }, 86), SimplePathfindingScenario("CBend", { 14, 5, 14 }, 164),
-        SimplePathfindingScenario("TwoEqualRoutes", { 9, 13, 14 }, 87),
-        SimplePathfindingScenario("TwoUnequalRoutes", { 3, 13, 14 }, 87),
-        SimplePathfindingScenario("StraightUpBridge", { 12, 15, 14 }, 24),
-        SimplePathfindingScenario("StraightUpSlope", { 14, 15, 14 }, 24),
-        SimplePathfindingScenario("SelfCrossingPath", { 6, 5, 14 }, 213)),
+        SimplePathfindingScenario("StraightFlat", { 19, 15, 14 }, 24, 1, 2),
+        SimplePathfindingScenario("SBend", { 15, 12, 14 }, 88, 1, 6),
+        SimplePathfindingScenario("UBend", { 17, 9, 14 }, 86, 3, 6),
+        SimplePathfindingScenario("CBend", { 14, 5, 14 }, 164, 3, 11),
+        SimplePathfindingScenario("TwoEqualRoutes", { 9, 13, 14 }, 87, 1, 6),
+        SimplePathfindingScenario("TwoUnequalRoutes", { 3, 13, 14 }, 87, 1, 6),
+        SimplePathfindingScenario("StraightUpBridge", { 12, 15, 14 }, 24, 1, 2),
+        SimplePathfindingScenario("StraightUpSlope", { 14, 15, 14 }, 24, 1, 2),
+        SimplePathfindingScenario("SelfCrossingPath", { 6, 5, 14 }, 213, 3, 14)),
     SimplePathfindingScenario::ToName);
 
 class ImpossiblePathfindingTest : public PathfindingTestBase, public ::testing::WithParamInterface<SimplePathfindingScenario>
@@ -245,6 +275,21 @@ TEST_P(ImpossiblePathfindingTest, CannotFindPathFromStartToGoal)
     EXPECT_FALSE(FindPath(&pos, goal, 10000, ride->id));
 }
 
+TEST_P(ImpossiblePathfindingTest, FootpathGraphFindsNoRouteToGoal)
+{
+    const SimplePathfindingScenario& scenario = GetParam();
+
+    auto ride = FindRideByName(scenario.name);
+    ASSERT_NE(ride, nullptr);
+
+    auto entrancePos = ride_get_entrance_location(ride, 0);
+    TileCoordsXYZ goal = TileCoordsXYZ(
+        entrancePos.x + TileDirectionDelta[entrancePos.direction].x,
+        entrancePos.y + TileDirectionDelta[entrancePos.direction].y, entrancePos.z);
+
+    EXPECT_EQ(FootpathGraphChooseDirection(scenario.start, 0xF, goal, ride->id, true), INVALID_DIRECTION);
+}
+
 INSTANTIATE_TEST_CASE_P(
     ForScenario, ImpossiblePathfindingTest,
     ::testing::Values(
@@ -98,7 +98,7 @@ TEST_P(ReplayTests, RunReplay)
     while (replayManager->IsReplaying())
     {
         gs->UpdateLogic();
-        ASSERT_TRUE(replayManager->IsPlaybackStateMismatching() == false);
+        ASSERT_TRUE(replayManager->IsPlaybackStateMismatching() == false) << "Checksum mismatch at tick " << gCurrentTicks;
     }
 #endif
 }
@@ -23,6 +23,7 @@
 #include <openrct2/core/MemoryStream.h>
 #include <openrct2/core/Path.hpp>
 #include <openrct2/core/String.hpp>
+#include <openrct2/network/NetworkMapResync.h>
 #include <openrct2/network/network.h>
 #include <openrct2/object/ObjectManager.h>
 #include <openrct2/platform/platform.h>
@@ -30,14 +31,18 @@
 #include <openrct2/ride/Ride.h>
 #include <openrct2/world/Park.h>
 #include <openrct2/world/Sprite.h>
+#include <openrct2/world/Surface.h>
+#include <algorithm>
+#include <cstring>
 #include <stdio.h>
 #include <string>
+#include <vector>
 
 using namespace OpenRCT2;
 
 struct GameState_t
 {
-    rct_sprite sprites[MAX_SPRITES];
+    std::vector<rct_sprite> sprites;
 };
 
 static bool LoadFileToBuffer(MemoryStream& stream, const std::string& filePath)
@@ -106,7 +111,8 @@ static bool ExportSave(MemoryStream& stream, std::unique_ptr<IContext>& context)
 static std::unique_ptr<GameState_t> GetGameState(std::unique_ptr<IContext>& context)
 {
     std::unique_ptr<GameState_t> res = std::make_unique<GameState_t>();
-    for (size_t spriteIdx = 0; spriteIdx < MAX_SPRITES; spriteIdx++)
+    res->sprites.resize(GetEntityPoolSize());
+    for (size_t spriteIdx = 0; spriteIdx < res->sprites.size(); spriteIdx++)
     {
         rct_sprite* sprite = reinterpret_cast<rct_sprite*>(GetEntity(spriteIdx));
         if (sprite == nullptr)
@@ -459,7 +465,9 @@ static void CompareStates(
             static_cast<unsigned long long>(exportBuffer.GetLength()));
     }
 
-    for (size_t spriteIdx = 0; spriteIdx < MAX_SPRITES; ++spriteIdx)
+    EXPECT_EQ(importedState->sprites.size(), exportedState->sprites.size());
+    const auto numSprites = std::min(importedState->sprites.size(), exportedState->sprites.size());
+    for (size_t spriteIdx = 0; spriteIdx < numSprites; ++spriteIdx)
     {
         if (importedState->sprites[spriteIdx].generic.sprite_identifier == SPRITE_IDENTIFIER_NULL
             && exportedState->sprites[spriteIdx].generic.sprite_identifier == SPRITE_IDENTIFIER_NULL)
@@ -569,6 +577,199 @@ TEST(S6ImportExportAdvanceTicks, all)
     SUCCEED();
 }
 
+static std::vector<uint16_t> CreateLitterPastS6Limit(uint16_t numPastLimit)
+{
+    std::vector<uint16_t> created;
+    uint16_t numCreatedPastLimit = 0;
+    while (numCreatedPastLimit < numPastLimit)
+    {
+        auto* litter = reinterpret_cast<Litter*>(create_sprite(SPRITE_IDENTIFIER_LITTER));
+        if (litter == nullptr)
+            break;
+
+        litter->sprite_identifier = SPRITE_IDENTIFIER_LITTER;
+        litter->MoveTo({ 32 * 10, 32 * 10, 0 });
+        created.push_back(litter->sprite_index);
+        if (litter->sprite_index >= RCT2_MAX_SPRITES)
+            numCreatedPastLimit++;
+    }
+    return created;
+}
+
+static void CheckImportedEntityIds()
+{
+    EXPECT_EQ(GetEntityPoolSize(), ENTITY_POOL_INITIAL_SIZE);
+    EXPECT_EQ(check_for_sprite_list_cycles(false), -1);
+    size_t numInLists = 0;
+    for (int32_t i = 0; i < static_cast<uint8_t>(EntityListId::Count); i++)
+    {
+        numInLists += GetEntityListCount(static_cast<EntityListId>(i));
+    }
+    EXPECT_EQ(numInLists, GetEntityPoolSize());
+    for (size_t i = 0; i < GetEntityPoolSize(); i++)
+    {
+        EXPECT_EQ(GetEntity(i)->sprite_index, i);
+    }
+}
+
+TEST(S6ImportExportGrownEntityPool, RenumbersEntitiesPastLimit)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    core_init();
+
+    MemoryStream importBuffer;
+    MemoryStream exportBuffer;
+
+    std::unique_ptr<IContext> context = CreateContext();
+    ASSERT_NE(context, nullptr);
+    ASSERT_TRUE(context->Initialise());
+
+    std::string testParkPath = TestData::GetParkPath("BigMapTest.sv6");
+    ASSERT_TRUE(LoadFileToBuffer(importBuffer, testParkPath));
+    ASSERT_TRUE(ImportSave(importBuffer, context, false));
+    const auto numPeeps = GetEntityListCount(EntityListId::Peep);
+    const auto numVehicles = GetEntityListCount(EntityListId::Vehicle);
+
+    auto created = CreateLitterPastS6Limit(50);
+    ASSERT_GT(GetEntityPoolSize(), RCT2_MAX_SPRITES);
+    // Make room below the limit so every entity can be kept.
+    for (size_t i = 0; i < 100; i++)
+    {
+        sprite_remove(GetEntity(created[i]));
+    }
+    const auto numLitter = GetEntityListCount(EntityListId::Litter);
+
+    ASSERT_TRUE(ExportSave(exportBuffer, context));
+    ASSERT_TRUE(ImportSave(exportBuffer, context, false));
+
+    CheckImportedEntityIds();
+    EXPECT_EQ(GetEntityListCount(EntityListId::Peep), numPeeps);
+    EXPECT_EQ(GetEntityListCount(EntityListId::Vehicle), numVehicles);
+    EXPECT_EQ(GetEntityListCount(EntityListId::Litter), numLitter);
+}
+
+TEST(S6ImportExportGrownEntityPool, LeavesOutOldestLitterPastLimit)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    core_init();
+
+    MemoryStream importBuffer;
+    MemoryStream exportBuffer;
+
+    std::unique_ptr<IContext> context = CreateContext();
+    ASSERT_NE(context, nullptr);
+    ASSERT_TRUE(context->Initialise());
+
+    std::string testParkPath = TestData::GetParkPath("BigMapTest.sv6");
+    ASSERT_TRUE(LoadFileToBuffer(importBuffer, testParkPath));
+    ASSERT_TRUE(ImportSave(importBuffer, context, false));
+    const auto numPeeps = GetEntityListCount(EntityListId::Peep);
+    const auto numVehicles = GetEntityListCount(EntityListId::Vehicle);
+
+    CreateLitterPastS6Limit(50);
+    ASSERT_GT(GetEntityPoolSize(), RCT2_MAX_SPRITES);
+    const auto numInUse = GetEntityPoolSize() - GetEntityListCount(EntityListId::Free);
+    ASSERT_GT(numInUse, RCT2_MAX_SPRITES);
+    const auto numLitter = GetEntityListCount(EntityListId::Litter);
+    const auto numMisc = GetEntityListCount(EntityListId::Misc);
+
+    ASSERT_TRUE(ExportSave(exportBuffer, context));
+    ASSERT_TRUE(ImportSave(exportBuffer, context, false));
+
+    CheckImportedEntityIds();
+    EXPECT_EQ(GetEntityListCount(EntityListId::Free), 0);
+    EXPECT_EQ(GetEntityListCount(EntityListId::Peep), numPeeps);
+    EXPECT_EQ(GetEntityListCount(EntityListId::Vehicle), numVehicles);
+    // Misc entities are left out before litter.
+    const auto numLeftOut = numInUse - RCT2_MAX_SPRITES;
+    const auto numMiscLeftOut = std::min<size_t>(numMisc, numLeftOut);
+    EXPECT_EQ(GetEntityListCount(EntityListId::Misc), numMisc - numMiscLeftOut);
+    EXPECT_EQ(GetEntityListCount(EntityListId::Litter), numLitter - (numLeftOut - numMiscLeftOut));
+}
+
+#ifndef DISABLE_NETWORK
+static std::unique_ptr<S6Exporter> ExportData(std::unique_ptr<IContext>& context)
+{
+    auto exporter = std::make_unique<S6Exporter>();
+    exporter->ExportObjectsList = context->GetObjectManager().GetPackableObjects();
+    exporter->Export();
+    return exporter;
+}
+
+static TileElement* FindFirstPathElement(CoordsXY& loc)
+{
+    for (int32_t y = 1; y < gMapSize - 1; y++)
+    {
+        for (int32_t x = 1; x < gMapSize - 1; x++)
+        {
+            loc = TileCoordsXY{ x, y }.ToCoordsXY();
+            auto* tileElement = map_get_first_element_at(loc);
+            do
+            {
+                if (tileElement == nullptr)
+                    break;
+                if (tileElement->GetType() == TILE_ELEMENT_TYPE_PATH)
+                    return tileElement;
+            } while (!(tileElement++)->IsLastForTile());
+        }
+    }
+    return nullptr;
+}
+
+TEST(S6ImportExportMapResync, DeltaTurnsOldMapIntoNew)
+{
+    gOpenRCT2Headless = true;
+    gOpenRCT2NoGraphics = true;
+
+    core_init();
+
+    MemoryStream importBuffer;
+
+    std::unique_ptr<IContext> context = CreateContext();
+    EXPECT_NE(context, nullptr);
+
+    bool initialised = context->Initialise();
+    ASSERT_TRUE(initialised);
+
+    std::string testParkPath = TestData::GetParkPath("BigMapTest.sv6");
+    ASSERT_TRUE(LoadFileToBuffer(importBuffer, testParkPath));
+    ASSERT_TRUE(ImportSave(importBuffer, context, false));
+
+    // The map the client holds
+    auto exporterA = ExportData(context);
+    auto request = NetworkMapResyncRequest::Create(exporterA->GetData(), gCurrentTicks);
+    ASSERT_FALSE(request.ChunkHashes.empty());
+
+    // The map on the server: the entities moved, a path was removed, which changes the number of elements of its
+    // chunk, and the grass of a surface far away grew, which changes its chunk without changing that number.
+    AdvanceGameTicks(100, context);
+
+    CoordsXY pathLoc;
+    auto* pathElement = FindFirstPathElement(pathLoc);
+    ASSERT_NE(pathElement, nullptr);
+    tile_element_remove(pathLoc, pathElement);
+
+    auto* surfaceElement = map_get_surface_element_at(TileCoordsXY{ gMapSize - 2, gMapSize - 2 }.ToCoordsXY());
+    ASSERT_NE(surfaceElement, nullptr);
+    surfaceElement->SetGrassLength(
+        surfaceElement->GetGrassLength() == GRASS_LENGTH_CLUMPS_2 ? GRASS_LENGTH_MOWED : GRASS_LENGTH_CLUMPS_2);
+
+    auto exporterB = ExportData(context);
+
+    MemoryStream delta;
+    NetworkMapResyncWriteDelta(delta, exporterB->GetData(), request);
+    EXPECT_LT(delta.GetLength(), sizeof(rct_s6_data));
+
+    delta.SetPosition(0);
+    ASSERT_TRUE(NetworkMapResyncApplyDelta(delta, exporterA->GetData()));
+    EXPECT_EQ(std::memcmp(&exporterA->GetData(), &exporterB->GetData(), sizeof(rct_s6_data)), 0);
+}
+#endif
+
 TEST(SeaDecrypt, DecryptSea)
 {
     auto path = TestData::GetParkPath("volcania.sea");
@@ -0,0 +1,73 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <openrct2/core/SpscQueue.h>
+#include <thread>
+
+// Enough values for the consumer to catch up with the producer many times.
+constexpr size_t TEST_VALUE_COUNT = 100000;
+
+TEST(SpscQueueTest, PopsInPushOrder)
+{
+    SpscQueue<int32_t> queue;
+    int32_t value = -1;
+    ASSERT_FALSE(queue.TryPop(value));
+
+    for (int32_t i = 0; i < 16; i++)
+    {
+        queue.Push(i);
+    }
+    for (int32_t i = 0; i < 16; i++)
+    {
+        ASSERT_TRUE(queue.TryPop(value));
+        ASSERT_EQ(value, i);
+    }
+    ASSERT_FALSE(queue.TryPop(value));
+}
+
+TEST(SpscQueueTest, ReleasesPoppedValues)
+{
+    auto shared = std::make_shared<int32_t>(0);
+    {
+        SpscQueue<std::shared_ptr<int32_t>> queue;
+        queue.Push(shared);
+        queue.Push(shared);
+
+        std::shared_ptr<int32_t> value;
+        ASSERT_TRUE(queue.TryPop(value));
+        value = nullptr;
+        ASSERT_EQ(shared.use_count(), 2);
+    }
+    ASSERT_EQ(shared.use_count(), 1);
+}
+
+TEST(SpscQueueTest, PassesValuesBetweenThreads)
+{
+    SpscQueue<size_t> queue;
+    std::thread producer([&queue]() {
+        for (size_t i = 0; i < TEST_VALUE_COUNT; i++)
+        {
+            queue.Push(i);
+        }
+    });
+
+    size_t expected = 0;
+    while (expected < TEST_VALUE_COUNT)
+    {
+        size_t value;
+        if (queue.TryPop(value))
+        {
+            ASSERT_EQ(value, expected);
+            expected++;
+        }
+    }
+    producer.join();
+}
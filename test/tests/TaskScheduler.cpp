@@ -0,0 +1,136 @@
+/*****************************************************************************
+ * Copyright (c) 2014-2020 OpenRCT2 developers
+ *
+ * For a complete list of all authors, please refer to contributors.md
+ * Interested in contributing? Visit https://github.com/OpenRCT2/OpenRCT2
+ *
+ * OpenRCT2 is licensed under the GNU General Public License version 3.
+ *****************************************************************************/
+
+#include <atomic>
+#include <gtest/gtest.h>
+#include <openrct2/core/TaskScheduler.h>
+#include <vector>
+
+// Enough rounds for the workers to go to sleep and wake up again in between.
+constexpr int32_t TEST_ROUND_COUNT = 200;
+constexpr int32_t TEST_TASK_COUNT = 64;
+
+class TaskSchedulerTest : public testing::TestWithParam<size_t>
+{
+};
+
+TEST_P(TaskSchedulerTest, RunsEveryTaskOnce)
+{
+    TaskScheduler scheduler(GetParam());
+    std::vector<std::atomic<int32_t>> runs(TEST_TASK_COUNT);
+    for (int32_t round = 0; round < TEST_ROUND_COUNT; round++)
+    {
+        TaskGroup group;
+        for (auto& run : runs)
+        {
+            scheduler.Run(group, [&run]() { run++; });
+        }
+        scheduler.Wait(group);
+        ASSERT_TRUE(group.IsDone());
+    }
+
+    for (const auto& run : runs)
+    {
+        EXPECT_EQ(run.load(), TEST_ROUND_COUNT);
+    }
+}
+
+TEST_P(TaskSchedulerTest, NestedGroups)
+{
+    TaskScheduler scheduler(GetParam());
+    std::atomic<int32_t> total{ 0 };
+    TaskGroup group;
+    for (int32_t i = 0; i < TEST_TASK_COUNT; i++)
+    {
+        // Tasks that wait for tasks of their own must not hold up the worker they run on
+        scheduler.Run(group, [&scheduler, &total]() {
+            TaskGroup innerGroup;
+            for (int32_t j = 0; j < 4; j++)
+            {
+                scheduler.Run(innerGroup, [&total]() { total++; });
+            }
+            scheduler.Wait(innerGroup);
+        });
+    }
+    scheduler.Wait(group);
+    EXPECT_EQ(total.load(), TEST_TASK_COUNT * 4);
+}
+
+TEST_P(TaskSchedulerTest, ParallelFor)
+{
+    TaskScheduler scheduler(GetParam());
+    std::vector<int32_t> values(1000);
+    scheduler.ParallelFor(0, values.size(), 7, [&values](size_t i) { values[i] = static_cast<int32_t>(i) * 2; });
+    for (size_t i = 0; i < values.size(); i++)
+    {
+        ASSERT_EQ(values[i], static_cast<int32_t>(i) * 2);
+    }
+}
+
+TEST_P(TaskSchedulerTest, ParallelReduceKeepsOrder)
+{
+    TaskScheduler scheduler(GetParam());
+    auto result = scheduler.ParallelReduce(
+        0, 100, 3, std::vector<size_t>(),
+        [](size_t begin, size_t end) {
+            std::vector<size_t> range;
+            for (size_t i = begin; i < end; i++)
+            {
+                range.push_back(i);
+            }
+            return range;
+        },
+        [](std::vector<size_t> a, std::vector<size_t> b) {
+            a.insert(a.end(), b.begin(), b.end());
+            return a;
+        });
+    ASSERT_EQ(result.size(), 100u);
+    for (size_t i = 0; i < result.size(); i++)
+    {
+        ASSERT_EQ(result[i], i);
+    }
+}
+
+TEST_P(TaskSchedulerTest, TaskGraphDependencies)
+{
+    TaskScheduler scheduler(GetParam());
+
+    // Every task checks that the tasks it depends on are done
+    std::vector<std::atomic<bool>> done(TEST_TASK_COUNT * 2);
+    std::atomic<int32_t> numFailed{ 0 };
+    TaskGraph graph;
+    auto first = graph.Add([&done]() { done[0] = true; });
+    for (int32_t i = 1; i < TEST_TASK_COUNT; i++)
+    {
+        auto generate = graph.Add([&done, i]() { done[i] = true; });
+        graph.Add(
+            [&done, &numFailed, i]() {
+                if (!done[0] || !done[i])
+                    numFailed++;
+                done[TEST_TASK_COUNT + i] = true;
+            },
+            { first, generate });
+    }
+
+    for (int32_t round = 0; round < 10; round++)
+    {
+        for (auto& value : done)
+        {
+            value = false;
+        }
+        graph.Run(scheduler);
+        for (int32_t i = 1; i < TEST_TASK_COUNT; i++)
+        {
+            ASSERT_TRUE(done[TEST_TASK_COUNT + i]);
+        }
+    }
+    EXPECT_EQ(numFailed.load(), 0);
+}
+
+INSTANTIATE_TEST_CASE_P(ThreadCounts, TaskSchedulerTest, testing::Values(0, 1, 4));
@@ -16,6 +16,7 @@
 #include <openrct2/ParkImporter.h>
 #include <openrct2/world/Footpath.h>
 #include <openrct2/world/Map.h>
+#include <openrct2/world/MapChangeJournal.h>
 
 using namespace OpenRCT2;
 
@@ -171,3 +172,269 @@ TEST_F(TileElementWantsFootpathConnection, MapEdge)
     // The tile in the -X direction is a normal tile and should not be marked as an edge
     EXPECT_FALSE(edges & (1 << 2));
 }
+
+class TileElementStorage : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+    }
+
+    static void TearDownTestCase()
+    {
+        if (_context)
+            _context.reset();
+    }
+
+    void SetUp() override
+    {
+        // These tests change the map, every test starts from the saved park
+        std::string parkPath = TestData::GetParkPath("tile-element-tests.sv6");
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+
+        // Changed in some tests. Store to restore its value
+        _tileElementLimit = MapGetTileElementLimit();
+    }
+
+    void TearDown() override
+    {
+        MapSetTileElementLimit(_tileElementLimit);
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+    size_t _tileElementLimit = 0;
+};
+
+std::shared_ptr<IContext> TileElementStorage::_context;
+
+TEST_F(TileElementStorage, TileElementSummary)
+{
+    // The summary matches what walking the tile finds
+    const auto loc = TileCoordsXY{ 19, 18 }.ToCoordsXY();
+    auto summary = MapGetTileElementSummary(loc);
+    ASSERT_TRUE(summary.has_value());
+    EXPECT_TRUE(summary->HasType(TILE_ELEMENT_TYPE_SURFACE));
+    EXPECT_TRUE(summary->HasType(TILE_ELEMENT_TYPE_PATH));
+    EXPECT_FALSE(summary->HasType(TILE_ELEMENT_TYPE_BANNER));
+    EXPECT_TRUE(summary->HasBaseHeight(14));
+    EXPECT_FALSE(summary->HasBaseHeight(200));
+
+    const TileElement* tileElement = map_get_first_element_at(loc);
+    while (tileElement->GetType() != TILE_ELEMENT_TYPE_SURFACE)
+        tileElement++;
+    EXPECT_EQ(map_get_surface_element_at(loc), tileElement->AsSurface());
+    EXPECT_NE(map_get_path_element_at(TileCoordsXYZ{ 19, 18, 14 }), nullptr);
+    EXPECT_EQ(map_get_path_element_at(TileCoordsXYZ{ 19, 18, 200 }), nullptr);
+
+    // Adding and removing an element only makes the summary of its own tile again
+    const auto otherLoc = TileCoordsXY{ 20, 18 }.ToCoordsXY();
+    const auto otherSummary = MapGetTileElementSummary(otherLoc);
+    ASSERT_TRUE(otherSummary.has_value());
+    TileElement* bannerElement = tile_element_insert({ loc, 200 * COORDS_Z_STEP }, 0b1111);
+    ASSERT_NE(bannerElement, nullptr);
+    bannerElement->SetType(TILE_ELEMENT_TYPE_BANNER);
+    summary = MapGetTileElementSummary(loc);
+    ASSERT_TRUE(summary.has_value());
+    EXPECT_TRUE(summary->HasType(TILE_ELEMENT_TYPE_BANNER));
+    EXPECT_TRUE(summary->HasBaseHeight(200));
+
+    tile_element_remove(loc, bannerElement);
+    summary = MapGetTileElementSummary(loc);
+    ASSERT_TRUE(summary.has_value());
+    EXPECT_FALSE(summary->HasType(TILE_ELEMENT_TYPE_BANNER));
+    EXPECT_FALSE(summary->HasBaseHeight(200));
+    EXPECT_EQ(MapGetTileElementSummary(otherLoc)->TypeMask, otherSummary->TypeMask);
+}
+
+TEST_F(TileElementStorage, InsertReusesFreedElements)
+{
+    // Building and removing on tiles that keep swapping places should not use up the element array
+    map_reorganise_elements();
+    const TileElement* nextFreeTileElement = gNextFreeTileElement;
+    const CoordsXY tiles[] = { TileCoordsXY{ 2, 2 }.ToCoordsXY(), TileCoordsXY{ 3, 2 }.ToCoordsXY() };
+    for (int32_t i = 0; i < 256; i++)
+    {
+        for (const auto& tile : tiles)
+        {
+            TileElement* tileElement = tile_element_insert({ tile, (200 + i % 8) * COORDS_Z_STEP }, 0b1111);
+            ASSERT_NE(tileElement, nullptr);
+            tileElement->SetType(TILE_ELEMENT_TYPE_SMALL_SCENERY);
+        }
+        for (const auto& tile : tiles)
+        {
+            // Elements stay ordered by height, with the new one last on its tile
+            TileElement* tileElement = map_get_first_element_at(tile);
+            ASSERT_NE(tileElement, nullptr);
+            while (!tileElement->IsLastForTile())
+            {
+                EXPECT_LE(tileElement->GetBaseZ(), (tileElement + 1)->GetBaseZ());
+                tileElement++;
+            }
+            EXPECT_EQ(tileElement->GetBaseZ(), (200 + i % 8) * COORDS_Z_STEP);
+            tile_element_remove(tile, tileElement);
+        }
+    }
+    EXPECT_LE(gNextFreeTileElement - nextFreeTileElement, 16);
+}
+
+TEST_F(TileElementStorage, HeapGrowsPastInitialSize)
+{
+    // Fill every tile with more elements than fit in the RCT2 element array
+    MapSetTileElementLimit(TILE_ELEMENT_HEAP_INITIAL_SIZE * 4);
+    const TileElement* heapStart = gTileElements.data();
+    for (int32_t i = 0; i < 4; i++)
+    {
+        for (int32_t y = 0; y < MAXIMUM_MAP_SIZE_TECHNICAL; y++)
+        {
+            for (int32_t x = 0; x < MAXIMUM_MAP_SIZE_TECHNICAL; x++)
+            {
+                ASSERT_TRUE(map_check_free_elements_and_reorganise(1));
+                const auto loc = CoordsXYZ{ TileCoordsXY{ x, y }.ToCoordsXY(), (240 + i) * COORDS_Z_STEP };
+                TileElement* tileElement = tile_element_insert(loc, 0b1111);
+                ASSERT_NE(tileElement, nullptr);
+                tileElement->SetType(TILE_ELEMENT_TYPE_SMALL_SCENERY);
+            }
+        }
+    }
+    EXPECT_GT(gTileElements.size(), TILE_ELEMENT_HEAP_INITIAL_SIZE);
+
+    // The tile pointers have to follow the elements to the larger heap
+    map_reorganise_elements();
+    // Growing and reorganising do not move the heap, elements can be held on to
+    EXPECT_EQ(gTileElements.data(), heapStart);
+    const TileElement* tileElement = map_get_first_element_at(TileCoordsXY{ 100, 100 }.ToCoordsXY());
+    ASSERT_NE(tileElement, nullptr);
+    int32_t numInserted = 0;
+    do
+    {
+        if (tileElement->GetBaseZ() >= 240 * COORDS_Z_STEP)
+            numInserted++;
+    } while (!(tileElement++)->IsLastForTile());
+    EXPECT_EQ(numInserted, 4);
+}
+
+class MapChangeJournalTest : public testing::Test
+{
+protected:
+    static void SetUpTestCase()
+    {
+        gOpenRCT2Headless = true;
+        gOpenRCT2NoGraphics = true;
+        _context = CreateContext();
+        bool initialised = _context->Initialise();
+        ASSERT_TRUE(initialised);
+    }
+
+    static void TearDownTestCase()
+    {
+        if (_context)
+            _context.reset();
+    }
+
+    void SetUp() override
+    {
+        // These tests change the map, every test starts from the saved park
+        std::string parkPath = TestData::GetParkPath("tile-element-tests.sv6");
+        load_from_sv6(parkPath.c_str());
+        game_load_init();
+    }
+
+private:
+    static std::shared_ptr<IContext> _context;
+};
+
+std::shared_ptr<IContext> MapChangeJournalTest::_context;
+
+TEST_F(MapChangeJournalTest, InsertChangesOneChunk)
+{
+    // Make room first, reorganising the elements changes every chunk
+    ASSERT_TRUE(map_check_free_elements_and_reorganise(1));
+
+    // A new subscription reports every chunk once
+    MapChangeSubscription subscription;
+    int32_t numChunks = 0;
+    subscription.ForEachChangedChunk([&numChunks](const TileCoordsXY&) { numChunks++; });
+    EXPECT_EQ(numChunks, MAP_CHUNKS_PER_SIDE * MAP_CHUNKS_PER_SIDE);
+    EXPECT_FALSE(subscription.HasChanges());
+
+    // Inserting an element only changes the chunk of its tile
+    const auto loc = CoordsXYZ{ TileCoordsXY{ 19, 42 }.ToCoordsXY(), 240 * COORDS_Z_STEP };
+    TileElement* tileElement = tile_element_insert(loc, 0b1111);
+    ASSERT_NE(tileElement, nullptr);
+    tileElement->SetType(TILE_ELEMENT_TYPE_SMALL_SCENERY);
+    EXPECT_TRUE(subscription.HasChanges());
+
+    std::vector<TileCoordsXY> changedChunks;
+    subscription.ForEachChangedChunk([&changedChunks](const TileCoordsXY& chunk) { changedChunks.push_back(chunk); });
+    ASSERT_EQ(changedChunks.size(), 1u);
+    EXPECT_EQ(changedChunks[0], (TileCoordsXY{ 16, 40 }));
+    EXPECT_FALSE(subscription.HasChanges());
+
+    // Only the tile itself has the new version
+    const auto tilePos = TileCoordsXY{ loc };
+    EXPECT_EQ(MapChangeJournalGetTileVersion(tilePos), MapChangeJournalGetVersion());
+    EXPECT_LT(MapChangeJournalGetTileVersion({ 20, 42 }), MapChangeJournalGetVersion());
+}
+
+TEST_F(MapChangeJournalTest, RemoveChangesOneChunk)
+{
+    // Removing an element only changes the chunk of its tile
+    const auto loc = TileCoordsXY{ 19, 42 }.ToCoordsXY();
+    TileElement* tileElement = tile_element_insert({ loc, 240 * COORDS_Z_STEP }, 0b1111);
+    ASSERT_NE(tileElement, nullptr);
+    tileElement->SetType(TILE_ELEMENT_TYPE_SMALL_SCENERY);
+
+    MapChangeSubscription subscription;
+    subscription.ForEachChangedChunk([](const TileCoordsXY&) {});
+    tile_element_remove(loc, tileElement);
+
+    std::vector<TileCoordsXY> changedChunks;
+    subscription.ForEachChangedChunk([&changedChunks](const TileCoordsXY& chunk) { changedChunks.push_back(chunk); });
+    ASSERT_EQ(changedChunks.size(), 1u);
+    EXPECT_EQ(changedChunks[0], (TileCoordsXY{ 16, 40 }));
+}
+
+TEST_F(MapChangeJournalTest, RepeatedChange)
+{
+    // Every change to a chunk has to be reported, also when the chunk was changed just before
+    const auto loc = CoordsXY{ TileCoordsXY{ 19, 42 }.ToCoordsXY() };
+    MapChangeSubscription subscription;
+    map_invalidate_tile_full(loc);
+    subscription.ForEachChangedChunk([](const TileCoordsXY&) {});
+    EXPECT_FALSE(subscription.HasChanges());
+
+    for (int32_t i = 0; i < 3; i++)
+    {
+        map_invalidate_tile_full(loc);
+        EXPECT_TRUE(subscription.HasChanges());
+
+        std::vector<TileCoordsXY> changedChunks;
+        subscription.ForEachChangedChunk([&changedChunks](const TileCoordsXY& chunk) { changedChunks.push_back(chunk); });
+        ASSERT_EQ(changedChunks.size(), 1u);
+        EXPECT_EQ(changedChunks[0], (TileCoordsXY{ 16, 40 }));
+    }
+}
+
+TEST_F(MapChangeJournalTest, TileRedraw)
+{
+    // Redrawing a tile changes its version, but not the version of its chunk
+    const auto loc = CoordsXYZ{ TileCoordsXY{ 19, 42 }.ToCoordsXY(), 240 * COORDS_Z_STEP };
+    const auto tilePos = TileCoordsXY{ loc };
+    MapChangeSubscription subscription;
+    subscription.ForEachChangedChunk([](const TileCoordsXY&) {});
+
+    const auto tileVersion = MapChangeJournalGetTileVersion(tilePos);
+    map_invalidate_tile_zoom0({ loc, loc.z + 4 * COORDS_Z_STEP });
+    EXPECT_GT(MapChangeJournalGetTileVersion(tilePos), tileVersion);
+
+    int32_t numChunks = 0;
+    subscription.ForEachChangedChunk([&numChunks](const TileCoordsXY&) { numChunks++; });
+    EXPECT_EQ(numChunks, 0);
+}